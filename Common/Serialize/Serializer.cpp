@@ -15,8 +15,11 @@
 // Official SVN repository and contact information can be found at
 // http://code.google.com/p/dolphin-emu/
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #include <snappy-c.h>
 #include <zstd.h>
 
@@ -24,6 +27,7 @@
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Common/File/FileUtil.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ParallelLoop.h"
 
 enum class SerializeCompressType {
 	NONE = 0,
@@ -33,6 +37,127 @@ enum class SerializeCompressType {
 
 static constexpr SerializeCompressType SAVE_TYPE = SerializeCompressType::ZSTD;
 
+// ZSTD saves are split into independent frames so they can be compressed and decompressed on all cores.
+// The frame sizes are stored first in a skippable frame, which ZSTD_decompress ignores, so the result
+// is still a regular zstd stream for older versions (and other tools.)
+static constexpr u32 ZSTD_CHUNK_INDEX_MAGIC = 0x58444943;  // "CIDX"
+static constexpr size_t ZSTD_CHUNK_SIZE = 1024 * 1024;
+
+struct ZstdChunkIndexHeader {
+	u32 skippableMagic;
+	u32 skippableSize;
+	u32 magic;
+	u32 chunkSize;
+	u32 numChunks;
+	// Followed by numChunks compressed frame sizes.
+};
+
+static size_t ZstdChunkedBound(size_t sz) {
+	size_t numChunks = (sz + ZSTD_CHUNK_SIZE - 1) / ZSTD_CHUNK_SIZE;
+	return sizeof(ZstdChunkIndexHeader) + numChunks * (sizeof(u32) + ZSTD_compressBound(ZSTD_CHUNK_SIZE));
+}
+
+static bool ZstdCompressChunked(const u8 *buffer, size_t sz, u8 *compressed, size_t &write_len) {
+	const int numChunks = (int)((sz + ZSTD_CHUNK_SIZE - 1) / ZSTD_CHUNK_SIZE);
+	const size_t bound = ZSTD_compressBound(ZSTD_CHUNK_SIZE);
+	const size_t indexSize = sizeof(ZstdChunkIndexHeader) + numChunks * sizeof(u32);
+	u8 *frames = compressed + indexSize;
+
+	std::vector<size_t> sizes(numChunks);
+	std::atomic<bool> failed(false);
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		ZSTD_CCtx *ctx = ZSTD_createCCtx();
+		if (!ctx) {
+			failed = true;
+			return;
+		}
+		// TODO: If free disk space is low, we could max this out to 22?
+		ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
+		ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, 1);
+		for (int i = l; i < h; i++) {
+			size_t offset = i * ZSTD_CHUNK_SIZE;
+			size_t len = std::min(ZSTD_CHUNK_SIZE, sz - offset);
+			sizes[i] = ZSTD_compress2(ctx, frames + i * bound, bound, buffer + offset, len);
+			if (ZSTD_isError(sizes[i]))
+				failed = true;
+		}
+		ZSTD_freeCCtx(ctx);
+	}, 0, numChunks, 1);
+
+	if (failed)
+		return false;
+
+	// Pack the frames together, they were compressed into worst case sized slots.
+	ZstdChunkIndexHeader header;
+	header.skippableMagic = ZSTD_MAGIC_SKIPPABLE_START;
+	header.skippableSize = (u32)(indexSize - 8);
+	header.magic = ZSTD_CHUNK_INDEX_MAGIC;
+	header.chunkSize = (u32)ZSTD_CHUNK_SIZE;
+	header.numChunks = (u32)numChunks;
+	memcpy(compressed, &header, sizeof(header));
+
+	u8 *dst = frames;
+	for (int i = 0; i < numChunks; i++) {
+		u32 frameSize = (u32)sizes[i];
+		memcpy(compressed + sizeof(header) + i * sizeof(u32), &frameSize, sizeof(u32));
+		memmove(dst, frames + i * bound, frameSize);
+		dst += frameSize;
+	}
+	write_len = dst - compressed;
+	return true;
+}
+
+// Returns the index header, or nullptr if this isn't a chunked stream (i.e. a plain zstd save.)
+static const ZstdChunkIndexHeader *ZstdFindChunkIndex(const u8 *buffer, size_t sz) {
+	if (sz < sizeof(ZstdChunkIndexHeader))
+		return nullptr;
+	const ZstdChunkIndexHeader *header = (const ZstdChunkIndexHeader *)buffer;
+	if (header->skippableMagic != ZSTD_MAGIC_SKIPPABLE_START || header->magic != ZSTD_CHUNK_INDEX_MAGIC)
+		return nullptr;
+	if (header->chunkSize == 0 || header->skippableSize != 12 + (u64)header->numChunks * sizeof(u32))
+		return nullptr;
+	if (sizeof(ZstdChunkIndexHeader) + (u64)header->numChunks * sizeof(u32) > sz)
+		return nullptr;
+	return header;
+}
+
+static bool ZstdDecompressChunked(const ZstdChunkIndexHeader *header, const u8 *buffer, size_t sz, u8 *uncomp_buffer, size_t uncomp_size) {
+	const int numChunks = (int)header->numChunks;
+	const size_t chunkSize = header->chunkSize;
+	if ((u64)numChunks * chunkSize < uncomp_size || (numChunks != 0 && (u64)(numChunks - 1) * chunkSize >= uncomp_size))
+		return false;
+
+	const u8 *frameSizes = buffer + sizeof(ZstdChunkIndexHeader);
+	std::vector<size_t> offsets(numChunks + 1);
+	offsets[0] = sizeof(ZstdChunkIndexHeader) + numChunks * sizeof(u32);
+	for (int i = 0; i < numChunks; i++) {
+		u32 frameSize;
+		memcpy(&frameSize, frameSizes + i * sizeof(u32), sizeof(u32));
+		offsets[i + 1] = offsets[i] + frameSize;
+	}
+	if (offsets[numChunks] != sz)
+		return false;
+
+	std::atomic<bool> failed(false);
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		ZSTD_DCtx *ctx = ZSTD_createDCtx();
+		if (!ctx) {
+			failed = true;
+			return;
+		}
+		for (int i = l; i < h; i++) {
+			size_t offset = i * chunkSize;
+			size_t len = std::min(chunkSize, uncomp_size - offset);
+			size_t status = ZSTD_decompressDCtx(ctx, uncomp_buffer + offset, len, buffer + offsets[i], offsets[i + 1] - offsets[i]);
+			if (ZSTD_isError(status) || status != len)
+				failed = true;
+		}
+		ZSTD_freeDCtx(ctx);
+	}, 0, numChunks, 1);
+
+	return !failed;
+}
+
 void PointerWrap::RewindForWrite(u8 *writePtr) {
 	_assert_(mode == MODE_MEASURE);
 	// Switch to writing mode, save the size for later checking and start again.
@@ -377,10 +502,15 @@ CChunkFileReader::Error CChunkFileReader::LoadFile(const Path &filename, std::st
 			auto status = snappy_uncompress((const char *)buffer, sz, (char *)uncomp_buffer, &uncomp_size);
 			success = status == SNAPPY_OK;
 		} else if (SerializeCompressType(header.Compress) == SerializeCompressType::ZSTD) {
-			size_t status = ZSTD_decompress((char *)uncomp_buffer, uncomp_size, (const char *)buffer, sz);
-			success = !ZSTD_isError(status);
-			if (success) {
-				uncomp_size = status;
+			const ZstdChunkIndexHeader *index = ZstdFindChunkIndex(buffer, sz);
+			if (index) {
+				success = ZstdDecompressChunked(index, buffer, sz, uncomp_buffer, uncomp_size);
+			} else {
+				size_t status = ZSTD_decompress((char *)uncomp_buffer, uncomp_size, (const char *)buffer, sz);
+				success = !ZSTD_isError(status);
+				if (success) {
+					uncomp_size = status;
+				}
 			}
 		} else {
 			ERROR_LOG(Log::SaveState, "ChunkReader: Unexpected compression type %d", header.Compress);
@@ -435,7 +565,7 @@ CChunkFileReader::Error CChunkFileReader::SaveFile(const Path &filename, const s
 		write_len = snappy_max_compressed_length(sz);
 		break;
 	case SerializeCompressType::ZSTD:
-		write_len = ZSTD_compressBound(sz);
+		write_len = ZstdChunkedBound(sz);
 		break;
 	}
 	u8 *compressed_buffer = write_len == 0 ? nullptr : (u8 *)malloc(write_len);
@@ -456,20 +586,7 @@ CChunkFileReader::Error CChunkFileReader::SaveFile(const Path &filename, const s
 			success = snappy_compress((const char *)buffer, sz, (char *)compressed_buffer, &write_len) == SNAPPY_OK;
 			break;
 		case SerializeCompressType::ZSTD:
-			{
-				auto ctx = ZSTD_createCCtx();
-				if (!ctx) {
-					success = false;
-				} else {
-					// TODO: If free disk space is low, we could max this out to 22?
-					ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT);
-					ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, 1);
-					ZSTD_CCtx_setPledgedSrcSize(ctx, sz);
-					write_len = ZSTD_compress2(ctx, compressed_buffer, write_len, buffer, sz);
-					success = !ZSTD_isError(write_len);
-				}
-				ZSTD_freeCCtx(ctx);
-			}
+			success = ZstdCompressChunked(buffer, sz, compressed_buffer, write_len);
 			break;
 		}
 
@@ -5,10 +5,57 @@
 #include "Common/Log.h"
 #include "Common/CPUDetect.h"
 
+class LoopRangeTask;
+
+// Parallel loops queue lots of small tasks, so reuse them rather than allocating each time.
+// Intentionally never freed, since tasks may still be released during shutdown.
+class LoopRangeTaskPool {
+public:
+	LoopRangeTask *Get() {
+		for (auto &slot : free_) {
+			if (slot.load(std::memory_order_relaxed)) {
+				LoopRangeTask *task = slot.exchange(nullptr);
+				if (task)
+					return task;
+			}
+		}
+		return nullptr;
+	}
+
+	bool Put(LoopRangeTask *task) {
+		for (auto &slot : free_) {
+			LoopRangeTask *expected = nullptr;
+			if (!slot.load(std::memory_order_relaxed) && slot.compare_exchange_strong(expected, task))
+				return true;
+		}
+		return false;
+	}
+
+private:
+	std::atomic<LoopRangeTask *> free_[64]{};
+};
+
+static LoopRangeTaskPool loopTaskPool;
+
 class LoopRangeTask : public Task {
 public:
-	LoopRangeTask(WaitableCounter *counter, const std::function<void(int, int)> &loop, int lower, int upper, TaskPriority p)
-		: counter_(counter), loop_(loop), lower_(lower), upper_(upper), priority_(p) {}
+	// If copyLoop is false, loop must stay alive until the counter is done.
+	static LoopRangeTask *Get(WaitableCounter *counter, const std::function<void(int, int)> &loop, bool copyLoop, int lower, int upper, TaskPriority p) {
+		LoopRangeTask *task = loopTaskPool.Get();
+		if (!task)
+			task = new LoopRangeTask();
+		task->counter_ = counter;
+		if (copyLoop) {
+			task->ownedLoop_ = loop;
+			task->loop_ = &task->ownedLoop_;
+		} else {
+			task->loop_ = &loop;
+		}
+		task->lower_ = lower;
+		task->upper_ = upper;
+		task->priority_ = p;
+		return task;
+	}
 
 	TaskType Type() const override {
 		return TaskType::CPU_COMPUTE;
@@ -19,19 +66,29 @@ class LoopRangeTask : public Task {
 	}
 
 	void Run() override {
-		loop_(lower_, upper_);
+		(*loop_)(lower_, upper_);
 		counter_->Count();
 	}
 
-	std::function<void(int, int)> loop_;
-	WaitableCounter *counter_;
+	void Release() override {
+		ownedLoop_ = nullptr;
+		if (!loopTaskPool.Put(this))
+			delete this;
+	}
+
+private:
+	LoopRangeTask() {}
 
-	int lower_;
-	int upper_;
-	const TaskPriority priority_;
+	std::function<void(int, int)> ownedLoop_;
+	const std::function<void(int, int)> *loop_ = nullptr;
+	WaitableCounter *counter_ = nullptr;
+
+	int lower_ = 0;
+	int upper_ = 0;
+	TaskPriority priority_ = TaskPriority::NORMAL;
 };
 
-WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority) {
+static WaitableCounter *ParallelRangeLoopTasks(ThreadManager *threadMan, const std::function<void(int, int)> &loop, bool copyLoop, int lower, int upper, int minSize, TaskPriority priority) {
 	if (minSize == -1) {
 		minSize = 1;
 	}
@@ -44,7 +101,7 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 	} else if (range <= minSize) {
 		// Single background task.
 		WaitableCounter *waitableCounter = new WaitableCounter(1);
-		threadMan->EnqueueTaskOnThread(0, new LoopRangeTask(waitableCounter, loop, lower, upper, priority));
+		threadMan->EnqueueTaskOnThread(0, LoopRangeTask::Get(waitableCounter, loop, copyLoop, lower, upper, priority));
 		return waitableCounter;
 	} else {
 		// Split the range between threads. Allow for some fractional bits.
@@ -78,7 +135,7 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 				// Let's do the stragglers on the current thread.
 				break;
 			}
-			threadMan->EnqueueTaskOnThread(i, new LoopRangeTask(waitableCounter, loop, start, end, priority));
+			threadMan->EnqueueTaskOnThread(i, LoopRangeTask::Get(waitableCounter, loop, copyLoop, start, end, priority));
 			counter += delta;
 			if ((counter >> fractionalBits) >= upper) {
 				break;
@@ -96,6 +153,11 @@ WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::
 	}
 }
 
+WaitableCounter *ParallelRangeLoopWaitable(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority) {
+	// The caller's loop may be gone before the tasks run, so they need a copy.
+	return ParallelRangeLoopTasks(threadMan, loop, true, lower, upper, minSize, priority);
+}
+
 void ParallelRangeLoop(ThreadManager *threadMan, const std::function<void(int, int)> &loop, int lower, int upper, int minSize, TaskPriority priority) {
 	if (cpu_info.num_cores == 1 || (minSize >= (upper - lower) && upper > lower)) {
 		// "Optimization" for single-core devices, or minSize larger than the range.
@@ -109,7 +171,8 @@ void ParallelRangeLoop(ThreadManager *threadMan, const std::function<void(int, i
 		minSize = 1;
 	}
 
-	WaitableCounter *counter = ParallelRangeLoopWaitable(threadMan, loop, lower, upper, minSize, priority);
+	// We wait below, so the tasks can just point at loop.
+	WaitableCounter *counter = ParallelRangeLoopTasks(threadMan, loop, false, lower, upper, minSize, priority);
 	// TODO: Optimize using minSize. We'll just compute whether there's a remainer, remove it from the call to ParallelRangeLoopWaitable,
 	// and process the remainder right here. If there's no remainer, we'll steal a whole chunk.
 	if (counter) {
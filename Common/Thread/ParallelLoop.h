@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
@@ -12,6 +13,13 @@ struct WaitableCounter : public Waitable {
 	WaitableCounter(int count) : count_(count) {}
 
 	void Count() {
+		// Only the last count takes the lock, so a waiter can't wake up (and free us) before we're done.
+		int count = count_.load();
+		while (count > 1) {
+			if (count_.compare_exchange_weak(count, count - 1))
+				return;
+		}
+
 		std::unique_lock<std::mutex> lock(mutex_);
 		if (count_ == 0) {
 			return;
@@ -30,7 +38,7 @@ struct WaitableCounter : public Waitable {
 		}
 	}
 
-	int count_;
+	std::atomic<int> count_;
 	std::mutex mutex_;
 	std::condition_variable cond_;
 };
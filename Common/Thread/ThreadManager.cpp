@@ -8,6 +8,7 @@
 #include <atomic>
 
 #include "Common/Log.h"
+#include "Common/TimeUtil.h"
 #include "Common/Thread/ThreadUtil.h"
 #include "Common/Thread/ThreadManager.h"
 
@@ -23,9 +24,81 @@
 const int MAX_CORES_TO_USE = 16;
 const int MIN_IO_BLOCKING_THREADS = 4;
 static constexpr size_t TASK_PRIORITY_COUNT = (size_t)TaskPriority::COUNT;
+// How long (in pause instructions) an idle compute thread keeps looking for work before sleeping.
+// Parallel loops tend to queue the next batch right away, and waking a sleeping thread is slow.
+static constexpr int IDLE_SPIN_COUNT = 1024;
 
 ThreadManager g_threadManager;
 
+// Bounded lock-free queue that any thread can push to and pop from (Dmitry Vyukov's MPMC ring.)
+// Workers own one per priority, and idle workers steal from the others'.
+class TaskRing {
+public:
+	static constexpr size_t SIZE = 256;
+
+	TaskRing() {
+		for (size_t i = 0; i < SIZE; ++i)
+			cells_[i].sequence.store(i, std::memory_order_relaxed);
+		pushPos_.store(0, std::memory_order_relaxed);
+		popPos_.store(0, std::memory_order_relaxed);
+	}
+
+	bool Push(Task *task) {
+		Cell *cell;
+		size_t pos = pushPos_.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &cells_[pos & (SIZE - 1)];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0) {
+				if (pushPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				// Full.
+				return false;
+			} else {
+				pos = pushPos_.load(std::memory_order_relaxed);
+			}
+		}
+		cell->task = task;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	Task *Pop() {
+		Cell *cell;
+		size_t pos = popPos_.load(std::memory_order_relaxed);
+		while (true) {
+			cell = &cells_[pos & (SIZE - 1)];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+			if (diff == 0) {
+				if (popPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			} else if (diff < 0) {
+				// Empty.
+				return nullptr;
+			} else {
+				pos = popPos_.load(std::memory_order_relaxed);
+			}
+		}
+		Task *task = cell->task;
+		cell->sequence.store(pos + SIZE, std::memory_order_release);
+		return task;
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		Task *task;
+	};
+
+	Cell cells_[SIZE];
+	// Keep the producer and consumer positions on separate cache lines.
+	alignas(64) std::atomic<size_t> pushPos_;
+	alignas(64) std::atomic<size_t> popPos_;
+};
+
 struct GlobalThreadContext {
 	std::mutex mutex;
 	std::deque<Task *> compute_queue[TASK_PRIORITY_COUNT];
@@ -38,11 +111,19 @@ struct GlobalThreadContext {
 };
 
 struct TaskThreadContext {
+	// Tasks queued on this thread plus the one running, if any.
 	std::atomic<int> queue_size;
+	TaskRing ring[TASK_PRIORITY_COUNT];
+	// Only used when the ring is full.  Protected by mutex.
 	std::deque<Task *> private_queue[TASK_PRIORITY_COUNT];
+	std::atomic<int> private_queue_size;
 	std::thread thread; // the worker thread
 	std::condition_variable cond; // used to signal new work
-	std::mutex mutex; // protects the local queue.
+	std::mutex mutex; // protects the overflow queue and parking.
+	// Set while sleeping on cond, so enqueuers know to notify.
+	std::atomic<bool> parked;
+	// How long to look for more work before parking.  Zero if spinning would just steal time from other threads.
+	int spinCount;
 	int index;
 	TaskType type;
 	std::atomic<bool> cancelled;
@@ -90,8 +171,13 @@ void ThreadManager::Teardown() {
 
 	for (TaskThreadContext *&threadCtx : global_->threads_) {
 		threadCtx->thread.join();
+	}
+	// Only once all have stopped, since they might've been stealing from each other.
+	for (TaskThreadContext *&threadCtx : global_->threads_) {
 		// TODO: Is it better to just delete these?
 		for (size_t i = 0; i < TASK_PRIORITY_COUNT; ++i) {
+			while (Task *task = threadCtx->ring[i].Pop())
+				TeardownTask(task, true);
 			for (Task *task : threadCtx->private_queue[i]) {
 				TeardownTask(task, true);
 			}
@@ -130,6 +216,91 @@ bool ThreadManager::TeardownTask(Task *task, bool enqueue) {
 	return false;
 }
 
+static void PushPrivateTask(TaskThreadContext *thread, Task *task) {
+	size_t queueIndex = (size_t)task->Priority();
+	// This must happen before the push, a parking thread checks it after setting parked.
+	thread->queue_size++;
+
+	// Stick to the locked queue until it empties, so tasks mostly stay in order.
+	if (thread->private_queue_size.load() != 0 || !thread->ring[queueIndex].Push(task)) {
+		std::unique_lock<std::mutex> lock(thread->mutex);
+		thread->private_queue[queueIndex].push_back(task);
+		thread->private_queue_size++;
+		thread->cond.notify_one();
+		return;
+	}
+
+	if (thread->parked.load()) {
+		// Lock the thread to ensure it gets the message.
+		std::unique_lock<std::mutex> lock(thread->mutex);
+		thread->cond.notify_one();
+	}
+}
+
+static Task *PopPrivateTask(TaskThreadContext *thread, size_t p) {
+	Task *task = thread->ring[p].Pop();
+	if (!task && thread->private_queue_size.load() != 0) {
+		std::unique_lock<std::mutex> lock(thread->mutex);
+		if (!thread->private_queue[p].empty()) {
+			task = thread->private_queue[p].front();
+			thread->private_queue[p].pop_front();
+			thread->private_queue_size--;
+		}
+	}
+	return task;
+}
+
+static Task *PopGlobalTask(GlobalThreadContext *global, TaskThreadContext *thread, size_t p) {
+	const bool isCompute = thread->type == TaskType::CPU_COMPUTE;
+	auto &queue_size = isCompute ? global->compute_queue_size : global->io_queue_size;
+	if (queue_size.load() == 0)
+		return nullptr;
+
+	std::unique_lock<std::mutex> lock(global->mutex);
+	auto &queue = isCompute ? global->compute_queue[p] : global->io_queue[p];
+	if (queue.empty())
+		return nullptr;
+
+	Task *task = queue.front();
+	queue.pop_front();
+	queue_size--;
+	// We are processing one now, so mark that.
+	thread->queue_size++;
+	return task;
+}
+
+static Task *StealTask(GlobalThreadContext *global, TaskThreadContext *thread, size_t p) {
+	// Only from threads of the same type: IO tasks may need JNI, and compute tasks shouldn't tie up IO threads.
+	const int count = (int)global->threads_.size();
+	for (int i = 1; i < count; ++i) {
+		TaskThreadContext *victim = global->threads_[(thread->index + i) % count];
+		if (victim->type != thread->type || victim->queue_size.load(std::memory_order_relaxed) == 0)
+			continue;
+
+		Task *task = victim->ring[p].Pop();
+		if (task) {
+			thread->queue_size++;
+			victim->queue_size--;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+static Task *FindTask(GlobalThreadContext *global, TaskThreadContext *thread) {
+	// Priority comes first, so we'd rather steal a HIGH task than run one of our own NORMAL tasks.
+	for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+		Task *task = PopPrivateTask(thread, p);
+		if (!task)
+			task = PopGlobalTask(global, thread, p);
+		if (!task)
+			task = StealTask(global, thread, p);
+		if (task)
+			return task;
+	}
+	return nullptr;
+}
+
 static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thread) {
 	if (thread->type == TaskType::CPU_COMPUTE) {
 		snprintf(thread->name, sizeof(thread->name), "PoolW %d", thread->index);
@@ -148,65 +319,33 @@ static void WorkerThreadFunc(GlobalThreadContext *global, TaskThreadContext *thr
 	const auto global_queue_size = [isCompute, &global]() -> int {
 		return isCompute ? global->compute_queue_size.load() : global->io_queue_size.load();
 	};
-
 	while (!thread->cancelled) {
-		Task *task = nullptr;
-
-		// Check the global queue first, then check the private queue and wait if there's nothing to do.
-		if (global_queue_size() > 0) {
-			// Grab one from the global queue if there is any.
-			std::unique_lock<std::mutex> lock(global->mutex);
-			auto queue = isCompute ? global->compute_queue : global->io_queue;
-			auto &queue_size = isCompute ? global->compute_queue_size : global->io_queue_size;
-
-			for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
-				if (!queue[p].empty()) {
-					task = queue[p].front();
-					queue[p].pop_front();
-					queue_size--;
-
-					// We are processing one now, so mark that.
-					thread->queue_size++;
-					break;
-				} else if (thread->queue_size != 0) {
-					// Check the thread, as we prefer a HIGH thread task to a global NORMAL task.
-					std::unique_lock<std::mutex> lock(thread->mutex);
-					if (!thread->private_queue[p].empty()) {
-						task = thread->private_queue[p].front();
-						thread->private_queue[p].pop_front();
-						break;
-					}
-				}
-			}
+		Task *task = FindTask(global, thread);
+
+		for (int spins = 0; !task && spins < thread->spinCount && !thread->cancelled; ++spins) {
+			yield();
+			// Checking all the other threads' rings each time would just cause cache traffic.
+			if ((spins & 15) == 15)
+				task = FindTask(global, thread);
 		}
 
 		if (!task) {
-			// We didn't have any global, do we have anything on the thread?
 			std::unique_lock<std::mutex> lock(thread->mutex);
-			for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
-				if (thread->private_queue[p].empty())
-					continue;
-
-				task = thread->private_queue[p].front();
-				thread->private_queue[p].pop_front();
-				break;
-			}
-
-			// We must check both queue and single again, while locked.
-			bool wait = !thread->cancelled && !task && global_queue_size() == 0;
-
+			thread->parked = true;
+			// We must check again after parking, since enqueuers only notify parked threads.
+			bool wait = !thread->cancelled && thread->queue_size == 0 && global_queue_size() == 0;
 			if (wait)
 				thread->cond.wait(lock);
+			thread->parked = false;
+			continue;
 		}
+
 		// The task itself takes care of notifying anyone waiting on it. Not the
 		// responsibility of the ThreadManager (although it could be!).
-		if (task) {
-			task->Run();
-			task->Release();
-			// Reduce the queue size once complete.
-			thread->queue_size--;
-			// _dbg_assert_(thread->queue_size == thread->private_queue[0].size() + thread->private_queue[1].size() + thread->private_queue[2].size());
-		}
+		task->Run();
+		task->Release();
+		// Reduce the queue size once complete.
+		thread->queue_size--;
 	}
 
 	// In case it got attached to JNI, detach it. Don't think this has any side effects if called redundantly.
@@ -227,14 +366,25 @@ void ThreadManager::Init(int numRealCores, int numLogicalCoresPerCpu) {
 
 	INFO_LOG(Log::System, "ThreadManager::Init(compute threads: %d, all: %d)", numComputeThreads_, numThreads_);
 
+	// Spinning only helps if the compute threads each have a core.  IO tasks are rarely back to back, so never for those.
+	const int hardwareThreads = (int)std::thread::hardware_concurrency();
+	const bool spinCompute = hardwareThreads > 1 && numComputeThreads_ <= hardwareThreads;
+
 	for (int i = 0; i < numThreads; i++) {
 		TaskThreadContext *thread = new TaskThreadContext();
+		thread->queue_size.store(0);
+		thread->private_queue_size.store(0);
+		thread->parked.store(false);
 		thread->cancelled.store(false);
 		thread->type = i < numComputeThreads_ ? TaskType::CPU_COMPUTE : TaskType::IO_BLOCKING;
+		thread->spinCount = thread->type == TaskType::CPU_COMPUTE && spinCompute ? IDLE_SPIN_COUNT : 0;
 		thread->index = i;
-		thread->thread = std::thread(&WorkerThreadFunc, global_, thread);
 		global_->threads_.push_back(thread);
 	}
+	// Start them only once the list is complete, since they look at each other to steal work.
+	for (TaskThreadContext *thread : global_->threads_) {
+		thread->thread = std::thread(&WorkerThreadFunc, global_, thread);
+	}
 }
 
 void ThreadManager::EnqueueTask(Task *task) {
@@ -268,16 +418,13 @@ void ThreadManager::EnqueueTask(Task *task) {
 	for (int threadNum = minThread; threadNum < maxThread; threadNum++) {
 		TaskThreadContext *thread = global_->threads_[threadNum];
 		if (thread->queue_size.load() == 0) {
-			std::unique_lock<std::mutex> lock(thread->mutex);
-			thread->private_queue[queueIndex].push_back(task);
-			thread->queue_size++;
-			thread->cond.notify_one();
+			PushPrivateTask(thread, task);
 			// Found it - done.
 			return;
 		}
 	}
 
-	// Still not scheduled? Put it on the global queue and notify a thread chosen by round-robin.
+	// Still not scheduled? Put it on the global queue and wake a thread, so it gets picked up or stolen.
 	// Not particularly scientific, but hopefully we should not run into this too much.
 	{
 		std::unique_lock<std::mutex> lock(global_->mutex);
@@ -292,9 +439,18 @@ void ThreadManager::EnqueueTask(Task *task) {
 		}
 	}
 
-	int chosenIndex = global_->roundRobin++;
-	chosenIndex = minThread + (chosenIndex % (maxThread - minThread));
-	TaskThreadContext *&chosenThread = global_->threads_[chosenIndex];
+	// Prefer a sleeping thread, since any others will find it on their own.  Otherwise, round-robin.
+	TaskThreadContext *chosenThread = nullptr;
+	for (int threadNum = minThread; threadNum < maxThread; threadNum++) {
+		if (global_->threads_[threadNum]->parked.load()) {
+			chosenThread = global_->threads_[threadNum];
+			break;
+		}
+	}
+	if (!chosenThread) {
+		int chosenIndex = global_->roundRobin++;
+		chosenThread = global_->threads_[minThread + (chosenIndex % (maxThread - minThread))];
+	}
 
 	// Lock the thread to ensure it gets the message.
 	std::unique_lock<std::mutex> lock(chosenThread->mutex);
@@ -305,14 +461,7 @@ void ThreadManager::EnqueueTaskOnThread(int threadNum, Task *task) {
 	_assert_msg_(task->Type() != TaskType::DEDICATED_THREAD, "Dedicated thread tasks can't be put on specific threads");
 
 	_assert_msg_(threadNum >= 0 && threadNum < (int)global_->threads_.size(), "Bad threadnum %d(/%d) or not initialized", threadNum, (int)global_->threads_.size());
-	TaskThreadContext *thread = global_->threads_[threadNum];
-	size_t queueIndex = (size_t)task->Priority();
-
-	thread->queue_size++;
-
-	std::unique_lock<std::mutex> lock(thread->mutex);
-	thread->private_queue[queueIndex].push_back(task);
-	thread->cond.notify_one();
+	PushPrivateTask(global_->threads_[threadNum], task);
 }
 
 int ThreadManager::GetNumLooperThreads() const {
@@ -116,6 +116,9 @@ struct Config {
 	bool bHideSlowWarnings;
 	bool bHideStateWarnings;
 	uint32_t uJitDisableFlags;
+	bool bIRBlockCache;  // Hidden ini-only setting, persists simplified IR per game to speed up warm starts.
+	bool bIRAsyncCompile;  // Hidden ini-only setting, generates native code for new IR blocks on a worker thread.
+	bool bIRTraceFormation;  // Hidden ini-only setting, lets the IR interpreter inline hot forward branches into superblocks.
 
 	bool bDisableHTTPS;
 
@@ -220,6 +223,8 @@ struct Config {
 	float fUISaturation;
 
 	bool bTextureBackoffCache;
+	bool bVertexCache;  // Hidden ini-only setting, keeps decoded vertices of static meshes across frames.
+	bool bAsyncTextureDecode;  // Hidden ini-only setting, spreads big texture decodes over several frames.
 	bool bVertexDecoderJit;
 	int iAppSwitchMode;
 	bool bFullScreen;
@@ -243,6 +248,7 @@ struct Config {
 	int iMaxRecent;
 	int iCurrentStateSlot;
 	int iRewindSnapshotInterval;
+	bool bRewindTrackPages;  // Hidden ini-only setting, rewind snapshots only copy RAM pages that changed. Costs a shadow copy of RAM.
 	bool bUISound;
 	bool bEnableStateUndo;
 	std::string sStateLoadUndoGame;
@@ -306,6 +312,7 @@ struct Config {
 	std::string sAudioDevice;
 	bool bAutoAudioDevice;
 	bool bUseOldAtrac;
+	bool bParallelSasMix;
 
 	// iOS only for now
 	bool bAudioMixWithOthers;
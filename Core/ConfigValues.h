@@ -229,6 +229,7 @@ enum class DebugOverlay : int {
 #endif
 	CONTROL,
 	Audio,
+	HLE_STATS,
 	GPU_PROFILE,
 	GPU_ALLOCATOR,
 	FRAMEBUFFER_LIST,
@@ -130,6 +130,7 @@ const char *BreakReasonToString(BreakReason reason) {
 	case BreakReason::FrameAdvance: return "ui.frameAdvance";
 	case BreakReason::UIPause: return "ui.pause";
 	case BreakReason::HLEDebugBreak: return "hle.step";
+	case BreakReason::JitProfile: return "cpu.profile";
 	default: return "Unknown";
 	}
 }
@@ -70,6 +70,7 @@ enum class BreakReason {
 	FrameAdvance,
 	UIPause,
 	HLEDebugBreak,
+	JitProfile,
 };
 const char *BreakReasonToString(BreakReason reason);
 
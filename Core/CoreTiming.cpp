@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <atomic>
 #include <climits>
 #include <cstdio>
@@ -48,8 +49,22 @@ static std::set<int> usedEventTypes;
 static std::set<int> restoredEventTypes;
 static int nextEventTypeRestoreId = -1;
 
-Event *first;
-Event *eventPool = 0;
+struct QueuedEvent {
+	BaseEvent ev;
+	// Events at the same time fire in the order they were scheduled.
+	u64 order;
+};
+
+// Binary min-heap (via std::push_heap etc.) on time, so the next event is always at the front.
+static std::vector<QueuedEvent> eventQueue;
+static u64 nextEventOrder;
+
+// The std heap functions build a max-heap, so "less" here means "fires later".
+static bool EventLater(const QueuedEvent &a, const QueuedEvent &b) {
+	if (a.ev.time != b.ev.time)
+		return a.ev.time > b.ev.time;
+	return a.order > b.order;
+}
 
 // Downcount has been moved to currentMIPS, to save a couple of clocks in every ARM JIT block
 // as we can already reach that structure through a register.
@@ -106,30 +121,21 @@ u64 GetGlobalTimeUs() {
 	return lastGlobalTimeUs + usSinceLast;
 }
 
-const Event *GetFirstEvent() {
-	return first;
+std::vector<BaseEvent> GetScheduledEvents() {
+	std::vector<QueuedEvent> sorted = eventQueue;
+	std::sort_heap(sorted.begin(), sorted.end(), &EventLater);
+	std::vector<BaseEvent> events;
+	events.reserve(sorted.size());
+	// sort_heap gives us the latest first.
+	for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
+		events.push_back(it->ev);
+	return events;
 }
 
 const std::vector<EventType> &GetEventTypes() {
 	return event_types;
 }
 
-Event* GetNewEvent()
-{
-	if(!eventPool)
-		return new Event;
-
-	Event* ev = eventPool;
-	eventPool = ev->next;
-	return ev;
-}
-
-void FreeEvent(Event* ev)
-{
-	ev->next = eventPool;
-	eventPool = ev;
-}
-
 int RegisterEvent(const char *name, TimedCallback callback) {
 	for (const auto &ty : event_types) {
 		if (!strcmp(ty.name, name)) {
@@ -173,7 +179,7 @@ void RestoreRegisterEvent(int &event_type, const char *name, TimedCallback callb
 }
 
 void UnregisterAllEvents() {
-	_dbg_assert_msg_(first == nullptr, "Unregistering events with events pending - this isn't good.");
+	_dbg_assert_msg_(eventQueue.empty(), "Unregistering events with events pending - this isn't good.");
 	event_types.clear();
 	usedEventTypes.clear();
 	restoredEventTypes.clear();
@@ -195,12 +201,7 @@ void Shutdown()
 {
 	ClearPendingEvents();
 	UnregisterAllEvents();
-
-	while (eventPool) {
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		delete ev;
-	}
+	eventQueue.shrink_to_fit();
 }
  
 u64 GetTicks()
@@ -220,30 +221,66 @@ u64 GetIdleTicks()
 
 void ClearPendingEvents()
 {
-	while (first)
-	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
-	}
+	eventQueue.clear();
+	nextEventOrder = 0;
 }
 
-void AddEventToQueue(Event* ne)
+void AddEventToQueue(const BaseEvent &ev)
 {
-	Event* prev = NULL;
-	Event** pNext = &first;
-	for(;;)
-	{
-		Event*& next = *pNext;
-		if(!next || ne->time < next->time)
-		{
-			ne->next = next;
-			next = ne;
+	eventQueue.push_back(QueuedEvent{ ev, nextEventOrder++ });
+	std::push_heap(eventQueue.begin(), eventQueue.end(), &EventLater);
+}
+
+// Restores the heap property after eventQueue[i] was replaced.
+static void FixEventAt(size_t i) {
+	const size_t size = eventQueue.size();
+	// Sift up.
+	while (i > 0) {
+		size_t parent = (i - 1) / 2;
+		if (!EventLater(eventQueue[parent], eventQueue[i]))
 			break;
+		std::swap(eventQueue[parent], eventQueue[i]);
+		i = parent;
+	}
+	// Sift down.
+	while (true) {
+		size_t earliest = i;
+		size_t left = i * 2 + 1;
+		size_t right = left + 1;
+		if (left < size && EventLater(eventQueue[earliest], eventQueue[left]))
+			earliest = left;
+		if (right < size && EventLater(eventQueue[earliest], eventQueue[right]))
+			earliest = right;
+		if (earliest == i)
+			break;
+		std::swap(eventQueue[earliest], eventQueue[i]);
+		i = earliest;
+	}
+}
+
+// Removes all matching events, and returns the time of the last one that would've fired (or INT64_MIN.)
+template <typename F>
+static s64 RemoveEventsIf(F pred) {
+	s64 lastTime = INT64_MIN;
+	size_t i = 0;
+	while (i < eventQueue.size()) {
+		if (!pred(eventQueue[i].ev)) {
+			++i;
+			continue;
 		}
-		prev = next;
-		pNext = &prev->next;
+		lastTime = std::max(lastTime, eventQueue[i].ev.time);
+		// Drop matches from the end first, so what we move into i has already been checked.
+		while (eventQueue.size() > i + 1 && pred(eventQueue.back().ev)) {
+			lastTime = std::max(lastTime, eventQueue.back().ev.time);
+			eventQueue.pop_back();
+		}
+		eventQueue[i] = eventQueue.back();
+		eventQueue.pop_back();
+		// Sifting down may move an unchecked event into i, so don't advance.
+		if (i < eventQueue.size())
+			FixEventAt(i);
 	}
+	return lastTime;
 }
 
 // This must be run ONLY from within the cpu thread
@@ -251,56 +288,22 @@ void AddEventToQueue(Event* ne)
 // than Advance
 void ScheduleEvent(s64 cyclesIntoFuture, int event_type, u64 userdata)
 {
-	Event *ne = GetNewEvent();
-	ne->userdata = userdata;
-	ne->type = event_type;
-	ne->time = GetTicks() + cyclesIntoFuture;
+	BaseEvent ne;
+	ne.userdata = userdata;
+	ne.type = event_type;
+	ne.time = GetTicks() + cyclesIntoFuture;
 	AddEventToQueue(ne);
 }
 
 // Returns cycles left in timer.
 s64 UnscheduleEvent(int event_type, u64 userdata)
 {
-	s64 result = 0;
-	if (!first)
-		return result;
-	while(first)
-	{
-		if (first->type == event_type && first->userdata == userdata)
-		{
-			result = first->time - GetTicks();
-
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-	if (!first)
-		return result;
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type && ptr->userdata == userdata)
-		{
-			result = ptr->time - GetTicks();
-
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
-	}
-
-	return result;
+	s64 lastTime = RemoveEventsIf([&](const BaseEvent &ev) {
+		return ev.type == event_type && ev.userdata == userdata;
+	});
+	if (lastTime == INT64_MIN)
+		return 0;
+	return lastTime - GetTicks();
 }
 
 void RegisterMHzChangeCallback(MHzChangeCallback callback) {
@@ -309,66 +312,32 @@ void RegisterMHzChangeCallback(MHzChangeCallback callback) {
 
 bool IsScheduled(int event_type)
 {
-	if (!first)
-		return false;
-	Event *e = first;
-	while (e) {
-		if (e->type == event_type)
+	for (const QueuedEvent &e : eventQueue) {
+		if (e.ev.type == event_type)
 			return true;
-		e = e->next;
 	}
 	return false;
 }
 
 void RemoveEvent(int event_type)
 {
-	if (!first)
-		return;
-	while(first)
-	{
-		if (first->type == event_type)
-		{
-			Event *next = first->next;
-			FreeEvent(first);
-			first = next;
-		}
-		else
-		{
-			break;
-		}
-	}
-	if (!first)
-		return;
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
-	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
-	}
+	RemoveEventsIf([&](const BaseEvent &ev) {
+		return ev.type == event_type;
+	});
 }
 
 void ProcessEvents() {
-	while (first) {
-		if (first->time <= (s64)GetTicks()) {
-			// INFO_LOG(Log::CPU, "%s (%lld, %lld) ", first->name ? first->name : "?", (u64)GetTicks(), (u64)first->time);
-			Event *evt = first;
-			first = first->next;
-			if (evt->type >= 0 && evt->type < event_types.size()) {
-				event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
+	while (!eventQueue.empty()) {
+		if (eventQueue.front().ev.time <= (s64)GetTicks()) {
+			// Pop first, the callback may schedule more events.
+			std::pop_heap(eventQueue.begin(), eventQueue.end(), &EventLater);
+			BaseEvent evt = eventQueue.back().ev;
+			eventQueue.pop_back();
+			if (evt.type >= 0 && evt.type < event_types.size()) {
+				event_types[evt.type].callback(evt.userdata, (int)(GetTicks() - evt.time));
 			} else {
-				_dbg_assert_msg_(false, "Bad event type %d", evt->type);
+				_dbg_assert_msg_(false, "Bad event type %d", evt.type);
 			}
-			FreeEvent(evt);
 		} else {
 			// Caught up to the current time.
 			break;
@@ -398,7 +367,7 @@ void Advance() {
 
 	ProcessEvents();
 
-	if (!first) {
+	if (eventQueue.empty()) {
 		// This should never happen in PPSSPP.
 		if (slicelength < 10000) {
 			slicelength += 10000;
@@ -406,7 +375,7 @@ void Advance() {
 		}
 	} else {
 		// Note that events can eat cycles as well.
-		int target = (int)(first->time - globalTimer);
+		int target = (int)(eventQueue.front().ev.time - globalTimer);
 		if (target > MAX_SLICE_LENGTH)
 			target = MAX_SLICE_LENGTH;
 
@@ -417,10 +386,8 @@ void Advance() {
 }
 
 void LogPendingEvents() {
-	Event *ptr = first;
-	while (ptr) {
-		//INFO_LOG(Log::CPU, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, ptr->time, ptr->type);
-		ptr = ptr->next;
+	for (const BaseEvent &ev : GetScheduledEvents()) {
+		//INFO_LOG(Log::CPU, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, ev.time, ev.type);
 	}
 }
 
@@ -429,9 +396,9 @@ void Idle(int maxIdle) {
 	if (maxIdle != 0 && cyclesDown > maxIdle)
 		cyclesDown = maxIdle;
 
-	if (first && cyclesDown > 0) {
+	if (!eventQueue.empty() && cyclesDown > 0) {
 		int cyclesExecuted = slicelength - currentMIPS->downcount;
-		int cyclesNextEvent = (int) (first->time - globalTimer);
+		int cyclesNextEvent = (int) (eventQueue.front().ev.time - globalTimer);
 
 		if (cyclesNextEvent < cyclesExecuted + cyclesDown)
 			cyclesDown = cyclesNextEvent - cyclesExecuted;
@@ -450,23 +417,20 @@ void Idle(int maxIdle) {
 }
 
 std::string GetScheduledEventsSummary() {
-	Event *ptr = first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
-	while (ptr) {
-		unsigned int t = ptr->type;
+	for (const BaseEvent &ev : GetScheduledEvents()) {
+		unsigned int t = ev.type;
 		if (t >= event_types.size()) {
 			_dbg_assert_msg_(false, "Invalid event type %d", t);
-			ptr = ptr->next;
 			continue;
 		}
 		const char *name = event_types[t].name;
 		if (!name)
 			name = "[unknown]";
 		char temp[512];
-		snprintf(temp, sizeof(temp), "%s : %i %08x%08x\n", name, (int)ptr->time, (u32)(ptr->userdata >> 32), (u32)(ptr->userdata));
+		snprintf(temp, sizeof(temp), "%s : %i %08x%08x\n", name, (int)ev.time, (u32)(ev.userdata >> 32), (u32)(ev.userdata));
 		text += temp;
-		ptr = ptr->next;
 	}
 	return text;
 }
@@ -484,6 +448,35 @@ void Event_DoStateOld(PointerWrap &p, BaseEvent *ev) {
 	usedEventTypes.insert(ev->type);
 }
 
+// Same format as DoLinkedList, which the queue used to be: a 1 before each event in firing order, then a 0.
+static void DoEventQueue(PointerWrap &p, void (*doEvent)(PointerWrap &p, BaseEvent *ev)) {
+	if (p.mode == PointerWrap::MODE_READ) {
+		ClearPendingEvents();
+		while (true) {
+			u8 shouldExist = 0;
+			Do(p, shouldExist);
+			if (shouldExist != 1) {
+				if (shouldExist != 0) {
+					WARN_LOG(Log::SaveState, "Savestate failure: incorrect item marker %d", shouldExist);
+					p.SetError(p.ERROR_FAILURE);
+				}
+				break;
+			}
+			BaseEvent ev{};
+			doEvent(p, &ev);
+			AddEventToQueue(ev);
+		}
+	} else {
+		for (BaseEvent ev : GetScheduledEvents()) {
+			u8 shouldExist = 1;
+			Do(p, shouldExist);
+			doEvent(p, &ev);
+		}
+		u8 shouldExist = 0;
+		Do(p, shouldExist);
+	}
+}
+
 void DoState(PointerWrap &p) {
 	auto s = p.Section("CoreTiming", 1, 3);
 	if (!s)
@@ -508,11 +501,11 @@ void DoState(PointerWrap &p) {
 	restoredEventTypes.clear();
 
 	if (s >= 3) {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoState>(p, first, (Event **)nullptr);
+		DoEventQueue(p, &Event_DoState);
 		// This is here because we previously stored a second queue of "threadsafe" events. Gone now. Remove in the next section version upgrade.
 		DoIgnoreUnusedLinkedList(p);
 	} else {
-		DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, Event_DoStateOld>(p, first, (Event **)nullptr);
+		DoEventQueue(p, &Event_DoStateOld);
 		DoIgnoreUnusedLinkedList(p);
 	}
 
@@ -20,7 +20,6 @@
 #include <string>
 #include <vector>
 #include "Common/CommonTypes.h"
-#include "Common/Data/Collections/LinkedList.h"
 
 // This is a system to schedule events into the emulated machine's future. Time is measured
 // in main CPU clock cycles.
@@ -86,7 +85,6 @@ namespace CoreTiming {
 		u64 userdata;
 		int type;
 	};
-	typedef LinkedListItem<BaseEvent> Event;
 
 	void Init();
 	void Shutdown();
@@ -109,7 +107,8 @@ namespace CoreTiming {
 	s64 UnscheduleEvent(int event_type, u64 userdata);
 
 	const std::vector<EventType> &GetEventTypes();
-	const Event *GetFirstEvent();
+	// Pending events in the order they will fire. Makes a copy, intended for debugging.
+	std::vector<BaseEvent> GetScheduledEvents();
 	void RemoveEvent(int event_type);
 	bool IsScheduled(int event_type);
 	void Advance();
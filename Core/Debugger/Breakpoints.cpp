@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -312,6 +313,7 @@ int BreakpointManager::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, B
 		check.result = result;
 
 		memChecks_.push_back(check);
+		UpdateMemCheckIndexLocked();
 		bool hadAny = anyMemChecks_.exchange(true);
 		if (!hadAny) {
 			MemBlockOverrideDetailed();
@@ -321,6 +323,7 @@ int BreakpointManager::AddMemCheck(u32 start, u32 end, MemCheckCondition cond, B
 	} else {
 		memChecks_[mc].cond = (MemCheckCondition)(memChecks_[mc].cond | cond);
 		memChecks_[mc].result = (BreakAction)(memChecks_[mc].result | result);
+		UpdateMemCheckIndexLocked();
 		bool hadAny = anyMemChecks_.exchange(true);
 		if (!hadAny) {
 			MemBlockOverrideDetailed();
@@ -338,6 +341,7 @@ void BreakpointManager::RemoveMemCheck(u32 start, u32 end)
 	if (mc != INVALID_MEMCHECK)
 	{
 		memChecks_.erase(memChecks_.begin() + mc);
+		UpdateMemCheckIndexLocked();
 		bool hadAny = anyMemChecks_.exchange(!memChecks_.empty());
 		if (hadAny)
 			MemBlockReleaseDetailed();
@@ -353,6 +357,7 @@ void BreakpointManager::ChangeMemCheck(u32 start, u32 end, MemCheckCondition con
 	{
 		memChecks_[mc].cond = cond;
 		memChecks_[mc].result = result;
+		UpdateMemCheckIndexLocked();
 		Update();
 	}
 }
@@ -364,6 +369,7 @@ void BreakpointManager::ClearAllMemChecks()
 	if (!memChecks_.empty())
 	{
 		memChecks_.clear();
+		UpdateMemCheckIndexLocked();
 		bool hadAny = anyMemChecks_.exchange(false);
 		if (hadAny)
 			MemBlockReleaseDetailed();
@@ -436,30 +442,39 @@ bool BreakpointManager::GetMemCheckInRange(u32 address, int size, MemCheck *chec
 }
 
 MemCheck *BreakpointManager::GetMemCheckLocked(u32 address, int size) {
-	std::vector<MemCheck>::iterator iter;
-	for (iter = memChecks_.begin(); iter != memChecks_.end(); ++iter)
-	{
-		MemCheck &check = *iter;
-		if (check.end != 0)
-		{
-			if (NotCached(address + size) > NotCached(check.start) && NotCached(address) < NotCached(check.end))
-				return &check;
-		}
-		else
-		{
-			if (NotCached(check.start) == NotCached(address))
-				return &check;
-		}
+	const u32 start = NotCached(address);
+	const u32 end = NotCached(address + size);
+	// If several match, the first one added wins.
+	size_t found = INVALID_MEMCHECK;
+
+	auto exact = std::lower_bound(memCheckAddresses_.begin(), memCheckAddresses_.end(), std::make_pair(start, (u32)0));
+	if (exact != memCheckAddresses_.end() && exact->first == start)
+		found = exact->second;
+
+	// Only intervals starting before the access ends can overlap it, walk back until none reach it.
+	auto iter = std::partition_point(memCheckIntervals_.begin(), memCheckIntervals_.end(), [&](const MemCheckInterval &interval) {
+		return interval.start < end;
+	});
+	while (iter != memCheckIntervals_.begin()) {
+		--iter;
+		if (iter->maxEnd <= start)
+			break;
+		if (iter->end > start && iter->index < found)
+			found = iter->index;
 	}
 
-	//none found
-	return 0;
+	if (found == INVALID_MEMCHECK)
+		return nullptr;
+	return &memChecks_[found];
 }
 
 BreakAction BreakpointManager::ExecMemCheck(u32 address, bool write, int size, u32 pc, const char *reason)
 {
 	if (!anyMemChecks_)
 		return BREAK_ACTION_IGNORE;
+	// Almost all accesses are nowhere near a memcheck, skip the lock for those.
+	if (size <= 16 && !IsMemCheckPage(address, write))
+		return BREAK_ACTION_IGNORE;
 	std::unique_lock<std::mutex> guard(memCheckMutex_);
 	auto check = GetMemCheckLocked(address, size);
 	if (check) {
@@ -485,6 +500,8 @@ BreakAction BreakpointManager::ExecOpMemCheck(u32 address, u32 pc) {
 	}
 
 	bool write = MIPSAnalyst::IsOpMemoryWrite(pc);
+	if (!IsMemCheckPage(address, write))
+		return BREAK_ACTION_IGNORE;
 	std::unique_lock<std::mutex> guard(memCheckMutex_);
 	auto check = GetMemCheckLocked(address, size);
 	if (check) {
@@ -543,8 +560,27 @@ static MemCheck VRAMMirror(uint8_t mirror, MemCheck mc) {
 	return mc;
 }
 
-void BreakpointManager::UpdateCachedMemCheckRanges() {
-	std::lock_guard<std::mutex> guard(memCheckMutex_);
+void BreakpointManager::UpdateMemCheckIndexLocked() {
+	memCheckIntervals_.clear();
+	memCheckAddresses_.clear();
+	for (size_t i = 0; i < memChecks_.size(); ++i) {
+		const MemCheck &check = memChecks_[i];
+		if (check.end != 0)
+			memCheckIntervals_.push_back({ NotCached(check.start), NotCached(check.end), 0, (u32)i });
+		else
+			memCheckAddresses_.emplace_back(NotCached(check.start), (u32)i);
+	}
+
+	std::sort(memCheckIntervals_.begin(), memCheckIntervals_.end(), [](const MemCheckInterval &a, const MemCheckInterval &b) {
+		return a.start < b.start;
+	});
+	u32 maxEnd = 0;
+	for (auto &interval : memCheckIntervals_) {
+		maxEnd = std::max(maxEnd, interval.end);
+		interval.maxEnd = maxEnd;
+	}
+	std::sort(memCheckAddresses_.begin(), memCheckAddresses_.end());
+
 	memCheckRangesRead_.clear();
 	memCheckRangesWrite_.clear();
 
@@ -570,6 +606,52 @@ void BreakpointManager::UpdateCachedMemCheckRanges() {
 			add(read, write, NotCached(check));
 		}
 	}
+
+	UpdateMemCheckPagesLocked(memCheckPagesRead_, false);
+	UpdateMemCheckPagesLocked(memCheckPagesWrite_, true);
+}
+
+void BreakpointManager::UpdateMemCheckPagesLocked(u32 *pages, bool write) {
+	std::vector<u32> updated(MEMCHECK_PAGE_WORDS);
+	auto mark = [&](u32 addr) {
+		u32 page = addr >> MEMCHECK_PAGE_SHIFT;
+		updated[page >> 5] |= 1U << (page & 31);
+	};
+
+	int mask = write ? MEMCHECK_WRITE : MEMCHECK_READ;
+	for (const auto &check : memChecks_) {
+		if ((check.cond & mask) == 0)
+			continue;
+
+		// Same as GetMemCheckLocked(), ignoring the cached bit and VRAM mirrors.
+		u32 start = NotCached(check.start);
+		u32 end = check.end != 0 ? NotCached(check.end) : start + 1;
+		if (end <= start)
+			continue;
+		// An access of up to 16 bytes starting on the previous page could still overlap.
+		start = start > 16 ? start - 16 : 0;
+
+		for (u32 page = start >> MEMCHECK_PAGE_SHIFT; page <= (end - 1) >> MEMCHECK_PAGE_SHIFT; ++page) {
+			u32 addr = page << MEMCHECK_PAGE_SHIFT;
+			u32 mirrors = (addr & 0x3F800000) == 0x04000000 ? 4 : 1;
+			for (u32 mirror = 0; mirror < mirrors; ++mirror) {
+				mark(addr | (mirror << 21));
+				mark(addr | (mirror << 21) | 0x40000000);
+			}
+		}
+	}
+
+	// Only touch what changed, the jit may be testing these from the emu thread right now.
+	for (size_t i = 0; i < MEMCHECK_PAGE_WORDS; ++i) {
+		if (pages[i] != updated[i])
+			pages[i] = updated[i];
+	}
+}
+
+void BreakpointManager::MemCheckRefsChanged() {
+	std::lock_guard<std::mutex> guard(memCheckMutex_);
+	UpdateMemCheckIndexLocked();
+	Update();
 }
 
 std::vector<MemCheck> BreakpointManager::GetMemCheckRanges(bool write) {
@@ -604,9 +686,6 @@ void BreakpointManager::Frame() {
 			mipsr4k.ClearJitCache();
 	}
 
-	if (anyMemChecks_ && updateAddr_ != -1)
-		UpdateCachedMemCheckRanges();
-
 	// Redraw in order to show the breakpoint.
 	System_Notify(SystemNotification::DISASSEMBLY);
 	needsUpdate_ = false;
@@ -20,6 +20,7 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
+#include <utility>
 
 #include "Core/MIPS/MIPSDebugInterface.h"
 #include "Common/Math/expression_parser.h"
@@ -122,6 +123,9 @@ class BreakpointManager {
 public:
 	static const size_t INVALID_BREAKPOINT = -1;
 	static const size_t INVALID_MEMCHECK = -1;
+	// Memchecks are also tracked per page, one bit per page of the full 32-bit address space.
+	static const int MEMCHECK_PAGE_SHIFT = 12;
+	static const size_t MEMCHECK_PAGE_WORDS = (1ULL << (32 - MEMCHECK_PAGE_SHIFT)) / 32;
 
 	bool IsAddressBreakPoint(u32 addr);
 	bool IsAddressBreakPoint(u32 addr, bool* enabled);
@@ -164,6 +168,15 @@ class BreakpointManager {
 
 	// Includes uncached addresses.
 	std::vector<MemCheck> GetMemCheckRanges(bool write);
+	// A bit is set for each page that an access (of any size) could trigger a memcheck from.
+	// Stays valid forever and is updated in place, so the jit can test it without a call.
+	const u32 *GetMemCheckPageBitmap(bool write) const {
+		return write ? memCheckPagesWrite_ : memCheckPagesRead_;
+	}
+	bool IsMemCheckPage(u32 address, bool write) const {
+		u32 page = address >> MEMCHECK_PAGE_SHIFT;
+		return (GetMemCheckPageBitmap(write)[page >> 5] & (1U << (page & 31))) != 0;
+	}
 
 	std::vector<MemCheck> GetMemChecks();
 	std::vector<BreakPoint> GetBreakpoints();
@@ -176,6 +189,8 @@ class BreakpointManager {
 	std::vector<MemCheck> &GetMemCheckRefs() {
 		return memChecks_;
 	}
+	// Call after changing the address or condition of a memcheck through GetMemCheckRefs().
+	void MemCheckRefsChanged();
 
 	bool HasBreakPoints() const {
 		return anyBreakPoints_;
@@ -199,7 +214,8 @@ class BreakpointManager {
 	// Finds exactly, not using a range check.
 	size_t FindMemCheck(u32 start, u32 end);
 	MemCheck *GetMemCheckLocked(u32 address, int size);
-	void UpdateCachedMemCheckRanges();
+	void UpdateMemCheckIndexLocked();
+	void UpdateMemCheckPagesLocked(u32 *pages, bool write);
 
 	std::atomic<bool> anyBreakPoints_;
 	std::atomic<bool> anyMemChecks_;
@@ -215,6 +231,19 @@ class BreakpointManager {
 	std::vector<MemCheck> memCheckRangesRead_;
 	std::vector<MemCheck> memCheckRangesWrite_;
 
+	// Sorted by start, with the highest end seen so far, so lookups don't need to scan every memcheck.
+	struct MemCheckInterval {
+		u32 start;
+		u32 end;
+		u32 maxEnd;
+		u32 index;
+	};
+	std::vector<MemCheckInterval> memCheckIntervals_;
+	// Memchecks without an end only match their exact start address.
+	std::vector<std::pair<u32, u32>> memCheckAddresses_;
+	u32 memCheckPagesRead_[MEMCHECK_PAGE_WORDS]{};
+	u32 memCheckPagesWrite_[MEMCHECK_PAGE_WORDS]{};
+
 	bool needsUpdate_ = true;
 	u32 updateAddr_ = 0;
 };
@@ -25,6 +25,8 @@
 #include "Core/HLE/sceKernelThread.h"
 #include "Core/MIPS/MIPS.h"
 #include "Core/MIPS/MIPSDebugInterface.h"
+#include "Core/MIPS/JitCommon/JitCommon.h"
+#include "Core/MIPS/JitCommon/JitBlockCache.h"
 #include "Core/Reporting.h"
 
 DebuggerSubscriber *WebSocketCPUCoreInit(DebuggerEventHandlerMap &map) {
@@ -36,6 +38,9 @@ DebuggerSubscriber *WebSocketCPUCoreInit(DebuggerEventHandlerMap &map) {
 	map["cpu.getReg"] = &WebSocketCPUGetReg;
 	map["cpu.setReg"] = &WebSocketCPUSetReg;
 	map["cpu.evaluate"] = &WebSocketCPUEvaluate;
+	map["cpu.profile.start"] = &WebSocketCPUProfileStart;
+	map["cpu.profile.stop"] = &WebSocketCPUProfileStop;
+	map["cpu.profile.get"] = &WebSocketCPUProfileGet;
 
 	return nullptr;
 }
@@ -48,6 +53,33 @@ static std::string RegValueAsFloat(uint32_t u) {
 	return StringFromFormat("%f", bits.f);
 }
 
+// The block cache is only safe to touch while the CPU isn't running.
+struct AutoPausedJit {
+	AutoPausedJit() {
+		wasStepping = Core_IsStepping();
+		if (!wasStepping) {
+			Core_Break(BreakReason::JitProfile, 0);
+			Core_WaitInactive();
+		}
+		// Only once paused, the CPU thread may be holding it until then.
+		guard.lock();
+	}
+	~AutoPausedJit() {
+		// Let go before resuming, so the CPU thread doesn't block on it.
+		if (guard.owns_lock())
+			guard.unlock();
+		if (!wasStepping)
+			Core_Resume();
+	}
+
+	JitBlockCacheDebugInterface *BlockCache() {
+		return MIPSComp::jit ? MIPSComp::jit->GetBlockCacheDebugInterface() : nullptr;
+	}
+
+	std::unique_lock<std::recursive_mutex> guard{ MIPSComp::jitLock, std::defer_lock };
+	bool wasStepping;
+};
+
 static DebugInterface *CPUFromRequest(DebuggerRequest &req) {
 	if (!req.HasParam("thread"))
 		return currentDebugMIPS;
@@ -417,3 +449,91 @@ void WebSocketCPUEvaluate(DebuggerRequest &req) {
 	json.writeUint("uintValue", val);
 	json.writeString("floatValue", RegValueAsFloat(val));
 }
+
+// Start sampling which blocks the CPU spends time in (cpu.profile.start)
+//
+// Parameters:
+//  - interval: optional number of block dispatches per sample, default 64.
+//  - reset: optional boolean, whether to clear previous stats, default true.
+//
+// Response (same event name) with no extra data.
+//
+// Note: currently only supported by the IR interpreter.
+void WebSocketCPUProfileStart(DebuggerRequest &req) {
+	if (!currentDebugMIPS->isAlive()) {
+		return req.Fail("CPU not started");
+	}
+
+	uint32_t interval = 64;
+	if (!req.ParamU32("interval", &interval, false, DebuggerParamType::OPTIONAL))
+		return;
+	bool reset = true;
+	if (!req.ParamBool("reset", &reset, DebuggerParamType::OPTIONAL))
+		return;
+	if (interval == 0 || interval > 0x10000)
+		return req.Fail("Invalid interval");
+
+	AutoPausedJit paused;
+	JitBlockCacheDebugInterface *blockCache = paused.BlockCache();
+	if (!blockCache || !blockCache->SetProfileSampleInterval((int)interval))
+		return req.Fail("Block profiling not supported by this CPU core");
+	if (reset)
+		blockCache->ResetProfileStats();
+
+	req.Respond();
+}
+
+// Stop sampling blocks (cpu.profile.stop)
+//
+// No parameters.
+//
+// Response (same event name) with no extra data.  Collected stats are kept.
+void WebSocketCPUProfileStop(DebuggerRequest &req) {
+	if (!currentDebugMIPS->isAlive()) {
+		return req.Fail("CPU not started");
+	}
+
+	AutoPausedJit paused;
+	JitBlockCacheDebugInterface *blockCache = paused.BlockCache();
+	if (blockCache)
+		blockCache->SetProfileSampleInterval(0);
+
+	req.Respond();
+}
+
+// Retrieve the hottest sampled blocks (cpu.profile.get)
+//
+// Parameters:
+//  - count: optional maximum number of blocks to return, default 100.
+//
+// Response (same event name):
+//  - blocks: array of objects, most total time first:
+//     - block: block number, for correlation only.
+//     - address: start address of the block.
+//     - size: size of the block in bytes of MIPS code.
+//     - executions: estimated number of times the block ran.
+//     - totalNanos: estimated total time spent in the block.
+//     - avgNanos: estimated time per execution.
+//     - function: start address of the containing function, or null if unknown.
+//     - functionName: optional string name of the containing function.
+void WebSocketCPUProfileGet(DebuggerRequest &req) {
+	if (!currentDebugMIPS->isAlive()) {
+		return req.Fail("CPU not started");
+	}
+
+	uint32_t count = 100;
+	if (!req.ParamU32("count", &count, false, DebuggerParamType::OPTIONAL))
+		return;
+
+	std::vector<JitBlockProfileReportEntry> report;
+	{
+		AutoPausedJit paused;
+		JitBlockCacheDebugInterface *blockCache = paused.BlockCache();
+		if (!blockCache || !blockCache->SupportsProfiling())
+			return req.Fail("Block profiling not active");
+		report = GetJitBlockProfileReport(blockCache, count);
+	}
+
+	JsonWriter &json = req.Respond();
+	WriteJitBlockProfileReport(json, report);
+}
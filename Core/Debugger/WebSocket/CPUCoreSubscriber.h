@@ -28,3 +28,6 @@ void WebSocketCPUGetAllRegs(DebuggerRequest &req);
 void WebSocketCPUGetReg(DebuggerRequest &req);
 void WebSocketCPUSetReg(DebuggerRequest &req);
 void WebSocketCPUEvaluate(DebuggerRequest &req);
+void WebSocketCPUProfileStart(DebuggerRequest &req);
+void WebSocketCPUProfileStop(DebuggerRequest &req);
+void WebSocketCPUProfileGet(DebuggerRequest &req);
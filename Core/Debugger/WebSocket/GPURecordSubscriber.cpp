@@ -51,7 +51,8 @@ WebSocketGPURecordState::~WebSocketGPURecordState() {
 
 // Begin recording (gpu.record.dump)
 //
-// No parameters.
+// Parameters:
+//  - frames: optional number of frames to record, default 1.
 //
 // Response (same event name):
 //  - uri: data: URI containing debug dump data.
@@ -62,7 +63,11 @@ void WebSocketGPURecordState::Dump(DebuggerRequest &req) {
 		return req.Fail("CPU not started");
 	}
 
-	bool result = gpuDebug->GetRecorder()->RecordNextFrame([=](const Path &filename) {
+	uint32_t frames = 1;
+	if (!req.ParamU32("frames", &frames, false, DebuggerParamType::OPTIONAL))
+		return;
+
+	bool result = gpuDebug->GetRecorder()->RecordNextFrames((int)frames, [=](const Path &filename) {
 		lastFilename_ = filename;
 		pending_ = false;
 	});
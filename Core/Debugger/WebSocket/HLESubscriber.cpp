@@ -27,6 +27,7 @@
 #include "Core/MIPS/MIPSAnalyst.h"
 #include "Core/MIPS/MIPSDebugInterface.h"
 #include "Core/MIPS/MIPSStackWalk.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HLE/sceKernelThread.h"
 #include "Core/Reporting.h"
 
@@ -42,6 +43,7 @@ DebuggerSubscriber *WebSocketHLEInit(DebuggerEventHandlerMap &map) {
 	map["hle.func.scan"] = &WebSocketHLEFuncScan;
 	map["hle.module.list"] = &WebSocketHLEModuleList;
 	map["hle.backtrace"] = &WebSocketHLEBacktrace;
+	map["hle.stats.get"] = &WebSocketHLEStatsGet;
 
 	return nullptr;
 }
@@ -598,3 +600,33 @@ void WebSocketHLEBacktrace(DebuggerRequest &req) {
 	}
 	json.pop();
 }
+
+// Retrieve syscall timings since the game started (hle.stats.get)
+//
+// Parameters:
+//  - count: optional maximum number of functions to return, default 100.
+//
+// Response (same event name):
+//  - histogramBuckets: array of the lower bound of each histogram bucket, in nanoseconds.
+//  - syscalls: array of objects, most total time first:
+//     - module: HLE module name, i.e. "IoFileMgrForUser".
+//     - name: function name.
+//     - calls: number of times it was called.
+//     - totalNanos: total time spent in the function.
+//     - avgNanos: time per call.
+//     - p50Nanos: median time per call, estimated from the histogram.
+//     - p99Nanos: 99th percentile time per call, estimated from the histogram.
+//     - maxNanos: slowest call.
+//     - histogram: array of call counts, one per bucket.
+void WebSocketHLEStatsGet(DebuggerRequest &req) {
+	if (!PSP_IsInited())
+		return req.Fail("CPU not started");
+
+	uint32_t count = 100;
+	if (!req.ParamU32("count", &count, false, DebuggerParamType::OPTIONAL))
+		return;
+
+	std::vector<HLESyscallStatsReportEntry> report = GetHLESyscallStatsReport(count);
+	JsonWriter &json = req.Respond();
+	WriteHLESyscallStatsReport(json, report);
+}
@@ -126,6 +126,27 @@ Path DirectoryFileSystem::GetLocalPath(std::string internalPath) const {
 	return basePath / internalPath;
 }
 
+// Returns the path with the case it had last time it was found, or as is if unknown.
+// The result may be stale if files were changed outside of the emulator, callers still
+// fall back to FixPathCase when it doesn't work out.
+std::string DirectoryFileSystem::CachedPathCase(const std::string &path) const {
+	if (pathCaseCache_.empty())
+		return path;
+	auto iter = pathCaseCache_.find(path);
+	return iter != pathCaseCache_.end() ? iter->second : path;
+}
+
+void DirectoryFileSystem::RememberPathCase(const std::string &requested, const std::string &fixed) {
+	if (requested != fixed)
+		pathCaseCache_[requested] = fixed;
+	else if (!pathCaseCache_.empty())
+		pathCaseCache_.erase(requested);
+}
+
+void DirectoryFileSystem::ForgetPathCases() {
+	pathCaseCache_.clear();
+}
+
 bool DirectoryFileHandle::Open(const Path &basePath, std::string &fileName, FileAccess access, u32 &error) {
 	error = 0;
 
@@ -488,6 +509,7 @@ bool DirectoryFileSystem::RmDir(const std::string &dirname) {
 	if (flags & FileSystemFlags::CASE_SENSITIVE) {
 		// Maybe we're lucky?
 		if (File::DeleteDirRecursively(fullName)) {
+			ForgetPathCases();
 			MemoryStick_NotifyWrite();
 			return (bool)ReplayApplyDisk(ReplayAction::RMDIR, true, CoreTiming::GetGlobalTimeUs());
 		}
@@ -501,6 +523,8 @@ bool DirectoryFileSystem::RmDir(const std::string &dirname) {
 	}
 
 	bool result = File::DeleteDirRecursively(fullName);
+	if (result)
+		ForgetPathCases();
 	MemoryStick_NotifyWrite();
 	return ReplayApplyDisk(ReplayAction::RMDIR, result, CoreTiming::GetGlobalTimeUs()) != 0;
 }
@@ -546,6 +570,9 @@ int DirectoryFileSystem::RenameFile(const std::string &from, const std::string &
 		}
 	}
 
+	if (retValue)
+		ForgetPathCases();
+
 	// TODO: Better error codes.
 	int result = retValue ? 0 : (int)SCE_KERNEL_ERROR_ERRNO_FILE_ALREADY_EXISTS;
 	MemoryStick_NotifyWrite();
@@ -569,6 +596,8 @@ bool DirectoryFileSystem::RemoveFile(const std::string &filename) {
 		}
 	}
 
+	if (retValue)
+		ForgetPathCases();
 	MemoryStick_NotifyWrite();
 	return ReplayApplyDisk(ReplayAction::FILE_REMOVE, retValue, CoreTiming::GetGlobalTimeUs()) != 0;
 }
@@ -577,10 +606,17 @@ int DirectoryFileSystem::OpenFile(std::string filename, FileAccess access, const
 	OpenFileEntry entry;
 	entry.hFile.fileSystemFlags_ = flags;
 	u32 err = 0;
+	const std::string requested = filename;
+	if (flags & FileSystemFlags::CASE_SENSITIVE)
+		filename = CachedPathCase(filename);
 	bool success = entry.hFile.Open(basePath, filename, (FileAccess)(access & FILEACCESS_PSP_FLAGS), err);
 	if (err == 0 && !success) {
 		err = SCE_KERNEL_ERROR_ERRNO_FILE_NOT_FOUND;
 	}
+	if (success && (flags & FileSystemFlags::CASE_SENSITIVE)) {
+		// Open may have fixed the case.
+		RememberPathCase(requested, filename);
+	}
 
 	err = ReplayApplyDisk(ReplayAction::FILE_OPEN, err, CoreTiming::GetGlobalTimeUs());
 	if (err != 0) {
@@ -694,6 +730,10 @@ PSPFileInfo DirectoryFileSystem::GetFileInfo(std::string filename) {
 	PSPFileInfo x;
 	x.name = filename;
 
+	const std::string requested = filename;
+	if (flags & FileSystemFlags::CASE_SENSITIVE)
+		filename = CachedPathCase(filename);
+
 	File::FileInfo info;
 	Path fullName = GetLocalPath(filename);
 	if (!File::GetFileInfo(fullName, &info)) {
@@ -704,6 +744,7 @@ PSPFileInfo DirectoryFileSystem::GetFileInfo(std::string filename) {
 
 			if (!File::GetFileInfo(fullName, &info))
 				return ReplayApplyDiskFileInfo(x, CoreTiming::GetGlobalTimeUs());
+			RememberPathCase(requested, filename);
 		} else {
 			return ReplayApplyDiskFileInfo(x, CoreTiming::GetGlobalTimeUs());
 		}
@@ -821,18 +862,22 @@ std::vector<PSPFileInfo> DirectoryFileSystem::GetDirListing(const std::string &p
 	std::vector<PSPFileInfo> myVector;
 
 	std::vector<File::FileInfo> files;
-	Path localPath = GetLocalPath(path);
+	const bool caseSensitive = this->flags & FileSystemFlags::CASE_SENSITIVE;
+	const std::string cachedPath = caseSensitive ? CachedPathCase(path) : path;
+	Path localPath = GetLocalPath(cachedPath);
 	const int flags = File::GETFILES_GETHIDDEN | File::GETFILES_GET_NAVIGATION_ENTRIES;
 	bool success = File::GetFilesInDir(localPath, &files, nullptr, flags);
 
-	if (this->flags & FileSystemFlags::CASE_SENSITIVE) {
+	if (caseSensitive) {
 		if (!success) {
 			// TODO: Case sensitivity should be checked on a file system basis, right?
-			std::string fixedPath = path;
+			std::string fixedPath = cachedPath;
 			if (FixPathCase(basePath, fixedPath, FPC_FILE_MUST_EXIST)) {
 				// May have failed due to case sensitivity, try again
 				localPath = GetLocalPath(fixedPath);
 				success = File::GetFilesInDir(localPath, &files, nullptr, flags);
+				if (success)
+					RememberPathCase(path, fixedPath);
 			}
 		}
 	}
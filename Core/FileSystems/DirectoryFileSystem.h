@@ -20,6 +20,7 @@
 // TODO: Remove the Windows-specific code, FILE is fine there too.
 
 #include <map>
+#include <unordered_map>
 
 #include "Common/File/Path.h"
 #include "Core/FileSystems/FileSystem.h"
@@ -101,8 +102,14 @@ class DirectoryFileSystem : public IFileSystem {
 	Path basePath;
 	IHandleAllocator *hAlloc;
 	FileSystemFlags flags;
+	// Only used when CASE_SENSITIVE. Guest path as requested to the path with the case found on disk,
+	// so FixPathCase doesn't have to scan directories every time the same path is used.
+	std::unordered_map<std::string, std::string> pathCaseCache_;
 
 	Path GetLocalPath(std::string internalPath) const;
+	std::string CachedPathCase(const std::string &path) const;
+	void RememberPathCase(const std::string &requested, const std::string &fixed);
+	void ForgetPathCases();
 };
 
 // VFSFileSystem: Ability to map in Android APK paths as well! Does not support all features, only meant for fonts.
@@ -185,6 +185,8 @@ std::string ISOFileSystem::TreeEntry::BuildPath() {
 }
 
 void ISOFileSystem::ReadDirectory(TreeEntry *root) {
+	// Children are indexed by full path as they're read, see LookupPath.
+	const std::string rootPath = EntryFullPath(root);
 	for (u32 secnum = root->startsector, endsector = root->startsector + (root->dirsize + 2047) / 2048; secnum < endsector; ++secnum) {
 		u8 theSector[2048];
 		if (!blockDevice->ReadBlock(secnum, theSector)) {
@@ -250,6 +252,8 @@ void ISOFileSystem::ReadDirectory(TreeEntry *root) {
 				}
 			}
 			root->children.push_back(entry);
+			// If a name is repeated, the first one wins, as before.
+			pathIndex_.emplace(rootPath + "/" + entry->name, entry);
 		}
 	}
 	root->valid = true;
@@ -276,47 +280,42 @@ ISOFileSystem::TreeEntry *ISOFileSystem::GetFromPath(const std::string &path, bo
 	if (pathLength <= pathIndex)
 		return treeroot;
 
-	TreeEntry *entry = treeroot;
-	while (true) {
-		if (!entry->valid) {
-			ReadDirectory(entry);
-		}
-		TreeEntry *nextEntry = nullptr;
-		std::string name = "";
-		if (pathLength > pathIndex) {
-			size_t nextSlashIndex = path.find_first_of('/', pathIndex);
-			if (nextSlashIndex == std::string::npos)
-				nextSlashIndex = pathLength;
-
-			const std::string firstPathComponent = path.substr(pathIndex, nextSlashIndex - pathIndex);
-			for (size_t i = 0; i < entry->children.size(); i++) {
-				const std::string &n = entry->children[i]->name;
-				if (firstPathComponent == n) {
-					//yay we got it
-					nextEntry = entry->children[i];
-					name = n;
-					break;
-				}
-			}
-		}
-		
-		if (nextEntry) {
-			entry = nextEntry;
-			if (!entry->valid)
-				ReadDirectory(entry);
-			pathIndex += name.length();
-			if (pathIndex < pathLength && path[pathIndex] == '/')
-				++pathIndex;
-
-			if (pathLength <= pathIndex)
-				return entry;
-		} else {
-			if (catchError)
-				ERROR_LOG(Log::FileSystem, "File '%s' not found", path.c_str());
+	// One trailing slash is fine, "a/b/" is the same as "a/b" (but "a/b//" isn't.)
+	size_t pathEnd = pathLength;
+	if (pathEnd - 1 > pathIndex && path[pathEnd - 1] == '/')
+		--pathEnd;
 
-			return 0;
-		}
+	std::string key = "/";
+	key.append(path, pathIndex, pathEnd - pathIndex);
+	TreeEntry *entry = LookupPath(key);
+	if (!entry) {
+		if (catchError)
+			ERROR_LOG(Log::FileSystem, "File '%s' not found", path.c_str());
+		return nullptr;
 	}
+
+	if (!entry->valid)
+		ReadDirectory(entry);
+	return entry;
+}
+
+ISOFileSystem::TreeEntry *ISOFileSystem::LookupPath(const std::string &key) {
+	if (key.empty())
+		return treeroot;
+
+	auto iter = pathIndex_.find(key);
+	if (iter != pathIndex_.end())
+		return iter->second;
+
+	// Not indexed yet, which is fine as long as the parent directory hasn't been read.
+	// Keys always start with a slash, so this always finds one.
+	TreeEntry *parent = LookupPath(key.substr(0, key.rfind('/')));
+	if (!parent || parent->valid)
+		return nullptr;
+
+	ReadDirectory(parent);
+	iter = pathIndex_.find(key);
+	return iter != pathIndex_.end() ? iter->second : nullptr;
 }
 
 int ISOFileSystem::OpenFile(std::string filename, FileAccess access, const char *devicename) {
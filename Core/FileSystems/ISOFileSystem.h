@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "FileSystem.h"
 
@@ -96,9 +97,12 @@ class ISOFileSystem : public IFileSystem {
 	u32 lastReadBlock_;
 
 	TreeEntry entireISO;
+	// Full path ("/DIR/FILE") to entry, for all directories read so far.
+	std::unordered_map<std::string, TreeEntry *> pathIndex_;
 
 	void ReadDirectory(TreeEntry *root);
 	TreeEntry *GetFromPath(const std::string &path, bool catchError = true);
+	TreeEntry *LookupPath(const std::string &key);
 	std::string EntryFullPath(TreeEntry *e);
 };
 
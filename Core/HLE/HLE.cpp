@@ -15,8 +15,13 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
+#include <atomic>
 #include <cstdarg>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -24,7 +29,9 @@
 
 #include "Common/Profiler/Profiler.h"
 
+#include "Common/BitScan.h"
 #include "Common/Log.h"
+#include "Common/Data/Format/JSONWriter.h"
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Common/TimeUtil.h"
 #include "Core/Config.h"
@@ -86,6 +93,30 @@ static int splitSyscallEatCycles = 0;
 static double hleSteppingTime = 0.0;
 static double hleFlipTime = 0.0;
 
+// Only the emu thread writes these, but they're read from others for reports,
+// so relaxed atomics are used just to avoid torn values.
+struct HLESyscallStats {
+	std::atomic<u64> calls;
+	std::atomic<u64> totalNanos;
+	std::atomic<u64> maxNanos;
+	std::atomic<u32> histogram[HLE_SYSCALL_HISTOGRAM_BUCKETS];
+};
+
+struct HLESyscallStatsTable {
+	std::string_view module;
+	const HLEFunction *funcTable;
+	int numFunctions;
+	int firstStat;
+};
+
+// Rebuilt in HLEInit on the emu thread, which is also the only thread recording into them.
+// Reports come from other threads (UI, debugger), so rebuilding and reporting hold this lock.
+static std::mutex syscallStatsLock;
+static std::unique_ptr<HLESyscallStats[]> syscallStats;
+static size_t syscallStatsSize = 0;
+// Sorted by funcTable, to find the stats for an HLEFunction pointer.
+static std::vector<HLESyscallStatsTable> syscallStatsTables;
+
 struct HLEMipsCallInfo {
 	u32 func;
 	PSPAction *action;
@@ -261,8 +292,35 @@ static void hleDelayResultFinish(u64 userdata, int cycleslate) {
 		WARN_LOG(Log::HLE, "Someone else woke up HLE-blocked thread %d?", threadID);
 }
 
+static void InitSyscallStats() {
+	std::lock_guard<std::mutex> guard(syscallStatsLock);
+	syscallStatsTables.clear();
+	size_t total = 0;
+	for (const HLEModule &module : moduleDB) {
+		syscallStatsTables.push_back(HLESyscallStatsTable{ module.name, module.funcTable, module.numFunctions, (int)total });
+		total += module.numFunctions;
+	}
+	std::sort(syscallStatsTables.begin(), syscallStatsTables.end(), [](const HLESyscallStatsTable &a, const HLESyscallStatsTable &b) {
+		return std::less<const HLEFunction *>()(a.funcTable, b.funcTable);
+	});
+
+	if (total > syscallStatsSize) {
+		syscallStats.reset(new HLESyscallStats[total]);
+		syscallStatsSize = total;
+	}
+	for (size_t i = 0; i < syscallStatsSize; ++i) {
+		HLESyscallStats &stats = syscallStats[i];
+		stats.calls.store(0, std::memory_order_relaxed);
+		stats.totalNanos.store(0, std::memory_order_relaxed);
+		stats.maxNanos.store(0, std::memory_order_relaxed);
+		for (auto &count : stats.histogram)
+			count.store(0, std::memory_order_relaxed);
+	}
+}
+
 void HLEInit() {
 	RegisterAllModules();
+	InitSyscallStats();
 	g_stackSize = 0;
 	delayedResultEvent = CoreTiming::RegisterEvent("HLEDelayedResult", hleDelayResultFinish);
 	idleOp = GetSyscallOp("FakeSysCalls", NID_IDLE);
@@ -835,9 +893,117 @@ static void updateSyscallStats(int modulenum, int funcnum, double total)
 	}
 }
 
+static HLESyscallStats *GetSyscallStats(const HLEFunction *info) {
+	auto iter = std::upper_bound(syscallStatsTables.begin(), syscallStatsTables.end(), info, [](const HLEFunction *f, const HLESyscallStatsTable &table) {
+		return std::less<const HLEFunction *>()(f, table.funcTable);
+	});
+	if (iter == syscallStatsTables.begin())
+		return nullptr;
+	--iter;
+	ptrdiff_t index = info - iter->funcTable;
+	if (index >= iter->numFunctions)
+		return nullptr;
+	return &syscallStats[iter->firstStat + index];
+}
+
+static void RecordSyscallTime(const HLEFunction *info, const Instant &start) {
+	HLESyscallStats *stats = GetSyscallStats(info);
+	if (!stats)
+		return;
+
+	s64 nanos = start.ElapsedNanos() - (s64)(hleFlipTime * 1000000000.0);
+	u64 n = nanos > 0 ? (u64)nanos : 0;
+
+	// Bucket 0 is < 1024 ns, then powers of two.
+	int bucket = HLE_SYSCALL_HISTOGRAM_BUCKETS - 1;
+	if (n < (1ULL << (10 + HLE_SYSCALL_HISTOGRAM_BUCKETS - 1)))
+		bucket = 32 - clz32((u32)(n >> 10));
+
+	// There's only one writer, so no need for atomic adds.
+	const auto relaxed = std::memory_order_relaxed;
+	stats->calls.store(stats->calls.load(relaxed) + 1, relaxed);
+	stats->totalNanos.store(stats->totalNanos.load(relaxed) + n, relaxed);
+	if (n > stats->maxNanos.load(relaxed))
+		stats->maxNanos.store(n, relaxed);
+	stats->histogram[bucket].store(stats->histogram[bucket].load(relaxed) + 1, relaxed);
+}
+
+u64 HLESyscallHistogramBucketStart(int bucket) {
+	return bucket <= 0 ? 0 : 1ULL << (9 + bucket);
+}
+
+u64 HLESyscallStatsPercentile(const HLESyscallStatsReportEntry &entry, double percentile) {
+	u64 target = (u64)((double)entry.calls * percentile / 100.0 + 0.5);
+	u64 seen = 0;
+	for (int i = 0; i < HLE_SYSCALL_HISTOGRAM_BUCKETS - 1; ++i) {
+		seen += entry.histogram[i];
+		if (seen >= target)
+			return std::min(HLESyscallHistogramBucketStart(i + 1), entry.maxNanos);
+	}
+	return entry.maxNanos;
+}
+
+std::vector<HLESyscallStatsReportEntry> GetHLESyscallStatsReport(size_t maxEntries) {
+	std::vector<HLESyscallStatsReportEntry> report;
+	const auto relaxed = std::memory_order_relaxed;
+	std::unique_lock<std::mutex> guard(syscallStatsLock);
+	for (const HLESyscallStatsTable &table : syscallStatsTables) {
+		for (int i = 0; i < table.numFunctions; ++i) {
+			const HLESyscallStats &stats = syscallStats[table.firstStat + i];
+			u64 calls = stats.calls.load(relaxed);
+			if (calls == 0)
+				continue;
+			HLESyscallStatsReportEntry entry{ table.module, table.funcTable[i].name, calls, stats.totalNanos.load(relaxed), stats.maxNanos.load(relaxed) };
+			for (int b = 0; b < HLE_SYSCALL_HISTOGRAM_BUCKETS; ++b)
+				entry.histogram[b] = stats.histogram[b].load(relaxed);
+			report.push_back(entry);
+		}
+	}
+	guard.unlock();
+
+	auto slower = [](const HLESyscallStatsReportEntry &a, const HLESyscallStatsReportEntry &b) {
+		return a.totalNanos > b.totalNanos;
+	};
+	if (report.size() > maxEntries) {
+		std::partial_sort(report.begin(), report.begin() + maxEntries, report.end(), slower);
+		report.resize(maxEntries);
+	} else {
+		std::sort(report.begin(), report.end(), slower);
+	}
+	return report;
+}
+
+void WriteHLESyscallStatsReport(json::JsonWriter &j, const std::vector<HLESyscallStatsReportEntry> &report) {
+	j.pushArray("histogramBuckets");
+	for (int b = 0; b < HLE_SYSCALL_HISTOGRAM_BUCKETS; ++b)
+		j.writeFloat((double)HLESyscallHistogramBucketStart(b));
+	j.pop();
+
+	j.pushArray("syscalls");
+	for (const auto &entry : report) {
+		j.pushDict();
+		j.writeString("module", std::string(entry.module));
+		j.writeString("name", entry.name ? entry.name : "");
+		j.writeFloat("calls", (double)entry.calls);
+		j.writeFloat("totalNanos", (double)entry.totalNanos);
+		j.writeFloat("avgNanos", (double)entry.totalNanos / (double)entry.calls);
+		j.writeFloat("p50Nanos", (double)HLESyscallStatsPercentile(entry, 50.0));
+		j.writeFloat("p99Nanos", (double)HLESyscallStatsPercentile(entry, 99.0));
+		j.writeFloat("maxNanos", (double)entry.maxNanos);
+		j.pushArray("histogram");
+		for (u32 count : entry.histogram)
+			j.writeUint(count);
+		j.pop();
+		j.pop();
+	}
+	j.pop();
+}
+
 static void CallSyscallWithFlags(const HLEFunction *info) {
 	// _dbg_assert_(g_stackSize == 0);
 	g_stackSize = 0;
+	hleFlipTime = 0.0;
+	const Instant start = Instant::Now();
 
 	const int stackSize = g_stackSize;
 	if (stackSize == 0) {
@@ -873,11 +1039,14 @@ static void CallSyscallWithFlags(const HLEFunction *info) {
 		SetDeadbeefRegs();
 
 	g_stackSize = 0;
+	RecordSyscallTime(info, start);
 }
 
 static void CallSyscallWithoutFlags(const HLEFunction *info) {
 	// _dbg_assert_(g_stackSize == 0);
 	g_stackSize = 0;
+	hleFlipTime = 0.0;
+	const Instant start = Instant::Now();
 
 	const int stackSize = g_stackSize;
 	if (stackSize == 0) {
@@ -898,6 +1067,7 @@ static void CallSyscallWithoutFlags(const HLEFunction *info) {
 		SetDeadbeefRegs();
 
 	g_stackSize = 0;
+	RecordSyscallTime(info, start);
 }
 
 const HLEFunction *GetSyscallFuncPointer(MIPSOpcode op) {
@@ -21,6 +21,7 @@
 #include <cstdarg>
 #include <type_traits>
 #include <string_view>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/Log.h"
@@ -186,6 +187,34 @@ const HLEFunction *GetSyscallFuncPointer(MIPSOpcode op);
 // For jit, takes arg: const HLEFunction *
 void *GetQuickSyscallFunc(MIPSOpcode op);
 
+// Per function syscall timings, always collected (except for idle.) Bucket 0 is everything
+// under 1 us, then each bucket covers twice the time of the previous one, the last one is open ended.
+enum {
+	HLE_SYSCALL_HISTOGRAM_BUCKETS = 20,
+};
+
+struct HLESyscallStatsReportEntry {
+	std::string_view module;
+	const char *name;
+	u64 calls;
+	u64 totalNanos;
+	u64 maxNanos;
+	u32 histogram[HLE_SYSCALL_HISTOGRAM_BUCKETS];
+};
+
+namespace json {
+class JsonWriter;
+}
+
+// Lower bound of a histogram bucket.
+u64 HLESyscallHistogramBucketStart(int bucket);
+// Estimate from the histogram, the upper bound of the bucket the percentile (0-100) falls in.
+u64 HLESyscallStatsPercentile(const HLESyscallStatsReportEntry &entry, double percentile);
+// Functions called since HLEInit, most total time first.
+std::vector<HLESyscallStatsReportEntry> GetHLESyscallStatsReport(size_t maxEntries);
+// Writes a "histogramBuckets" array and a "syscalls" array.
+void WriteHLESyscallStatsReport(json::JsonWriter &j, const std::vector<HLESyscallStatsReportEntry> &report);
+
 void hleDoLogInternal(Log t, LogLevel level, u64 res, const char *file, int line, const char *reportTag, const char *reason, const char *formatted_reason);
 
 template <bool leave, bool convert_code, typename T>
@@ -17,7 +17,10 @@
 
 #include <algorithm>
 
+#include "Common/Math/SIMDHeaders.h"
 #include "Common/Profiler/Profiler.h"
+#include "Common/Thread/ParallelLoop.h"
+#include "Common/Thread/ThreadManager.h"
 
 #include "Common/Serialize/SerializeFuncs.h"
 #include "Core/MemMapHelpers.h"
@@ -28,6 +31,11 @@
 #include "Core/System.h"
 #include "SasAudio.h"
 
+// Mixing voices in parallel only pays off with quite a few of them.
+static const int SAS_PARALLEL_MIN_VOICES = 8;
+static const int SAS_PARALLEL_VOICES_PER_TASK = 4;
+static const int SAS_PARALLEL_MAX_TASKS = 8;
+
 static const u8 f[16][2] = {
 	{   0,   0 },
 	{  60,   0 },
@@ -49,6 +57,260 @@ static const u8 f[16][2] = {
 	{   0, 151 },
 };
 
+// The SIMD paths must match the Generic ones bit for bit, see unittest/TestSasAudio.cpp.
+
+void SasDecodeVagNibblesGeneric(s16 *out, const u8 *data, int shift) {
+	for (int i = 0; i < 28; i += 2) {
+		u8 d = *data++;
+		out[i] = (short)((d & 0xf) << 12) >> shift;
+		out[i + 1] = (short)((d & 0xf0) << 8) >> shift;
+	}
+}
+
+void SasDecodeVagNibbles(s16 *out, const u8 *data, int shift) {
+#if PPSSPP_ARCH(SSE2)
+	// The block is only 14 bytes, don't read past it.
+	alignas(16) u8 block[16]{};
+	memcpy(block, data, 14);
+	const __m128i bytes = _mm_load_si128((const __m128i *)block);
+	const __m128i nibbleMask = _mm_set1_epi16((short)0xF000);
+	const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+
+	// Put each byte in the top of a 16-bit lane, then the low nibble is 4 bits further up.
+	__m128i lowBytes = _mm_unpacklo_epi8(_mm_setzero_si128(), bytes);
+	__m128i highBytes = _mm_unpackhi_epi8(_mm_setzero_si128(), bytes);
+	__m128i lo0 = _mm_and_si128(_mm_slli_epi16(lowBytes, 4), nibbleMask);
+	__m128i hi0 = _mm_and_si128(lowBytes, nibbleMask);
+	__m128i lo1 = _mm_and_si128(_mm_slli_epi16(highBytes, 4), nibbleMask);
+	__m128i hi1 = _mm_and_si128(highBytes, nibbleMask);
+
+	_mm_storeu_si128((__m128i *)out, _mm_sra_epi16(_mm_unpacklo_epi16(lo0, hi0), shiftCount));
+	_mm_storeu_si128((__m128i *)(out + 8), _mm_sra_epi16(_mm_unpackhi_epi16(lo0, hi0), shiftCount));
+	_mm_storeu_si128((__m128i *)(out + 16), _mm_sra_epi16(_mm_unpacklo_epi16(lo1, hi1), shiftCount));
+	_mm_storel_epi64((__m128i *)(out + 24), _mm_sra_epi16(_mm_unpackhi_epi16(lo1, hi1), shiftCount));
+#elif PPSSPP_ARCH(ARM_NEON)
+	alignas(16) u8 block[16]{};
+	memcpy(block, data, 14);
+	const uint8x16_t bytes = vld1q_u8(block);
+	// Interleave the nibbles (shifted to the top of each byte), then widen to the top of each 16-bit lane.
+	uint8x16x2_t nibbles = vzipq_u8(vshlq_n_u8(bytes, 4), vandq_u8(bytes, vdupq_n_u8(0xF0)));
+	const int16x8_t shiftCount = vdupq_n_s16((int16_t)-shift);
+	vst1q_s16(out, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(nibbles.val[0]), 8)), shiftCount));
+	vst1q_s16(out + 8, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(nibbles.val[0]), 8)), shiftCount));
+	vst1q_s16(out + 16, vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(nibbles.val[1]), 8)), shiftCount));
+	vst1_s16(out + 24, vget_low_s16(vshlq_s16(vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(nibbles.val[1]), 8)), shiftCount)));
+#else
+	SasDecodeVagNibblesGeneric(out, data, shift);
+#endif
+}
+
+void SasResampleGeneric(s16 *out, const s16 *in, u32 sampleFrac, int pitch, int count) {
+	for (int i = 0; i < count; i++) {
+		const s16 *s = in + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
+		int f = sampleFrac & PSP_SAS_PITCH_MASK;
+		out[i] = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
+		sampleFrac += pitch;
+	}
+}
+
+void SasResample(s16 *out, const s16 *in, u32 sampleFrac, int pitch, int count) {
+	int i = 0;
+	// The positions are all over the place, so the sample pairs are gathered one by one (as 32 bits),
+	// then the weights and the math are done four at a time.
+#if PPSSPP_ARCH(SSE2)
+	const __m128i mask = _mm_set1_epi32(PSP_SAS_PITCH_MASK);
+	const __m128i laneOffsets = _mm_setr_epi32(0, pitch, pitch * 2, pitch * 3);
+	for (; i + 4 <= count; i += 4) {
+		u32 pair[4];
+		for (int j = 0; j < 4; j++)
+			memcpy(&pair[j], in + ((sampleFrac + pitch * j) >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		__m128i f = _mm_and_si128(_mm_add_epi32(_mm_set1_epi32(sampleFrac), laneOffsets), mask);
+		__m128i weights = _mm_or_si128(_mm_sub_epi32(mask, f), _mm_slli_epi32(f, 16));
+		__m128i sum = _mm_madd_epi16(_mm_setr_epi32(pair[0], pair[1], pair[2], pair[3]), weights);
+		// The weights add up to less than 1.0, so this can't saturate.
+		sum = _mm_srai_epi32(sum, PSP_SAS_PITCH_BASE_SHIFT);
+		_mm_storel_epi64((__m128i *)(out + i), _mm_packs_epi32(sum, sum));
+		sampleFrac += pitch * 4;
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int offsetLanes[4] = { 0, pitch, pitch * 2, pitch * 3 };
+	const uint32x4_t laneOffsets = vreinterpretq_u32_s32(vld1q_s32(offsetLanes));
+	const uint32x4_t mask = vdupq_n_u32(PSP_SAS_PITCH_MASK);
+	for (; i + 4 <= count; i += 4) {
+		u32 pair[4];
+		for (int j = 0; j < 4; j++)
+			memcpy(&pair[j], in + ((sampleFrac + pitch * j) >> PSP_SAS_PITCH_BASE_SHIFT), 4);
+		// Deinterleave into the first and second sample of each pair.
+		int16x4x2_t s = vuzp_s16(vreinterpret_s16_u32(vld1_u32(pair)), vreinterpret_s16_u32(vld1_u32(pair + 2)));
+		uint32x4_t f = vandq_u32(vaddq_u32(vdupq_n_u32(sampleFrac), laneOffsets), mask);
+		int16x4_t w1 = vmovn_s32(vreinterpretq_s32_u32(f));
+		int16x4_t w0 = vmovn_s32(vreinterpretq_s32_u32(vsubq_u32(mask, f)));
+		int32x4_t sum = vmlal_s16(vmull_s16(s.val[0], w0), s.val[1], w1);
+		vst1_s16(out + i, vshrn_n_s32(sum, PSP_SAS_PITCH_BASE_SHIFT));
+		sampleFrac += pitch * 4;
+	}
+#endif
+	SasResampleGeneric(out + i, in, sampleFrac, pitch, count - i);
+}
+
+void SasMixSamplesGeneric(int *mixBuffer, int *sendBuffer, const s16 *samples, const int *envelope, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight) {
+	for (int i = 0; i < count; i++) {
+		// We just scale by the envelope before we scale by volumes.
+		// Again, we round up by adding (1 << 14) first (*after* multiplying.)
+		int sample = ((samples[i] * envelope[i]) + (1 << 14)) >> 15;
+
+		// We mix into this 32-bit temp buffer and clip in a second loop
+		// Ideally, the shift right should be there too but for now I'm concerned about
+		// not overflowing.
+		mixBuffer[i * 2] += (sample * volumeLeft) >> 12;
+		mixBuffer[i * 2 + 1] += (sample * volumeRight) >> 12;
+		sendBuffer[i * 2] += sample * effectLeft >> 12;
+		sendBuffer[i * 2 + 1] += sample * effectRight >> 12;
+	}
+}
+
+#if PPSSPP_ARCH(SSE2)
+static bool FitsS16(int value) {
+	return value >= -32768 && value <= 32767;
+}
+#endif
+
+void SasMixSamples(int *mixBuffer, int *sendBuffer, const s16 *samples, const int *envelope, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	// SSE2 has no 32-bit multiply, so this does everything in 16-bit multiplies. The envelope is
+	// normally within [0, 0x8000], which we split in two halves to fit. Anything above that could
+	// scale a sample past s16 (which the pack below would saturate), so it takes the slow path.
+	// Negative envelopes become huge as u32, so this one check covers both ends.
+	u32 envelopeMax = 0;
+	for (int j = 0; j < count; j++)
+		envelopeMax = std::max(envelopeMax, (u32)envelope[j]);
+	if (envelopeMax <= 0x8000 && FitsS16(volumeLeft) && FitsS16(volumeRight) && FitsS16(effectLeft) && FitsS16(effectRight)) {
+		const __m128i volumes = _mm_setr_epi16(volumeLeft, volumeRight, volumeLeft, volumeRight, volumeLeft, volumeRight, volumeLeft, volumeRight);
+		const __m128i effects = _mm_setr_epi16(effectLeft, effectRight, effectLeft, effectRight, effectLeft, effectRight, effectLeft, effectRight);
+		const __m128i round = _mm_set1_epi32(1 << 14);
+		for (; i + 4 <= count; i += 4) {
+			__m128i s = _mm_loadl_epi64((const __m128i *)(samples + i));
+			__m128i env = _mm_loadu_si128((const __m128i *)(envelope + i));
+			__m128i envHalf = _mm_srai_epi32(env, 1);
+			__m128i envParts = _mm_or_si128(envHalf, _mm_slli_epi32(_mm_sub_epi32(env, envHalf), 16));
+			// s * envHalf + s * (env - envHalf) per lane.
+			__m128i scaled = _mm_madd_epi16(_mm_unpacklo_epi16(s, s), envParts);
+			scaled = _mm_srai_epi32(_mm_add_epi32(scaled, round), 15);
+
+			// Always within s16 here. Duplicate each sample for left and right.
+			__m128i scaled16 = _mm_packs_epi32(scaled, scaled);
+			scaled16 = _mm_unpacklo_epi16(scaled16, scaled16);
+
+			__m128i lo = _mm_mullo_epi16(scaled16, volumes);
+			__m128i hi = _mm_mulhi_epi16(scaled16, volumes);
+			__m128i *mix = (__m128i *)(mixBuffer + i * 2);
+			_mm_storeu_si128(mix, _mm_add_epi32(_mm_loadu_si128(mix), _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12)));
+			_mm_storeu_si128(mix + 1, _mm_add_epi32(_mm_loadu_si128(mix + 1), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12)));
+
+			lo = _mm_mullo_epi16(scaled16, effects);
+			hi = _mm_mulhi_epi16(scaled16, effects);
+			__m128i *send = (__m128i *)(sendBuffer + i * 2);
+			_mm_storeu_si128(send, _mm_add_epi32(_mm_loadu_si128(send), _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12)));
+			_mm_storeu_si128(send + 1, _mm_add_epi32(_mm_loadu_si128(send + 1), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12)));
+		}
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int volumeLanes[4] = { volumeLeft, volumeRight, volumeLeft, volumeRight };
+	const int effectLanes[4] = { effectLeft, effectRight, effectLeft, effectRight };
+	const int32x4_t volumes = vld1q_s32(volumeLanes);
+	const int32x4_t effects = vld1q_s32(effectLanes);
+	for (; i + 4 <= count; i += 4) {
+		int32x4_t s = vmovl_s16(vld1_s16(samples + i));
+		int32x4_t scaled = vshrq_n_s32(vaddq_s32(vmulq_s32(s, vld1q_s32(envelope + i)), vdupq_n_s32(1 << 14)), 15);
+		int32x4x2_t dup = vzipq_s32(scaled, scaled);
+
+		int *mix = mixBuffer + i * 2;
+		vst1q_s32(mix, vaddq_s32(vld1q_s32(mix), vshrq_n_s32(vmulq_s32(dup.val[0], volumes), 12)));
+		vst1q_s32(mix + 4, vaddq_s32(vld1q_s32(mix + 4), vshrq_n_s32(vmulq_s32(dup.val[1], volumes), 12)));
+		int *send = sendBuffer + i * 2;
+		vst1q_s32(send, vaddq_s32(vld1q_s32(send), vshrq_n_s32(vmulq_s32(dup.val[0], effects), 12)));
+		vst1q_s32(send + 4, vaddq_s32(vld1q_s32(send + 4), vshrq_n_s32(vmulq_s32(dup.val[1], effects), 12)));
+	}
+#endif
+	SasMixSamplesGeneric(mixBuffer + i * 2, sendBuffer + i * 2, samples + i, envelope + i, count - i, volumeLeft, volumeRight, effectLeft, effectRight);
+}
+
+void SasWriteMixedOutputGeneric(s16 *outp, const s16 *inp, const int *dryBuffer, const s16 *wetBuffer, int count, int leftVol, int rightVol) {
+	for (int i = 0; i < count * 2; i += 2) {
+		int sampleL = 0;
+		int sampleR = 0;
+		if (inp) {
+			sampleL = inp[i + 0] * leftVol >> 12;
+			sampleR = inp[i + 1] * rightVol >> 12;
+		}
+		if (dryBuffer) {
+			sampleL += dryBuffer[i + 0];
+			sampleR += dryBuffer[i + 1];
+		}
+		if (wetBuffer) {
+			sampleL += wetBuffer[i + 0];
+			sampleR += wetBuffer[i + 1];
+		}
+		outp[i + 0] = clamp_s16(sampleL);
+		outp[i + 1] = clamp_s16(sampleR);
+	}
+}
+
+void SasWriteMixedOutput(s16 *outp, const s16 *inp, const int *dryBuffer, const s16 *wetBuffer, int count, int leftVol, int rightVol) {
+	int i = 0;
+#if PPSSPP_ARCH(SSE2)
+	if (!inp || (FitsS16(leftVol) && FitsS16(rightVol))) {
+		const __m128i volumes = _mm_setr_epi16(leftVol, rightVol, leftVol, rightVol, leftVol, rightVol, leftVol, rightVol);
+		// Four stereo samples at a time.
+		for (; i + 4 <= count; i += 4) {
+			__m128i sum0 = _mm_setzero_si128();
+			__m128i sum1 = _mm_setzero_si128();
+			if (inp) {
+				__m128i in = _mm_loadu_si128((const __m128i *)(inp + i * 2));
+				__m128i lo = _mm_mullo_epi16(in, volumes);
+				__m128i hi = _mm_mulhi_epi16(in, volumes);
+				sum0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 12);
+				sum1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 12);
+			}
+			if (dryBuffer) {
+				sum0 = _mm_add_epi32(sum0, _mm_loadu_si128((const __m128i *)(dryBuffer + i * 2)));
+				sum1 = _mm_add_epi32(sum1, _mm_loadu_si128((const __m128i *)(dryBuffer + i * 2 + 4)));
+			}
+			if (wetBuffer) {
+				__m128i wet = _mm_loadu_si128((const __m128i *)(wetBuffer + i * 2));
+				sum0 = _mm_add_epi32(sum0, _mm_srai_epi32(_mm_unpacklo_epi16(wet, wet), 16));
+				sum1 = _mm_add_epi32(sum1, _mm_srai_epi32(_mm_unpackhi_epi16(wet, wet), 16));
+			}
+			_mm_storeu_si128((__m128i *)(outp + i * 2), _mm_packs_epi32(sum0, sum1));
+		}
+	}
+#elif PPSSPP_ARCH(ARM_NEON)
+	const int volumeLanes[4] = { leftVol, rightVol, leftVol, rightVol };
+	const int32x4_t volumes = vld1q_s32(volumeLanes);
+	for (; i + 4 <= count; i += 4) {
+		int32x4_t sum0 = vdupq_n_s32(0);
+		int32x4_t sum1 = vdupq_n_s32(0);
+		if (inp) {
+			int16x8_t in = vld1q_s16(inp + i * 2);
+			sum0 = vshrq_n_s32(vmulq_s32(vmovl_s16(vget_low_s16(in)), volumes), 12);
+			sum1 = vshrq_n_s32(vmulq_s32(vmovl_s16(vget_high_s16(in)), volumes), 12);
+		}
+		if (dryBuffer) {
+			sum0 = vaddq_s32(sum0, vld1q_s32(dryBuffer + i * 2));
+			sum1 = vaddq_s32(sum1, vld1q_s32(dryBuffer + i * 2 + 4));
+		}
+		if (wetBuffer) {
+			int16x8_t wet = vld1q_s16(wetBuffer + i * 2);
+			sum0 = vaddw_s16(sum0, vget_low_s16(wet));
+			sum1 = vaddw_s16(sum1, vget_high_s16(wet));
+		}
+		vst1q_s16(outp + i * 2, vcombine_s16(vqmovn_s32(sum0), vqmovn_s32(sum1)));
+	}
+#endif
+	SasWriteMixedOutputGeneric(outp + i * 2, inp ? inp + i * 2 : nullptr, dryBuffer ? dryBuffer + i * 2 : nullptr, wetBuffer ? wetBuffer + i * 2 : nullptr, count - i, leftVol, rightVol);
+}
+
 void VagDecoder::Start(u32 data, u32 vagSize, bool loopEnabled) {
 	loopEnabled_ = loopEnabled;
 	loopAtNextBlock_ = false;
@@ -97,15 +359,20 @@ void VagDecoder::DecodeBlock(const u8 *&read_pointer) {
 	int coef1 = f[predict_nr][0];
 	int coef2 = -f[predict_nr][1];
 
-	// TODO: Unroll once more and interleave the unpacking with the decoding more?
-	for (int i = 0; i < 28; i += 2) {
-		u8 d = *readp++;
-		int sample1 = (short)((d & 0xf) << 12) >> shift_factor;
-		int sample2 = (short)((d & 0xf0) << 8) >> shift_factor;
-		s2 = clamp_s16(sample1 + ((s1 * coef1 + s2 * coef2) >> 6));
-		s1 = clamp_s16(sample2 + ((s2 * coef1 + s1 * coef2) >> 6));
-		samples[i] = s2;
-		samples[i + 1] = s1;
+	// The unpacking is SIMD, the filter depends on the previous sample so that's left as is.
+	SasDecodeVagNibbles(samples, readp, shift_factor);
+	readp += 14;
+	if (coef1 != 0 || coef2 != 0) {
+		for (int i = 0; i < 28; i += 2) {
+			s2 = clamp_s16(samples[i] + ((s1 * coef1 + s2 * coef2) >> 6));
+			s1 = clamp_s16(samples[i + 1] + ((s2 * coef1 + s1 * coef2) >> 6));
+			samples[i] = s2;
+			samples[i + 1] = s1;
+		}
+	} else {
+		// Without prediction the nibbles are the samples.
+		s2 = samples[26];
+		s1 = samples[27];
 	}
 
 	s_1 = s1;
@@ -375,11 +642,13 @@ SasInstance::SasInstance() {
 	memset(&waveformEffect, 0, sizeof(waveformEffect));
 	waveformEffect.type = PSP_SAS_EFFECT_TYPE_OFF;
 	waveformEffect.isDryOn = 1;
-	memset(mixTemp_, 0, sizeof(mixTemp_));  // just to avoid a static analysis warning.
+	memset(scratch_.mixTemp, 0, sizeof(scratch_.mixTemp));  // just to avoid a static analysis warning.
 }
 
 SasInstance::~SasInstance() {
 	ClearGrainSize();
+	for (SasMixWorker *worker : workers_)
+		delete worker;
 }
 
 void SasInstance::GetDebugText(char *text, size_t bufsize) {
@@ -525,7 +794,7 @@ bool SasVoice::HaveSamplesEnded() const {
 	}
 }
 
-void SasInstance::MixVoice(SasVoice &voice) {
+void SasInstance::MixVoice(SasVoice &voice, SasMixScratch &scratch, int *mixDest, int *sendDest) {
 	switch (voice.type) {
 	case VOICETYPE_VAG:
 		if (voice.type == VOICETYPE_VAG && !voice.vagAddr)
@@ -553,22 +822,23 @@ void SasInstance::MixVoice(SasVoice &voice) {
 		// TODO: Special case no-resample case (and 2x and 0.5x) for speed, it's not uncommon
 
 		// Two passes: First read, then resample.
-		mixTemp_[0] = voice.resampleHist[0];
-		mixTemp_[1] = voice.resampleHist[1];
+		int16_t *mixTemp = scratch.mixTemp;
+		mixTemp[0] = voice.resampleHist[0];
+		mixTemp[1] = voice.resampleHist[1];
 
 		int voicePitch = voice.pitch;
 		u32 sampleFrac = voice.sampleFrac;
 		int samplesToRead = (sampleFrac + voicePitch * std::max(0, grainSize - delay)) >> PSP_SAS_PITCH_BASE_SHIFT;
-		if (samplesToRead > ARRAY_SIZE(mixTemp_) - 2) {
+		if (samplesToRead > ARRAY_SIZE(scratch.mixTemp) - 2) {
 			ERROR_LOG(Log::sceSas, "Too many samples to read (%d)! This shouldn't happen.", samplesToRead);
-			samplesToRead = ARRAY_SIZE(mixTemp_) - 2;
+			samplesToRead = ARRAY_SIZE(scratch.mixTemp) - 2;
 		}
 		int readPos = 2;
 		if (voice.envelope.NeedsKeyOn()) {
 			readPos = 0;
 			samplesToRead += 2;
 		}
-		voice.ReadSamples(&mixTemp_[readPos], samplesToRead);
+		voice.ReadSamples(&mixTemp[readPos], samplesToRead);
 		int tempPos = readPos + samplesToRead;
 
 		for (int i = 0; i < delay; ++i) {
@@ -577,39 +847,28 @@ void SasInstance::MixVoice(SasVoice &voice) {
 			voice.envelope.Step();
 		}
 
+		const int count = std::max(0, grainSize - delay);
 		const bool needsInterp = voicePitch != PSP_SAS_PITCH_BASE || (sampleFrac & PSP_SAS_PITCH_MASK) != 0;
-		for (int i = delay; i < grainSize; i++) {
-			const int16_t *s = mixTemp_ + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT);
-
-			// Linear interpolation. Good enough. Need to make resampleHist bigger if we want more.
-			int sample = s[0];
-			if (needsInterp) {
-				int f = sampleFrac & PSP_SAS_PITCH_MASK;
-				sample = (s[0] * (PSP_SAS_PITCH_MASK - f) + s[1] * f) >> PSP_SAS_PITCH_BASE_SHIFT;
-			}
-			sampleFrac += voicePitch;
+		// Linear interpolation. Good enough. Need to make resampleHist bigger if we want more.
+		if (needsInterp) {
+			SasResample(scratch.resampled, mixTemp, sampleFrac, voicePitch, count);
+		} else {
+			memcpy(scratch.resampled, mixTemp + (sampleFrac >> PSP_SAS_PITCH_BASE_SHIFT), count * sizeof(s16));
+		}
+		sampleFrac += voicePitch * count;
 
+		// The envelope has to be walked one step at a time, the rest is done in bulk.
+		for (int i = 0; i < count; i++) {
 			// The maximum envelope height (PSP_SAS_ENVELOPE_HEIGHT_MAX) is (1 << 30) - 1.
 			// Reduce it to 14 bits, by shifting off 15.  Round up by adding (1 << 14) first.
-			int envelopeValue = voice.envelope.GetHeight();
+			scratch.envelope[i] = (voice.envelope.GetHeight() + (1 << 14)) >> 15;
 			voice.envelope.Step();
-			envelopeValue = (envelopeValue + (1 << 14)) >> 15;
-
-			// We just scale by the envelope before we scale by volumes.
-			// Again, we round up by adding (1 << 14) first (*after* multiplying.)
-			sample = ((sample * envelopeValue) + (1 << 14)) >> 15;
-
-			// We mix into this 32-bit temp buffer and clip in a second loop
-			// Ideally, the shift right should be there too but for now I'm concerned about
-			// not overflowing.
-			mixBuffer[i * 2] += (sample * voice.volumeLeft) >> 12;
-			mixBuffer[i * 2 + 1] += (sample * voice.volumeRight) >> 12;
-			sendBuffer[i * 2] += sample * voice.effectLeft >> 12;
-			sendBuffer[i * 2 + 1] += sample * voice.effectRight >> 12;
 		}
 
-		voice.resampleHist[0] = mixTemp_[tempPos - 2];
-		voice.resampleHist[1] = mixTemp_[tempPos - 1];
+		SasMixSamples(mixDest + delay * 2, sendDest + delay * 2, scratch.resampled, scratch.envelope, count, voice.volumeLeft, voice.volumeRight, voice.effectLeft, voice.effectRight);
+
+		voice.resampleHist[0] = mixTemp[tempPos - 2];
+		voice.resampleHist[1] = mixTemp[tempPos - 1];
 
 		voice.sampleFrac = sampleFrac - (tempPos - 2) * PSP_SAS_PITCH_BASE;
 
@@ -623,12 +882,62 @@ void SasInstance::MixVoice(SasVoice &voice) {
 	}
 }
 
-void SasInstance::Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol, bool mute) {
+bool SasInstance::MixVoicesParallel() {
+	const int numThreads = g_threadManager.GetNumLooperThreads();
+	if (numThreads < 2 || grainSize <= 0)
+		return false;
+
+	// ATRAC3 voices go through sceAtrac, so those stay on this thread.
+	int parallelVoices[PSP_SAS_VOICES_MAX];
+	int numParallel = 0;
+	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+		const SasVoice &voice = voices[v];
+		if (voice.playing && !voice.paused && voice.type != VOICETYPE_ATRAC3)
+			parallelVoices[numParallel++] = v;
+	}
+	if (numParallel < SAS_PARALLEL_MIN_VOICES)
+		return false;
+
+	const int numTasks = std::min(std::min(numThreads, SAS_PARALLEL_MAX_TASKS), numParallel / SAS_PARALLEL_VOICES_PER_TASK);
+	while ((int)workers_.size() < numTasks)
+		workers_.push_back(new SasMixWorker());
+
+	// Voices only touch their own state, and each task sums into its own buffers.
+	// Integer sums don't care about order, so this matches mixing them one by one exactly.
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		for (int t = l; t < h; t++) {
+			SasMixWorker &worker = *workers_[t];
+			memset(worker.mixBuffer, 0, grainSize * sizeof(int) * 2);
+			memset(worker.sendBuffer, 0, grainSize * sizeof(int) * 2);
+			for (int i = t; i < numParallel; i += numTasks)
+				MixVoice(voices[parallelVoices[i]], worker.scratch, worker.mixBuffer, worker.sendBuffer);
+		}
+	}, 0, numTasks, 1, TaskPriority::HIGH);
+
 	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
 		SasVoice &voice = voices[v];
-		if (!voice.playing || voice.paused)
-			continue;
-		MixVoice(voice);
+		if (voice.playing && !voice.paused && voice.type == VOICETYPE_ATRAC3)
+			MixVoice(voice);
+	}
+
+	for (int t = 0; t < numTasks; t++) {
+		const SasMixWorker &worker = *workers_[t];
+		for (int i = 0; i < grainSize * 2; i++) {
+			mixBuffer[i] += worker.mixBuffer[i];
+			sendBuffer[i] += worker.sendBuffer[i];
+		}
+	}
+	return true;
+}
+
+void SasInstance::Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol, bool mute) {
+	if (!g_Config.bParallelSasMix || !MixVoicesParallel()) {
+		for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+			SasVoice &voice = voices[v];
+			if (!voice.playing || voice.paused)
+				continue;
+			MixVoice(voice);
+		}
 	}
 
 	// Apply mute if needed (note: we try to keep everything else identical to the non-muted case).
@@ -678,51 +987,7 @@ void SasInstance::WriteMixedOutput(s16 *outp, const s16 *inp, int leftVol, int r
 		ApplyWaveformEffect();
 	}
 
-	if (inp) {
-		for (int i = 0; i < grainSize * 2; i += 2) {
-			int sampleL = ((*inp++) * leftVol >> 12);
-			int sampleR = ((*inp++) * rightVol >> 12);
-			if (dry) {
-				sampleL += mixBuffer[i + 0];
-				sampleR += mixBuffer[i + 1];
-			}
-			if (wet) {
-				sampleL += sendBufferProcessed[i + 0];
-				sampleR += sendBufferProcessed[i + 1];
-			}
-			*outp++ = clamp_s16(sampleL);
-			*outp++ = clamp_s16(sampleR);
-		}
-	} else {
-		// These are the optimal cases.
-		if (dry && wet) {
-			for (int i = 0; i < grainSize * 2; i += 2) {
-				*outp++ = clamp_s16(mixBuffer[i + 0] + sendBufferProcessed[i + 0]);
-				*outp++ = clamp_s16(mixBuffer[i + 1] + sendBufferProcessed[i + 1]);
-			}
-		} else if (dry) {
-			for (int i = 0; i < grainSize * 2; i += 2) {
-				*outp++ = clamp_s16(mixBuffer[i + 0]);
-				*outp++ = clamp_s16(mixBuffer[i + 1]);
-			}
-		} else {
-			// This is another uncommon case, dry must be off but let's keep it for clarity.
-			for (int i = 0; i < grainSize * 2; i += 2) {
-				int sampleL = 0;
-				int sampleR = 0;
-				if (dry) {
-					sampleL += mixBuffer[i + 0];
-					sampleR += mixBuffer[i + 1];
-				}
-				if (wet) {
-					sampleL += sendBufferProcessed[i + 0];
-					sampleR += sendBufferProcessed[i + 1];
-				}
-				*outp++ = clamp_s16(sampleL);
-				*outp++ = clamp_s16(sampleR);
-			}
-		}
-	}
+	SasWriteMixedOutput(outp, inp, dry ? mixBuffer : nullptr, wet ? sendBufferProcessed : nullptr, grainSize, leftVol, rightVol);
 }
 
 void SasInstance::SetWaveformEffectType(int type) {
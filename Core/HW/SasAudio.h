@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "Common/CommonTypes.h"
 #include "Core/HW/BufferQueue.h"
 #include "Core/HW/SasReverb.h"
@@ -294,6 +296,21 @@ struct SasVoice {
 	SasAtrac3 atrac3;
 };
 
+// Per thread temporary buffers for mixing a voice.
+struct SasMixScratch {
+	int16_t mixTemp[PSP_SAS_MAX_GRAIN * 4 + 2 + 16];  // some extra margin for very high pitches.
+	// After resampling, and the envelope values to scale them by.
+	alignas(16) int16_t resampled[PSP_SAS_MAX_GRAIN];
+	alignas(16) int envelope[PSP_SAS_MAX_GRAIN];
+};
+
+// A worker's share of the voices when mixing in parallel, summed up afterwards.
+struct SasMixWorker {
+	SasMixScratch scratch;
+	alignas(16) int mixBuffer[PSP_SAS_MAX_GRAIN * 2];
+	alignas(16) int sendBuffer[PSP_SAS_MAX_GRAIN * 2];
+};
+
 class SasInstance {
 public:
 	SasInstance();
@@ -316,7 +333,9 @@ class SasInstance {
 	FILE *audioDump = nullptr;
 
 	void Mix(u32 outAddr, u32 inAddr, int leftVol, int rightVol, bool mute);
-	void MixVoice(SasVoice &voice);
+	void MixVoice(SasVoice &voice) {
+		MixVoice(voice, scratch_, mixBuffer, sendBuffer);
+	}
 
 	// Applies reverb to send buffer, according to waveformEffect.
 	void ApplyWaveformEffect();
@@ -332,8 +351,27 @@ class SasInstance {
 
 private:
 	SasReverb reverb_;
+	void MixVoice(SasVoice &voice, SasMixScratch &scratch, int *mixDest, int *sendDest);
+	// Spreads the voices over worker threads, returns false if it's not worth it.
+	bool MixVoicesParallel();
+
 	int grainSize = 0;
-	int16_t mixTemp_[PSP_SAS_MAX_GRAIN * 4 + 2 + 16];  // some extra margin for very high pitches.
+	SasMixScratch scratch_;
+	std::vector<SasMixWorker *> workers_;
 };
 
+// The inner loops of the mixer, SIMD where available. The Generic versions are the reference.
+// Decodes the 28 nibbles of a VAG block (14 bytes), before prediction.
+void SasDecodeVagNibbles(s16 *out, const u8 *data, int shift);
+void SasDecodeVagNibblesGeneric(s16 *out, const u8 *data, int shift);
+// Linear interpolation at a 0.12 fixed point position and step. Reads in[] one past the last position.
+void SasResample(s16 *out, const s16 *in, u32 sampleFrac, int pitch, int count);
+void SasResampleGeneric(s16 *out, const s16 *in, u32 sampleFrac, int pitch, int count);
+// Scales samples by the envelope, then accumulates into the stereo mix and send buffers.
+void SasMixSamples(int *mixBuffer, int *sendBuffer, const s16 *samples, const int *envelope, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight);
+void SasMixSamplesGeneric(int *mixBuffer, int *sendBuffer, const s16 *samples, const int *envelope, int count, int volumeLeft, int volumeRight, int effectLeft, int effectRight);
+// Sums the scaled input and the dry/wet buffers (any may be null) and clamps, count stereo samples.
+void SasWriteMixedOutput(s16 *outp, const s16 *inp, const int *dryBuffer, const s16 *wetBuffer, int count, int leftVol, int rightVol);
+void SasWriteMixedOutputGeneric(s16 *outp, const s16 *inp, const int *dryBuffer, const s16 *wetBuffer, int count, int leftVol, int rightVol);
+
 const char *ADSRCurveModeAsString(SasADSRCurveMode mode);
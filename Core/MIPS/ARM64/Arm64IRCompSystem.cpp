@@ -159,6 +159,15 @@ void Arm64JitBackend::CompIR_Breakpoint(IRInst inst) {
 			// We need to flush, or conditions and log expressions will see old register values.
 			FlushAll();
 
+			// Most accesses aren't on a page with any memchecks, skip the range compares for those.
+			MOVP2R(SCRATCH2_64, g_breakpoints.GetMemCheckPageBitmap(isWrite));
+			LSR(W0, SCRATCH1, BreakpointManager::MEMCHECK_PAGE_SHIFT + 5);
+			LDR(W0, SCRATCH2_64, ArithOption(X0, true));
+			LSR(W1, SCRATCH1, BreakpointManager::MEMCHECK_PAGE_SHIFT);
+			LSRV(W0, W0, W1);
+			ANDI2R(W0, W0, 1);
+			FixupBranch noPage = CBZ(W0);
+
 			std::vector<FixupBranch> hitChecks;
 			for (auto it : memchecks) {
 				if (it.end != 0) {
@@ -193,6 +202,7 @@ void Arm64JitBackend::CompIR_Breakpoint(IRInst inst) {
 			}
 
 			SetJumpTarget(noHits);
+			SetJumpTarget(noPage);
 		}
 		break;
 
@@ -160,6 +160,9 @@ class Arm64IRJit : public IRNativeJit {
 		: IRNativeJit(mipsState), arm64Backend_(jo, blocks_) {
 		Init(arm64Backend_);
 	}
+	~Arm64IRJit() {
+		ShutdownAsyncCompile();
+	}
 
 private:
 	Arm64JitBackend arm64Backend_;
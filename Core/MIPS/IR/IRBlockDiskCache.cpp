@@ -0,0 +1,220 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <cstring>
+
+#include "ext/xxhash.h"
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Core/Config.h"
+#include "Core/MemMap.h"
+#include "Core/MIPS/IR/IRBlockDiskCache.h"
+#include "Core/MIPS/IR/IRJit.h"
+
+namespace MIPSComp {
+
+static const u32 CACHE_HEADER_MAGIC = 0x43424952;  // "IRBC"
+// Bump this when the file format changes. Frontend changes are caught by the version string hash.
+static const u32 CACHE_VERSION = 2;
+
+// Keep the file reasonably sized, and don't let overlays at one address pile up forever.
+static const u32 MAX_CACHE_ENTRIES = 0x40000;
+static const u32 MAX_CACHE_INSTRUCTIONS = 0x400000;
+static const size_t MAX_VARIANTS_PER_ADDRESS = 4;
+
+struct IRBlockDiskCacheHeader {
+	u32 magic;
+	u32 version;
+	u64 buildHash;
+	u32 optionsHash;
+	u32 instSize;
+	u32 numEntries;
+	u32 numInstructions;
+};
+
+void IRBlockDiskCache::Init(const Path &filename, const IROptions &opts) {
+	Shutdown();
+
+	filename_ = filename;
+	fastMemory_ = g_Config.bFastMemory;
+	optionsHash_ = OptionsHash(opts);
+
+	FILE *f = File::OpenCFile(filename_, "rb");
+	if (!f)
+		return;
+	bool success = LoadCache(f);
+	fclose(f);
+
+	if (!success) {
+		WARN_LOG(Log::JIT, "Incompatible or corrupt IR block cache, rebuilding");
+		entries_.clear();
+		arena_.clear();
+		byAddress_.clear();
+		File::Delete(filename_);
+	} else {
+		INFO_LOG(Log::JIT, "Loaded IR block cache: %d blocks, %d instructions", (int)entries_.size(), (int)arena_.size());
+	}
+}
+
+void IRBlockDiskCache::Shutdown() {
+	if (!filename_.empty() && dirty_) {
+		FILE *f = File::OpenCFile(filename_, "wb");
+		if (f) {
+			if (!SaveCache(f)) {
+				ERROR_LOG(Log::JIT, "Failed to write IR block cache, disk full?");
+			} else {
+				INFO_LOG(Log::JIT, "Saved IR block cache: %d blocks, %d instructions", (int)entries_.size(), (int)arena_.size());
+			}
+			fclose(f);
+		}
+	}
+
+	filename_.clear();
+	dirty_ = false;
+	entries_.clear();
+	arena_.clear();
+	arena_.shrink_to_fit();
+	byAddress_.clear();
+}
+
+bool IRBlockDiskCache::IsActive() const {
+	// Fast memory can be toggled while running, which only clears the jit. Stop using the cache then.
+	return !filename_.empty() && g_Config.bFastMemory == fastMemory_;
+}
+
+u32 IRBlockDiskCache::OptionsHash(const IROptions &opts) const {
+	// Avoid hashing padding. Besides the options, the IR passes only read fast memory from the config,
+	// to decide whether to validate addresses (see ApplyMemoryValidation.)
+	u32 values[7] = {
+		opts.disableFlags,
+		opts.unalignedLoadStore,
+		opts.unalignedLoadStoreVec4,
+		opts.preferVec4,
+		opts.preferVec4Dot,
+		opts.optimizeForInterpreter,
+		fastMemory_,
+	};
+	return XXH32(values, sizeof(values), 0);
+}
+
+bool IRBlockDiskCache::LoadCache(FILE *f) {
+	IRBlockDiskCacheHeader header{};
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != CACHE_HEADER_MAGIC) {
+		WARN_LOG(Log::JIT, "IR block cache magic mismatch");
+		return false;
+	}
+	if (header.version != CACHE_VERSION || header.instSize != (u32)sizeof(IRInst)) {
+		WARN_LOG(Log::JIT, "IR block cache version mismatch, %d, expected %d", header.version, CACHE_VERSION);
+		return false;
+	}
+	if (header.buildHash != XXH3_64bits(PPSSPP_GIT_VERSION, strlen(PPSSPP_GIT_VERSION))) {
+		INFO_LOG(Log::JIT, "IR block cache is from a different build");
+		return false;
+	}
+	if (header.optionsHash != optionsHash_) {
+		INFO_LOG(Log::JIT, "IR block cache was made with different IR options");
+		return false;
+	}
+	if (header.numEntries > MAX_CACHE_ENTRIES || header.numInstructions > MAX_CACHE_INSTRUCTIONS) {
+		return false;
+	}
+
+	entries_.resize(header.numEntries);
+	arena_.resize(header.numInstructions);
+	if (header.numEntries != 0 && fread(&entries_[0], sizeof(Entry), header.numEntries, f) != header.numEntries) {
+		ERROR_LOG(Log::JIT, "IR block cache truncated (in entries)");
+		return false;
+	}
+	if (header.numInstructions != 0 && fread(&arena_[0], sizeof(IRInst), header.numInstructions, f) != header.numInstructions) {
+		ERROR_LOG(Log::JIT, "IR block cache truncated (in instructions)");
+		return false;
+	}
+
+	for (int i = 0; i < (int)entries_.size(); ++i) {
+		const Entry &entry = entries_[i];
+		if (entry.numInstructions == 0 || entry.arenaOffset + entry.numInstructions > header.numInstructions || entry.arenaOffset + entry.numInstructions < entry.arenaOffset) {
+			ERROR_LOG(Log::JIT, "IR block cache entry %d out of range", i);
+			return false;
+		}
+		byAddress_[entry.addr].push_back(i);
+	}
+	return true;
+}
+
+bool IRBlockDiskCache::SaveCache(FILE *f) {
+	IRBlockDiskCacheHeader header{};
+	header.magic = CACHE_HEADER_MAGIC;
+	header.version = CACHE_VERSION;
+	header.buildHash = XXH3_64bits(PPSSPP_GIT_VERSION, strlen(PPSSPP_GIT_VERSION));
+	header.optionsHash = optionsHash_;
+	header.instSize = (u32)sizeof(IRInst);
+	header.numEntries = (u32)entries_.size();
+	header.numInstructions = (u32)arena_.size();
+
+	bool writeFailed = fwrite(&header, sizeof(header), 1, f) != 1;
+	if (!entries_.empty())
+		writeFailed = writeFailed || fwrite(&entries_[0], sizeof(Entry), entries_.size(), f) != entries_.size();
+	if (!arena_.empty())
+		writeFailed = writeFailed || fwrite(&arena_[0], sizeof(IRInst), arena_.size(), f) != arena_.size();
+	return !writeFailed;
+}
+
+bool IRBlockDiskCache::Lookup(u32 em_address, u32 compileFlags, std::vector<IRInst> &instructions, u32 &mipsBytes) {
+	auto iter = byAddress_.find(em_address);
+	if (iter == byAddress_.end())
+		return false;
+
+	for (int i : iter->second) {
+		const Entry &entry = entries_[i];
+		if (entry.compileFlags != compileFlags || !Memory::IsValidRange(entry.addr, entry.origSize))
+			continue;
+		if (IRBlock::CalculateCodeHash(entry.addr, entry.origSize) != entry.hash)
+			continue;
+
+		instructions.assign(arena_.begin() + entry.arenaOffset, arena_.begin() + entry.arenaOffset + entry.numInstructions);
+		mipsBytes = entry.origSize;
+		return true;
+	}
+	return false;
+}
+
+void IRBlockDiskCache::Add(u32 em_address, u32 mipsBytes, u32 compileFlags, const std::vector<IRInst> &instructions) {
+	if (instructions.empty() || !Memory::IsValidRange(em_address, mipsBytes))
+		return;
+	if (entries_.size() >= MAX_CACHE_ENTRIES || arena_.size() + instructions.size() > MAX_CACHE_INSTRUCTIONS)
+		return;
+
+	std::vector<int> &variants = byAddress_[em_address];
+	if (variants.size() >= MAX_VARIANTS_PER_ADDRESS)
+		return;
+
+	Entry entry;
+	entry.addr = em_address;
+	entry.origSize = mipsBytes;
+	entry.hash = IRBlock::CalculateCodeHash(em_address, mipsBytes);
+	entry.compileFlags = compileFlags;
+	entry.arenaOffset = (u32)arena_.size();
+	entry.numInstructions = (u32)instructions.size();
+	entry.reserved = 0;
+
+	arena_.insert(arena_.end(), instructions.begin(), instructions.end());
+	variants.push_back((int)entries_.size());
+	entries_.push_back(entry);
+	dirty_ = true;
+}
+
+}  // namespace MIPSComp
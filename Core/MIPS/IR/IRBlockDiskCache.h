@@ -0,0 +1,69 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
+#include "Core/MIPS/IR/IRInst.h"
+
+namespace MIPSComp {
+
+// Persistent cache of frontend output (simplified IR), stored per game ID.
+// Blocks are found by start address and only reused if the hash of the MIPS code still matches,
+// so overlays and self-modifying code simply miss. Native code is not cached, only the IR.
+class IRBlockDiskCache {
+public:
+	void Init(const Path &filename, const IROptions &opts);
+	void Shutdown();
+
+	bool IsActive() const;
+
+	// Fills in instructions and mipsBytes if there's a valid entry for the code currently at em_address.
+	bool Lookup(u32 em_address, u32 compileFlags, std::vector<IRInst> &instructions, u32 &mipsBytes);
+	void Add(u32 em_address, u32 mipsBytes, u32 compileFlags, const std::vector<IRInst> &instructions);
+
+private:
+	struct Entry {
+		u32 addr;
+		u32 origSize;
+		u64 hash;
+		u32 compileFlags;
+		u32 arenaOffset;
+		u32 numInstructions;
+		u32 reserved;
+	};
+
+	bool LoadCache(FILE *f);
+	bool SaveCache(FILE *f);
+	u32 OptionsHash(const IROptions &opts) const;
+
+	Path filename_;
+	u32 optionsHash_ = 0;
+	bool fastMemory_ = false;
+	bool dirty_ = false;
+
+	std::vector<Entry> entries_;
+	std::vector<IRInst> arena_;
+	std::unordered_map<u32, std::vector<int>> byAddress_;
+};
+
+}  // namespace MIPSComp
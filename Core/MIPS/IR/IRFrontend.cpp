@@ -30,6 +30,7 @@
 #include "Core/MIPS/IR/IRInterpreter.h"
 #include "Core/MIPS/MIPSTracer.h"
 
+#include <algorithm>
 #include <iterator>
 
 namespace MIPSComp {
@@ -117,6 +118,15 @@ void IRFrontend::CompileDelaySlot() {
 	js.inDelaySlot = false;
 }
 
+u32 IRFrontend::GetCompileFlags() const {
+	u32 flags = 0;
+	if (js.startDefaultPrefix)
+		flags |= 1;
+	if (js.hasSetRounding)
+		flags |= 2;
+	return flags;
+}
+
 bool IRFrontend::CheckRounding(u32 blockAddress) {
 	bool cleanSlate = false;
 	if (js.hasSetRounding && !js.lastSetRounding) {
@@ -141,6 +151,8 @@ bool IRFrontend::CheckRounding(u32 blockAddress) {
 
 void IRFrontend::Comp_ReplacementFunc(MIPSOpcode op) {
 	int index = op.encoding & MIPS_EMUHACK_VALUE_MASK;
+	// Depends on breakpoints and hook flags, not just the code.
+	usedReplacement_ = true;
 
 	const ReplacementTableEntry *entry = GetReplacementFunc(index);
 	if (!entry) {
@@ -239,7 +251,23 @@ MIPSOpcode IRFrontend::GetOffsetInstruction(int offset) {
 	return Memory::Read_Instruction(GetCompilerPC() + 4 * offset);
 }
 
-void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes) {
+bool IRFrontend::ContinueTrace(u32 targetAddr) {
+	if (!traceTargets_ || !js.compiling || js.cancel || js.numInstructions >= MAX_TRACE_INSTRUCTIONS)
+		return false;
+	// Only go forward, past the delay slot, so traces can't loop and the range stays contiguous.
+	if (targetAddr < GetCompilerPC() + 8 || targetAddr - js.blockStart >= MAX_TRACE_BYTES)
+		return false;
+	if (std::find(traceTargets_->begin(), traceTargets_->end(), targetAddr) == traceTargets_->end())
+		return false;
+	if (!Memory::IsValidAddress(targetAddr))
+		return false;
+
+	// DoJit() steps past this to the target.
+	js.compilerPC = targetAddr - 4;
+	return true;
+}
+
+void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, const std::vector<u32> *traceTargets) {
 	js.cancel = false;
 	js.blockStart = em_address;
 	js.compilerPC = em_address;
@@ -255,6 +283,10 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 	js.PrefixStart();
 	ir.Clear();
 
+	const u8 hadSetRounding = js.hasSetRounding;
+	usedReplacement_ = false;
+	traceTargets_ = mipsTracer.tracing_enabled ? nullptr : traceTargets;
+
 	js.numInstructions = 0;
 	while (js.compiling) {
 		// Jit breakpoints are quite fast, so let's do them in release too.
@@ -272,7 +304,13 @@ void IRFrontend::DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &m
 		ir.Clear();
 	}
 
+	// Traces only jump forward, so this covers all of them too.
 	mipsBytes = js.compilerPC - em_address;
+	traceTargets_ = nullptr;
+
+	// If this block changed the rounding or prefix state, CheckRounding() will want a do-over anyway.
+	lastBlockReusable_ = !js.cancel && !js.hadBreakpoints && !usedReplacement_ && !mipsTracer.tracing_enabled;
+	lastBlockReusable_ = lastBlockReusable_ && js.hasSetRounding == hadSetRounding && !(js.startDefaultPrefix && js.MayHavePrefix());
 
 	IRWriter simplified;
 	IRWriter *code = &ir;
@@ -89,7 +89,21 @@ class IRFrontend : public MIPSFrontendInterface {
 	void DoState(PointerWrap &p);
 	bool CheckRounding(u32 blockAddress);  // returns true if we need a do-over
 
-	void DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes);
+	// If traceTargets is set, branches to those addresses are compiled inline (forward only), making
+	// a superblock with side exits.  The block's range then covers everything in between.
+	void DoJit(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes, const std::vector<u32> *traceTargets = nullptr);
+
+	// Limits for trace formation, so traces stay cheap to invalidate and recompile.
+	static constexpr u32 MAX_TRACE_BYTES = 0x400;
+	static constexpr int MAX_TRACE_INSTRUCTIONS = 256;
+
+	// Frontend state, beyond the MIPS code itself, that the generated IR depends on.
+	u32 GetCompileFlags() const;
+	// True if the last DoJit() result depends only on the MIPS code and GetCompileFlags(),
+	// so it's safe to reuse for identical code (see IRBlockDiskCache.)
+	bool LastBlockReusable() const {
+		return lastBlockReusable_;
+	}
 
 	void EatPrefix() override {
 		js.EatPrefix();
@@ -112,6 +126,9 @@ class IRFrontend : public MIPSFrontendInterface {
 	void EatInstruction(MIPSOpcode op);
 	MIPSOpcode GetOffsetInstruction(int offset);
 
+	// Returns true and continues compiling at targetAddr if it's part of the trace.
+	bool ContinueTrace(u32 targetAddr);
+
 	void CheckBreakpoint(u32 addr);
 	void CheckMemoryBreakpoint(int rs, int offset);
 
@@ -141,6 +158,10 @@ class IRFrontend : public MIPSFrontendInterface {
 
 	int dontLogBlocks = 0;
 	int logBlocks = 0;
+
+	bool usedReplacement_ = false;
+	bool lastBlockReusable_ = false;
+	const std::vector<u32> *traceTargets_ = nullptr;
 };
 
 }  // namespace
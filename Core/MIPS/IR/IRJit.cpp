@@ -18,17 +18,22 @@
 #include "ppsspp_config.h"
 #include <set>
 #include <algorithm>
+#include <climits>
 
 #include "ext/xxhash.h"
 #include "Common/Profiler/Profiler.h"
 
 #include "Common/Log.h"
+#include "Common/File/FileUtil.h"
 #include "Common/Serialize/Serializer.h"
 #include "Common/StringUtils.h"
 
 #include "Core/Config.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/System.h"
+#include "Core/Debugger/Breakpoints.h"
+#include "Core/ELF/ParamSFO.h"
 #include "Core/HLE/sceKernelMemory.h"
 #include "Core/MemMap.h"
 #include "Core/MIPS/MIPS.h"
@@ -75,9 +80,21 @@ IRJit::IRJit(MIPSState *mipsState, bool actualJit) : frontend_(mipsState->HasDef
 #endif
 	opts.optimizeForInterpreter = jo.optimizeForInterpreter;
 	frontend_.SetOptions(opts);
+
+	// Only the IR interpreter comes back to the dispatcher for every block, native code is linked directly.
+	traceFormation_ = g_Config.bIRTraceFormation && !actualJit;
+	if (traceFormation_)
+		ResetTraceEdges();
+
+	std::string discID = g_paramSFO.GetDiscID();
+	if (g_Config.bIRBlockCache && !discID.empty()) {
+		File::CreateFullPath(GetSysDirectory(DIRECTORY_APP_CACHE));
+		diskCache_.Init(GetSysDirectory(DIRECTORY_APP_CACHE) / (discID + ".irblockcache"), opts);
+	}
 }
 
 IRJit::~IRJit() {
+	diskCache_.Shutdown();
 }
 
 void IRJit::DoState(PointerWrap &p) {
@@ -90,6 +107,38 @@ void IRJit::UpdateFCR31() {
 void IRJit::ClearCache() {
 	INFO_LOG(Log::JIT, "IRJit: Clearing the block cache!");
 	blocks_.Clear();
+	if (traceFormation_) {
+		ResetTraceEdges();
+		traceTargets_.clear();
+	}
+}
+
+void IRJit::ResetTraceEdges() {
+	traceEdges_.assign(1 << TRACE_EDGE_BITS, TraceEdge{ 0xFFFFFFFF, 0, 0 });
+}
+
+void IRJit::FormTrace(u32 arenaOffset, u32 targetAddr) {
+	if (mipsTracer.tracing_enabled)
+		return;
+
+	int block_num = blocks_.GetBlockNumFromIRArenaOffset(arenaOffset);
+	IRBlock *block = blocks_.GetBlock(block_num);
+	if (!block || !block->IsValid())
+		return;
+
+	// The frontend can only inline forward branches, so don't bother recompiling for others.
+	u32 start = block->GetOriginalStart();
+	if (targetAddr <= start || targetAddr - start >= IRFrontend::MAX_TRACE_BYTES)
+		return;
+	std::vector<u32> &targets = traceTargets_[start];
+	if (targets.size() >= MAX_TRACE_TARGETS || std::find(targets.begin(), targets.end(), targetAddr) != targets.end())
+		return;
+	targets.push_back(targetAddr);
+
+	DEBUG_LOG(Log::JIT, "Forming trace at %08x through %08x", start, targetAddr);
+	// Not running now, so just drop it and let the dispatcher compile it again.
+	blocks_.RemoveBlockFromPageLookup(block_num);
+	block->Destroy(block->GetIRArenaOffset());
 }
 
 void IRJit::InvalidateCacheAt(u32 em_address, int length) {
@@ -116,6 +165,14 @@ void IRJit::Compile(u32 em_address) {
 
 	PROFILE_THIS_SCOPE("jitc");
 
+	// Nothing from the arena is running right now, so this is a good time to reclaim invalidated blocks.
+	if (blocks_.NeedsCompaction() && !mipsTracer.tracing_enabled) {
+		blocks_.Compact();
+		// Counts are by arena offset, which just changed.
+		if (traceFormation_)
+			ResetTraceEdges();
+	}
+
 	std::vector<IRInst> instructions;
 	u32 mipsBytes;
 	if (!CompileBlock(em_address, instructions, mipsBytes)) {
@@ -132,12 +189,32 @@ void IRJit::Compile(u32 em_address) {
 	}
 }
 
+void IRJit::TranslateBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes) {
+	const std::vector<u32> *traceTargets = nullptr;
+	if (traceFormation_) {
+		auto it = traceTargets_.find(em_address);
+		if (it != traceTargets_.end())
+			traceTargets = &it->second;
+	}
+
+	// Breakpoints are compiled into the IR, so don't reuse anything while they're active.
+	// Traces depend on runtime counts, so those aren't cached either.
+	bool useDiskCache = diskCache_.IsActive() && !g_breakpoints.HasBreakPoints() && !g_breakpoints.HasMemChecks() && !mipsTracer.tracing_enabled && !traceTargets;
+	u32 compileFlags = frontend_.GetCompileFlags();
+	if (!useDiskCache || !diskCache_.Lookup(em_address, compileFlags, instructions, mipsBytes)) {
+		frontend_.DoJit(em_address, instructions, mipsBytes, traceTargets);
+		if (useDiskCache && frontend_.LastBlockReusable()) {
+			diskCache_.Add(em_address, mipsBytes, compileFlags, instructions);
+		}
+	}
+	_dbg_assert_(!instructions.empty());
+}
+
 // WARNING! This can be called from IRInterpret / the JIT, through the function preload stuff!
 bool IRJit::CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes) {
 	_dbg_assert_(compilerEnabled_);
 
-	frontend_.DoJit(em_address, instructions, mipsBytes);
-	_dbg_assert_(!instructions.empty());
+	TranslateBlock(em_address, instructions, mipsBytes);
 
 	int block_num = blocks_.AllocateBlock(em_address, mipsBytes, instructions);
 	if ((block_num & ~MIPS_EMUHACK_VALUE_MASK) != 0) {
@@ -204,7 +281,11 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 				block->profileStats_.executions += 1;
 				block->profileStats_.totalNanos += elapsedNanos;
 #else
-				mips->pc = IRInterpret(mips, instPtr);
+				if (!blocks_.ProfileCountdown()) {
+					mips->pc = IRInterpret(mips, instPtr);
+				} else {
+					mips->pc = InterpretSampled(offset, instPtr);
+				}
 #endif
 				// Note: this will "jump to zero" on a badly constructed block missing exits.
 				if (!Memory::IsValid4AlignedAddress(mips->pc)) {
@@ -213,6 +294,9 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 					Core_ExecException(mips->pc, block->GetOriginalStart(), ExecExceptionType::JUMP);
 					break;
 				}
+				if (traceFormation_) {
+					CountTraceEdge(offset, mips->pc);
+				}
 			} else {
 				// RestoreRoundingMode(true);
 #ifdef _DEBUG
@@ -233,6 +317,19 @@ void IRJit::RunLoopUntil(u64 globalticks) {
 	// RestoreRoundingMode(true);
 }
 
+u32 IRJit::InterpretSampled(u32 arenaOffset, const IRInst *inst) {
+	blocks_.RestartProfileCountdown();
+	if (blocks_.GetProfileSampleInterval() <= 0)
+		return IRInterpret(mips_, inst);
+
+	// Blocks may be added while running (preload), so only look it up by number afterward.
+	int blockNum = blocks_.GetBlockNumFromIRArenaOffset(arenaOffset);
+	Instant start = Instant::Now();
+	u32 pc = IRInterpret(mips_, inst);
+	blocks_.AddProfileSample(blockNum, start.ElapsedNanos());
+	return pc;
+}
+
 bool IRJit::DescribeCodePtr(const u8 *ptr, std::string &name) {
 	// Used in native disassembly viewer.
 	return false;
@@ -252,13 +349,30 @@ void IRBlockCache::Clear() {
 		blocks_[i].Destroy(cookie);
 	}
 	blocks_.clear();
-	byPage_.clear();
+	byPage_.Clear();
 	arena_.clear();
 	arena_.shrink_to_fit();
+	deadInstructions_ = 0;
 }
 
 IRBlockCache::IRBlockCache(bool compileToNative) : compileToNative_(compileToNative) {}
 
+bool IRBlockCache::SetProfileSampleInterval(int interval) {
+	// Only the IR interpreter goes through the dispatcher for every block.
+	if (compileToNative_)
+		return false;
+	profileSampleInterval_ = std::max(interval, 0);
+	// Otherwise, a countdown left huge while not sampling would delay the first sample a long time.
+	RestartProfileCountdown();
+	return true;
+}
+
+void IRBlockCache::ResetProfileStats() {
+	for (IRBlock &b : blocks_) {
+		b.profileStats_ = JitBlockProfileStats{};
+	}
+}
+
 int IRBlockCache::AllocateBlock(int emAddr, u32 origSize, const std::vector<IRInst> &insts) {
 	// We have 24 bits to represent offsets with.
 	const u32 MAX_ARENA_SIZE = 0x1000000 - 1;
@@ -317,17 +431,13 @@ std::vector<int> IRBlockCache::FindInvalidatedBlockNumbers(u32 address, u32 leng
 
 	std::vector<int> found;
 	for (u32 page = startPage; page <= endPage; ++page) {
-		const auto iter = byPage_.find(page);
-		if (iter == byPage_.end())
-			continue;
-
-		const std::vector<int> &blocksInPage = iter->second;
-		for (int i : blocksInPage) {
+		byPage_.ForEach(page, [&](int i) {
 			if (blocks_[i].OverlapsRange(address, lengthInBytes)) {
 				// We now try to remove these during invalidation.
 				found.push_back(i);
 			}
-		}
+			return true;
+		});
 	}
 
 	return found;
@@ -346,11 +456,12 @@ void IRBlockCache::FinalizeBlock(int blockIndex) {
 	u32 endPage = AddressToPage(startAddr + size);
 
 	for (u32 page = startPage; page <= endPage; ++page) {
-		byPage_[page].push_back(blockIndex);
+		byPage_.Add(page, blockIndex);
 	}
 }
 
-// Call after Destroy-ing it.
+// Call before Destroy-ing it: Destroy clears the start address, which both the page range and the
+// dead instruction count (IsValid()) rely on. Calling it on an already destroyed block is harmless.
 void IRBlockCache::RemoveBlockFromPageLookup(int blockIndex) {
 	// We need to remove the block from the byPage lookup.
 	IRBlock &block = blocks_[blockIndex];
@@ -362,15 +473,17 @@ void IRBlockCache::RemoveBlockFromPageLookup(int blockIndex) {
 	u32 endPage = AddressToPage(startAddr + size);
 
 	for (u32 page = startPage; page <= endPage; ++page) {
-		auto iter = std::find(byPage_[page].begin(), byPage_[page].end(), blockIndex);
-		if (iter != byPage_[page].end()) {
-			byPage_[page].erase(iter);
-		} else if (block.IsValid()) {
+		if (!byPage_.Remove(page, blockIndex) && block.IsValid()) {
 			// If it was previously invalidated, we don't care, hence the above check.
 			WARN_LOG(Log::JIT, "RemoveBlock: Block at %08x was not found where expected in byPage table.", startAddr);
 		}
 	}
 
+	// Might be called again for an already invalidated block, only count it once.
+	if (block.IsValid()) {
+		deadInstructions_ += block.GetNumIRInstructions();
+	}
+
 	// Additionally, we'd like to zap the block in the IR arena.
 	// However, this breaks if calling sceKernelIcacheClearAll(), since as soon as we return, we'll be executing garbage.
 	/*
@@ -386,22 +499,177 @@ u32 IRBlockCache::AddressToPage(u32 addr) const {
 	return (addr & 0x3FFFFFFF) >> 10;
 }
 
-int IRBlockCache::FindPreloadBlock(u32 em_address) {
-	u32 page = AddressToPage(em_address);
-	auto iter = byPage_.find(page);
-	if (iter == byPage_.end())
-		return -1;
+bool IRBlockCache::NeedsCompaction() const {
+	// Not worth moving things around for small amounts, and only when at least half is garbage.
+	const u32 MIN_COMPACT_SIZE = 0x40000;
+	return arena_.size() >= MIN_COMPACT_SIZE && deadInstructions_ * 2 >= arena_.size();
+}
 
-	const std::vector<int> &blocksInPage = iter->second;
-	for (int i : blocksInPage) {
-		if (blocks_[i].GetOriginalStart() == em_address) {
-			if (blocks_[i].HashMatches()) {
-				return i;
+void IRBlockCache::Compact() {
+	PROFILE_THIS_SCOPE("jitcompact");
+
+	size_t oldSize = arena_.size();
+	std::vector<IRInst> newArena;
+	newArena.reserve(oldSize - deadInstructions_);
+
+	if (compileToNative_) {
+		// Block numbers are shared with the native backend, so keep all blocks and only drop dead IR.
+		// Native offsets are used as cookies here, so the emuhacks stay as they are.
+		for (IRBlock &b : blocks_) {
+			u32 offset = (u32)newArena.size();
+			if (b.IsValid()) {
+				const IRInst *inst = GetBlockInstructionPtr(b);
+				newArena.insert(newArena.end(), inst, inst + b.GetNumIRInstructions());
+				b.SetIRArenaRange(offset, b.GetNumIRInstructions());
+			} else {
+				b.SetIRArenaRange(offset, 0);
 			}
 		}
+		arena_.swap(newArena);
+	} else {
+		// The cookies are arena offsets, so we have to unpatch everything first.
+		std::vector<IRBlock> newBlocks;
+		for (IRBlock &b : blocks_) {
+			// If the game overwrote the first op behind our back, the block is garbage anyway.
+			if (!b.IsValid() || !b.RestoreOriginalFirstOp(b.GetIRArenaOffset()))
+				continue;
+
+			const IRInst *inst = GetBlockInstructionPtr(b);
+			u32 offset = (u32)newArena.size();
+			newArena.insert(newArena.end(), inst, inst + b.GetNumIRInstructions());
+			b.SetIRArenaRange(offset, b.GetNumIRInstructions());
+			newBlocks.push_back(std::move(b));
+		}
+		arena_.swap(newArena);
+		blocks_.swap(newBlocks);
+
+		// Offsets are still rising, so GetBlockNumFromIRArenaOffset() keeps working.
+		byPage_.Clear();
+		for (int i = 0; i < (int)blocks_.size(); ++i) {
+			FinalizeBlock(i);
+		}
 	}
 
-	return -1;
+	deadInstructions_ = 0;
+	INFO_LOG(Log::JIT, "Compacted IR arena from %d to %d instructions (%d blocks)", (int)oldSize, (int)arena_.size(), (int)blocks_.size());
+}
+
+void IRBlockPageIndex::Clear() {
+	slots_.clear();
+	nodes_.clear();
+	freeNode_ = -1;
+	usedSlots_ = 0;
+}
+
+static inline u32 HashPage(u32 page) {
+	return page * 0x9E3779B1;
+}
+
+// Pages are at most 20 bits, so this can't collide with a real page.
+static const u32 EMPTY_PAGE_SLOT = 0xFFFFFFFF;
+
+int IRBlockPageIndex::FindSlot(u32 page) const {
+	if (slots_.empty())
+		return -1;
+	u32 mask = (u32)slots_.size() - 1;
+	for (u32 i = HashPage(page) & mask; ; i = (i + 1) & mask) {
+		if (slots_[i].page == page)
+			return (int)i;
+		if (slots_[i].page == EMPTY_PAGE_SLOT)
+			return -1;
+	}
+}
+
+int IRBlockPageIndex::FindOrAddSlot(u32 page) {
+	// Keep the load factor under 3/4. Slots are never removed, emptied pages just keep an empty list.
+	if ((usedSlots_ + 1) * 4 > (int)slots_.size() * 3)
+		Grow();
+	u32 mask = (u32)slots_.size() - 1;
+	for (u32 i = HashPage(page) & mask; ; i = (i + 1) & mask) {
+		if (slots_[i].page == page)
+			return (int)i;
+		if (slots_[i].page == EMPTY_PAGE_SLOT) {
+			slots_[i].page = page;
+			usedSlots_++;
+			return (int)i;
+		}
+	}
+}
+
+void IRBlockPageIndex::Grow() {
+	std::vector<Slot> oldSlots;
+	oldSlots.swap(slots_);
+	slots_.resize(oldSlots.empty() ? 1024 : oldSlots.size() * 2, Slot{ EMPTY_PAGE_SLOT, -1, -1 });
+
+	u32 mask = (u32)slots_.size() - 1;
+	for (const Slot &slot : oldSlots) {
+		if (slot.page == EMPTY_PAGE_SLOT)
+			continue;
+		u32 i = HashPage(slot.page) & mask;
+		while (slots_[i].page != EMPTY_PAGE_SLOT)
+			i = (i + 1) & mask;
+		slots_[i] = slot;
+	}
+}
+
+void IRBlockPageIndex::Add(u32 page, int blockNum) {
+	int n = freeNode_;
+	if (n != -1) {
+		freeNode_ = nodes_[n].next;
+	} else {
+		n = (int)nodes_.size();
+		nodes_.push_back(Node{});
+	}
+	nodes_[n].blockNum = blockNum;
+	nodes_[n].next = -1;
+
+	Slot &slot = slots_[FindOrAddSlot(page)];
+	if (slot.tail == -1) {
+		slot.head = n;
+	} else {
+		nodes_[slot.tail].next = n;
+	}
+	slot.tail = n;
+}
+
+bool IRBlockPageIndex::Remove(u32 page, int blockNum) {
+	int s = FindSlot(page);
+	if (s < 0)
+		return false;
+
+	Slot &slot = slots_[s];
+	int prev = -1;
+	for (int n = slot.head; n != -1; prev = n, n = nodes_[n].next) {
+		if (nodes_[n].blockNum != blockNum)
+			continue;
+
+		if (prev == -1) {
+			slot.head = nodes_[n].next;
+		} else {
+			nodes_[prev].next = nodes_[n].next;
+		}
+		if (slot.tail == n)
+			slot.tail = prev;
+
+		nodes_[n].next = freeNode_;
+		freeNode_ = n;
+		return true;
+	}
+	return false;
+}
+
+int IRBlockCache::FindPreloadBlock(u32 em_address) {
+	u32 page = AddressToPage(em_address);
+
+	int found = -1;
+	byPage_.ForEach(page, [&](int i) {
+		if (blocks_[i].GetOriginalStart() == em_address && blocks_[i].HashMatches()) {
+			found = i;
+			return false;
+		}
+		return true;
+	});
+	return found;
 }
 
 int IRBlockCache::FindByCookie(int cookie) {
@@ -512,20 +780,16 @@ void IRBlockCache::ComputeStats(BlockCacheStats &bcStats) const {
 int IRBlockCache::GetBlockNumberFromStartAddress(u32 em_address, bool realBlocksOnly) const {
 	u32 page = AddressToPage(em_address);
 
-	const auto iter = byPage_.find(page);
-	if (iter == byPage_.end())
-		return -1;
-
-	const std::vector<int> &blocksInPage = iter->second;
 	int best = -1;
-	for (int i : blocksInPage) {
+	byPage_.ForEach(page, [&](int i) {
 		if (blocks_[i].GetOriginalStart() == em_address) {
 			best = i;
 			if (blocks_[i].IsValid()) {
-				return i;
+				return false;
 			}
 		}
-	}
+		return true;
+	});
 	return best;
 }
 
@@ -572,21 +836,25 @@ void IRBlock::Destroy(int cookie) {
 
 u64 IRBlock::CalculateHash() const {
 	if (origAddr_) {
-		// This is unfortunate. In case there are emuhacks, we have to make a copy.
-		// If we could hash while reading we could avoid this.
-		std::vector<u32> buffer;
-		buffer.resize(origSize_ / 4);
-		size_t pos = 0;
-		for (u32 off = 0; off < origSize_; off += 4) {
-			// Let's actually hash the replacement, if any.
-			MIPSOpcode instr = Memory::ReadUnchecked_Instruction(origAddr_ + off, false);
-			buffer[pos++] = instr.encoding;
-		}
-		return XXH3_64bits(&buffer[0], origSize_);
+		return CalculateCodeHash(origAddr_, origSize_);
 	}
 	return 0;
 }
 
+u64 IRBlock::CalculateCodeHash(u32 origAddr, u32 origSize) {
+	// This is unfortunate. In case there are emuhacks, we have to make a copy.
+	// If we could hash while reading we could avoid this.
+	std::vector<u32> buffer;
+	buffer.resize(origSize / 4);
+	size_t pos = 0;
+	for (u32 off = 0; off < origSize; off += 4) {
+		// Let's actually hash the replacement, if any.
+		MIPSOpcode instr = Memory::ReadUnchecked_Instruction(origAddr + off, false);
+		buffer[pos++] = instr.encoding;
+	}
+	return XXH3_64bits(buffer.data(), origSize);
+}
+
 bool IRBlock::OverlapsRange(u32 addr, u32 size) const {
 	addr &= 0x3FFFFFFF;
 	u32 origAddr = origAddr_ & 0x3FFFFFFF;
@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <climits>
 #include <cstring>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/CPUDetect.h"
@@ -27,6 +29,7 @@
 #include "Core/MIPS/IR/IRRegCache.h"
 #include "Core/MIPS/IR/IRInst.h"
 #include "Core/MIPS/IR/IRFrontend.h"
+#include "Core/MIPS/IR/IRBlockDiskCache.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
 
 #ifndef offsetof
@@ -34,7 +37,7 @@
 #endif
 
 // Very expensive, time-profiles every block.
-// Not to be released with this enabled.
+// Not to be released with this enabled. For normal builds, see IRBlockCache::SetProfileSampleInterval().
 //
 // #define IR_PROFILING
 
@@ -45,7 +48,7 @@
 
 namespace MIPSComp {
 
-// TODO : Use arena allocators. For now let's just malloc.
+// The IR itself lives in IRBlockCache's arena, the block only knows its range there.
 class IRBlock {
 public:
 	IRBlock() {}
@@ -59,12 +62,17 @@ class IRBlock {
 		origFirstOpcode_ = b.origFirstOpcode_;
 		nativeOffset_ = b.nativeOffset_;
 		numIRInstructions_ = b.numIRInstructions_;
+		profileStats_ = b.profileStats_;
 		b.arenaOffset_ = 0xFFFFFFFF;
 	}
 
 	~IRBlock() {}
 
 	u32 GetIRArenaOffset() const { return arenaOffset_; }
+	void SetIRArenaRange(u32 offset, u32 numInstructions) {
+		arenaOffset_ = offset;
+		numIRInstructions_ = numInstructions;
+	}
 	int GetNumIRInstructions() const { return numIRInstructions_; }
 	MIPSOpcode GetOriginalFirstOp() const { return origFirstOpcode_; }
 	bool HasOriginalFirstOp() const;
@@ -94,13 +102,13 @@ class IRBlock {
 	u64 GetHash() const {
 		return hash_;
 	}
+	static u64 CalculateCodeHash(u32 origAddr, u32 origSize);
 
 	void Finalize(int number);
 	void Destroy(int number);
 
-#ifdef IR_PROFILING
+	// Filled in by IR_PROFILING, or estimated by the sampling profiler.
 	JitBlockProfileStats profileStats_{};
-#endif
 
 private:
 	u64 CalculateHash() const;
@@ -116,6 +124,47 @@ class IRBlock {
 	u32 numIRInstructions_ = 0;
 };
 
+// Maps pages to the blocks overlapping them. Open addressed, with the per-page lists
+// kept in a shared node pool (with a free list) so invalidation churn doesn't fragment.
+class IRBlockPageIndex {
+public:
+	void Clear();
+	void Add(u32 page, int blockNum);
+	bool Remove(u32 page, int blockNum);
+
+	// Calls func(blockNum) in insertion order, stopping early if it returns false.
+	template <typename F>
+	void ForEach(u32 page, F func) const {
+		int slot = FindSlot(page);
+		if (slot < 0)
+			return;
+		for (int n = slots_[slot].head; n != -1; n = nodes_[n].next) {
+			if (!func(nodes_[n].blockNum))
+				break;
+		}
+	}
+
+private:
+	struct Slot {
+		u32 page;
+		int head;
+		int tail;
+	};
+	struct Node {
+		int blockNum;
+		int next;
+	};
+
+	int FindSlot(u32 page) const;
+	int FindOrAddSlot(u32 page);
+	void Grow();
+
+	std::vector<Slot> slots_;
+	std::vector<Node> nodes_;
+	int freeNode_ = -1;
+	int usedSlots_ = 0;
+};
+
 class IRBlockCache : public JitBlockCacheDebugInterface {
 public:
 	IRBlockCache(bool compileToNative);
@@ -137,6 +186,11 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 	}
 	void RemoveBlockFromPageLookup(int blockNum);
 	int GetBlockNumFromIRArenaOffset(int offset) const;
+
+	// Drops the IR of invalidated blocks (and in IR interpreter mode, the blocks themselves.)
+	// Moves IR around, so must only be called when nothing from the arena is executing.
+	bool NeedsCompaction() const;
+	void Compact();
 	const IRInst *GetBlockInstructionPtr(const IRBlock &block) const {
 		return arena_.data() + block.GetIRArenaOffset();
 	}
@@ -178,11 +232,7 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 		return meta;
 	}
 	JitBlockProfileStats GetBlockProfileStats(int blockNum) const override {
-#ifdef IR_PROFILING
 		return blocks_[blockNum].profileStats_;
-#else
-		return JitBlockProfileStats{};
-#endif
 	}
 	void ComputeStats(BlockCacheStats &bcStats) const override;
 	int GetBlockNumberFromStartAddress(u32 em_address, bool realBlocksOnly = true) const override;
@@ -191,16 +241,43 @@ class IRBlockCache : public JitBlockCacheDebugInterface {
 #ifdef IR_PROFILING
 		return true;
 #else
-		return false;
+		return profileSampleInterval_ != 0;
 #endif
 	}
 
+	bool SetProfileSampleInterval(int interval) override;
+	void ResetProfileStats() override;
+	int GetProfileSampleInterval() const {
+		return profileSampleInterval_;
+	}
+	// Counts down dispatches, true when the next one should be sampled.  Almost free when not sampling,
+	// since the countdown is then huge.
+	bool ProfileCountdown() {
+		return --profileCountdown_ <= 0;
+	}
+	void RestartProfileCountdown() {
+		profileCountdown_ = profileSampleInterval_ > 0 ? profileSampleInterval_ : INT_MAX;
+	}
+	// Each sample stands for interval dispatches, so scale up to estimate the totals.
+	void AddProfileSample(int blockNum, int64_t elapsedNanos) {
+		IRBlock *block = GetBlock(blockNum);
+		if (block) {
+			block->profileStats_.executions += profileSampleInterval_;
+			block->profileStats_.totalNanos += elapsedNanos * profileSampleInterval_;
+		}
+	}
+
 private:
 	u32 AddressToPage(u32 addr) const;
 	bool compileToNative_;
 	std::vector<IRBlock> blocks_;
 	std::vector<IRInst> arena_;
-	std::unordered_map<u32, std::vector<int>> byPage_;
+	IRBlockPageIndex byPage_;
+	// IR instructions belonging to invalidated blocks, reclaimed by Compact().
+	u32 deadInstructions_ = 0;
+	int profileSampleInterval_ = 0;
+	// Dispatches until the next profiler sample, see IRJit::InterpretSampled().
+	int profileCountdown_ = 0;
 };
 
 class IRJit : public JitInterface {
@@ -240,7 +317,25 @@ class IRJit : public JitInterface {
 	void UnlinkBlock(u8 *checkedEntry, u32 originalAddress) override;
 
 protected:
+	// Runs the frontend (or fetches the result from the disk cache), without allocating a block.
+	void TranslateBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes);
 	bool CompileBlock(u32 em_address, std::vector<IRInst> &instructions, u32 &mipsBytes);
+	u32 InterpretSampled(u32 arenaOffset, const IRInst *inst);
+
+	// Trace formation counts dispatches from each block to each next PC.  When one gets hot,
+	// the block is recompiled with the target inlined (see IRFrontend::DoJit.)
+	void CountTraceEdge(u32 arenaOffset, u32 pc) {
+		TraceEdge &edge = traceEdges_[((arenaOffset ^ (pc >> 2)) * 0x9E3779B1) >> (32 - TRACE_EDGE_BITS)];
+		if (edge.arenaOffset != arenaOffset || edge.pc != pc) {
+			edge.arenaOffset = arenaOffset;
+			edge.pc = pc;
+			edge.count = 1;
+		} else if (edge.count < TRACE_HOT_COUNT && ++edge.count == TRACE_HOT_COUNT) {
+			FormTrace(arenaOffset, pc);
+		}
+	}
+	void FormTrace(u32 arenaOffset, u32 targetAddr);
+	void ResetTraceEdges();
 	virtual bool CompileNativeBlock(IRBlockCache *irBlockCache, int block_num) { return true; }
 	virtual void FinalizeNativeBlock(IRBlockCache *irBlockCache, int block_num) {}
 
@@ -250,11 +345,27 @@ class IRJit : public JitInterface {
 
 	IRFrontend frontend_;
 	IRBlockCache blocks_;
+	IRBlockDiskCache diskCache_;
 
 	MIPSState *mips_;
 
 	bool compilerEnabled_ = true;
 
+	struct TraceEdge {
+		u32 arenaOffset;
+		u32 pc;
+		u32 count;
+	};
+	static constexpr int TRACE_EDGE_BITS = 12;
+	static constexpr u32 TRACE_HOT_COUNT = 1000;
+	static constexpr size_t MAX_TRACE_TARGETS = 4;
+
+	bool traceFormation_ = false;
+	// Direct mapped, a collision just restarts the count.
+	std::vector<TraceEdge> traceEdges_;
+	// Hot targets by block start address, kept across recompiles.
+	std::unordered_map<u32, std::vector<u32>> traceTargets_;
+
 	// where to write branch-likely trampolines. not used atm
 	// u32 blTrampolines_;
 	// int blTrampolineCount_;
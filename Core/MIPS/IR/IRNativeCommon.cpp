@@ -18,13 +18,18 @@
 #include <atomic>
 #include <climits>
 #include <thread>
+#include "Common/MemoryUtil.h"
 #include "Common/Profiler/Profiler.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Common/TimeUtil.h"
+#include "Core/Config.h"
 #include "Core/Core.h"
 #include "Core/Debugger/SymbolMap.h"
 #include "Core/MemMap.h"
 #include "Core/MIPS/MIPSTables.h"
+#include "Core/MIPS/MIPSTracer.h"
+#include "Core/MIPS/IR/IRInterpreter.h"
 #include "Core/MIPS/IR/IRNativeCommon.h"
 
 using namespace MIPSComp;
@@ -487,6 +492,13 @@ IRNativeJit::IRNativeJit(MIPSState *mipsState)
 void IRNativeJit::Init(IRNativeBackend &backend) {
 	backend_ = &backend;
 	debugInterface_.Init(backend_);
+
+	// The task writes code while the emu thread runs other code from the same space, so this needs
+	// the space to stay writable, and an icache flush that other cores see.
+#if PPSSPP_ARCH(X86) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(ARM64)
+	asyncCompile_ = g_Config.bIRAsyncCompile && !PlatformIsWXExclusive() && g_threadManager.IsInitialized();
+#endif
+	backend_->SetAsyncCompile(asyncCompile_);
 	backend_->GenerateFixedCode(mips_);
 
 	// Wanted this to be a reference, but vtbls get in the way.  Shouldn't change.
@@ -515,6 +527,174 @@ void IRNativeJit::FinalizeNativeBlock(IRBlockCache *irblockCache, int block_num)
 	backend_->FinalizeBlock(irblockCache, block_num, jo);
 }
 
+class IRNativeCompileTask : public Task {
+public:
+	IRNativeCompileTask(IRNativeJit *jit) : jit_(jit) {}
+
+	TaskType Type() const override { return TaskType::CPU_COMPUTE; }
+	TaskPriority Priority() const override { return TaskPriority::HIGH; }
+
+	void Run() override {
+		jit_->RunAsyncCompiles();
+	}
+
+private:
+	IRNativeJit *jit_;
+};
+
+void IRNativeJit::Compile(u32 em_address) {
+	if (!asyncCompile_ || mipsTracer.tracing_enabled) {
+		// Native code must be emitted in block order, so finish anything queued first.
+		WaitForAsyncCompiles();
+		if (!InstallAsyncBlocks())
+			ClearCache();
+		IRJit::Compile(em_address);
+		return;
+	}
+
+	PROFILE_THIS_SCOPE("jitc");
+
+	if (!InstallAsyncBlocks()) {
+		ERROR_LOG(Log::JIT, "Ran out of space in background compile, clearing cache");
+		ClearCache();
+	}
+
+	auto it = asyncPending_.find(em_address);
+	if (it == asyncPending_.end()) {
+		// Maybe it was just installed, then we're done and the dispatcher will find it.
+		// Replacements and hooks are emuhacks too, but those still need a block.
+		if (Memory::IsValid4AlignedAddress(em_address) && MIPS_IS_RUNBLOCK(Memory::ReadUnchecked_U32(em_address)))
+			return;
+
+		if (!QueueAsyncBlock(em_address)) {
+			ERROR_LOG(Log::JIT, "Ran out of block numbers, clearing cache");
+			ClearCache();
+			QueueAsyncBlock(em_address);
+		}
+		it = asyncPending_.find(em_address);
+		if (it == asyncPending_.end()) {
+			// Rounding assumptions changed and the cache was cleared, compile it normally instead.
+			IRJit::Compile(em_address);
+			return;
+		}
+	}
+
+	// Not ready yet, so run it once through the interpreter.  The dispatcher comes back here after.
+	const IRInst *instPtr = blocks_.GetBlockInstructionPtr(it->second);
+	mips_->pc = IRInterpret(mips_, instPtr);
+	if (!Memory::IsValid4AlignedAddress(mips_->pc)) {
+		Core_ExecException(mips_->pc, em_address, ExecExceptionType::JUMP);
+	}
+}
+
+bool IRNativeJit::QueueAsyncBlock(u32 em_address) {
+	std::vector<IRInst> instructions;
+	u32 mipsBytes;
+	TranslateBlock(em_address, instructions, mipsBytes);
+
+	if (frontend_.CheckRounding(em_address)) {
+		// Our assumptions are all wrong so it's clean-slate time.
+		ClearCache();
+		return true;
+	}
+
+	int block_num;
+	{
+		std::lock_guard<std::mutex> guard(compileLock_);
+		// Invalidated blocks are dropped from asyncPending_ but may still be queued or waiting to be
+		// installed, and compacting would pull their IR out from under the task.  So wait until idle.
+		if (asyncPending_.empty() && blocks_.NeedsCompaction() && AsyncCompileIdle())
+			blocks_.Compact();
+
+		block_num = blocks_.AllocateBlock(em_address, mipsBytes, instructions);
+		if ((block_num & ~MIPS_EMUHACK_VALUE_MASK) != 0) {
+			WARN_LOG(Log::JIT, "Failed to allocate block for %08x (%d instructions)", em_address, (int)instructions.size());
+			return false;
+		}
+		// Checked again before installing, in case the code changed without an invalidate.
+		blocks_.GetBlock(block_num)->UpdateHash();
+	}
+	asyncPending_[em_address] = block_num;
+
+	std::lock_guard<std::mutex> guard(asyncQueueLock_);
+	asyncQueue_.push_back(block_num);
+	if (!asyncTaskRunning_) {
+		asyncTaskRunning_ = true;
+		g_threadManager.EnqueueTask(new IRNativeCompileTask(this));
+	}
+	return true;
+}
+
+void IRNativeJit::RunAsyncCompiles() {
+	while (true) {
+		int block_num;
+		{
+			std::lock_guard<std::mutex> guard(asyncQueueLock_);
+			if (asyncQueue_.empty()) {
+				asyncTaskRunning_ = false;
+				// Notify under the lock, since the jit may be destroyed as soon as a waiter sees this.
+				asyncIdleCond_.notify_all();
+				return;
+			}
+			block_num = asyncQueue_.front();
+			asyncQueue_.pop_front();
+		}
+
+		bool success;
+		{
+			std::lock_guard<std::mutex> guard(compileLock_);
+			success = backend_->CompileBlock(&blocks_, block_num);
+		}
+
+		std::lock_guard<std::mutex> guard(asyncQueueLock_);
+		asyncDone_.emplace_back(block_num, success);
+	}
+}
+
+bool IRNativeJit::InstallAsyncBlocks() {
+	std::vector<std::pair<int, bool>> done;
+	{
+		std::lock_guard<std::mutex> guard(asyncQueueLock_);
+		if (asyncDone_.empty())
+			return true;
+		done.swap(asyncDone_);
+	}
+
+	bool success = true;
+	std::lock_guard<std::mutex> guard(compileLock_);
+	for (const auto &[block_num, compiled] : done) {
+		IRBlock *block = blocks_.GetBlock(block_num);
+		auto it = asyncPending_.find(block->GetOriginalStart());
+		bool current = it != asyncPending_.end() && it->second == block_num;
+		if (current)
+			asyncPending_.erase(it);
+
+		if (!compiled) {
+			success = false;
+		} else if (current && block->HashMatches()) {
+			blocks_.FinalizeBlock(block_num);
+			FinalizeNativeBlock(&blocks_, block_num);
+		}
+		// Otherwise it was invalidated while compiling, the code is just left unused.
+	}
+	return success;
+}
+
+bool IRNativeJit::AsyncCompileIdle() {
+	std::lock_guard<std::mutex> guard(asyncQueueLock_);
+	return asyncQueue_.empty() && asyncDone_.empty() && !asyncTaskRunning_;
+}
+
+void IRNativeJit::WaitForAsyncCompiles() {
+	std::unique_lock<std::mutex> guard(asyncQueueLock_);
+	asyncIdleCond_.wait(guard, [&] { return !asyncTaskRunning_; });
+}
+
+void IRNativeJit::ShutdownAsyncCompile() {
+	WaitForAsyncCompiles();
+	asyncCompile_ = false;
+}
+
 void IRNativeJit::RunLoopUntil(u64 globalticks) {
 	if constexpr (enableDebugStats || enableDebugProfiler) {
 		LogDebugStats();
@@ -525,10 +705,25 @@ void IRNativeJit::RunLoopUntil(u64 globalticks) {
 }
 
 void IRNativeJit::ClearCache() {
+	WaitForAsyncCompiles();
+	asyncPending_.clear();
+	asyncDone_.clear();
+
 	IRJit::ClearCache();
 	backend_->ClearAllBlocks();
 }
 
+void IRNativeJit::InvalidateCacheAt(u32 em_address, int length) {
+	std::lock_guard<std::mutex> guard(compileLock_);
+	for (auto it = asyncPending_.begin(); it != asyncPending_.end(); ) {
+		if (blocks_.GetBlock(it->second)->OverlapsRange(em_address, length))
+			it = asyncPending_.erase(it);
+		else
+			++it;
+	}
+	IRJit::InvalidateCacheAt(em_address, length);
+}
+
 bool IRNativeJit::DescribeCodePtr(const u8 *ptr, std::string &name) {
 	if (ptr != nullptr && backend_->DescribeCodePtr(ptr, name))
 		return true;
@@ -545,7 +740,10 @@ bool IRNativeJit::DescribeCodePtr(const u8 *ptr, std::string &name) {
 		if (b_start > offset)
 			continue;
 
-		int b_end = backend_->GetNativeBlock(i)->checkedOffset;
+		const IRNativeBlock *nativeBlock = backend_->GetNativeBlock(i);
+		if (!nativeBlock)
+			continue;
+		int b_end = nativeBlock->checkedOffset;
 		int b_offset = offset - b_start;
 		if (b_end > b_start && b_end >= offset) {
 			// For sure within the block.
@@ -600,6 +798,7 @@ const u8 *IRNativeJit::GetCrashHandler() const {
 }
 
 void IRNativeJit::UpdateFCR31() {
+	std::lock_guard<std::mutex> guard(compileLock_);
 	backend_->UpdateFCR31(mips_);
 }
 
@@ -729,12 +928,19 @@ JitBlockProfileStats IRNativeBlockCacheDebugInterface::GetBlockProfileStats(int
 
 void IRNativeBlockCacheDebugInterface::GetBlockCodeRange(int blockNum, int *startOffset, int *size) const {
 	int blockOffset = irBlocks_.GetBlock(blockNum)->GetNativeOffset();
-	int endOffset = backend_->GetNativeBlock(blockNum)->checkedOffset;
+	const IRNativeBlock *nativeBlock = backend_->GetNativeBlock(blockNum);
+	if (blockOffset < 0 || !nativeBlock) {
+		// Still being compiled in the background.
+		*startOffset = 0;
+		*size = 0;
+		return;
+	}
+	int endOffset = nativeBlock->checkedOffset;
 
 	// If endOffset is before, the checked entry is before the block start.
 	if (endOffset < blockOffset) {
 		// We assume linear allocation.  Maybe a bit dangerous, should always be right.
-		if (blockNum + 1 >= GetNumBlocks()) {
+		if (blockNum + 1 >= GetNumBlocks() || irBlocks_.GetBlock(blockNum + 1)->GetNativeOffset() < 0) {
 			// Last block, get from current code pointer.
 			endOffset = (int)codeBlock_->GetOffset(codeBlock_->GetCodePtr());
 		} else {
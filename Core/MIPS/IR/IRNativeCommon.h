@@ -17,7 +17,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include "Core/MIPS/IR/IRJit.h"
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
 
@@ -70,6 +74,10 @@ class IRNativeBackend {
 	bool CodeInRange(const u8 *ptr) const;
 	int OffsetFromCodePtr(const u8 *ptr);
 
+	// Must be set before GenerateFixedCode(), the dispatcher only pays for background compile if enabled.
+	void SetAsyncCompile(bool enabled) {
+		asyncCompile_ = enabled;
+	}
 	virtual void GenerateFixedCode(MIPSState *mipsState) = 0;
 	virtual bool CompileBlock(IRBlockCache *irBlockCache, int block_num) = 0;
 	virtual void ClearAllBlocks() = 0;
@@ -156,6 +164,7 @@ class IRNativeBackend {
 	IRBlockCache &blocks_;
 	std::vector<IRNativeBlock> nativeBlocks_;
 	std::unordered_multimap<uint32_t, int> linksTo_;
+	bool asyncCompile_ = false;
 };
 
 class IRNativeBlockCacheDebugInterface : public JitBlockCacheDebugInterface {
@@ -184,7 +193,9 @@ class IRNativeJit : public IRJit {
 
 	void RunLoopUntil(u64 globalticks) override;
 
+	void Compile(u32 em_address) override;
 	void ClearCache() override;
+	void InvalidateCacheAt(u32 em_address, int length = 4) override;
 
 	bool DescribeCodePtr(const u8 *ptr, std::string &name) override;
 	bool CodeInRange(const u8 *ptr) const override;
@@ -198,12 +209,38 @@ class IRNativeJit : public IRJit {
 
 protected:
 	void Init(IRNativeBackend &backend);
+	// Must be called by subclasses before their backend is destroyed, if async compile is possible.
+	void ShutdownAsyncCompile();
 	bool CompileNativeBlock(IRBlockCache *irBlockCache, int block_num) override;
 	void FinalizeNativeBlock(IRBlockCache *irBlockCache, int block_num) override;
 
 	IRNativeBackend *backend_ = nullptr;
 	IRNativeHooks hooks_;
 	IRNativeBlockCacheDebugInterface debugInterface_;
+
+private:
+	friend class IRNativeCompileTask;
+
+	// With bIRAsyncCompile, new blocks get their IR on the emu thread, but the native code is
+	// generated by a thread manager task. Until it's installed, the block runs through IRInterpret.
+	bool QueueAsyncBlock(u32 em_address);
+	bool InstallAsyncBlocks();
+	void WaitForAsyncCompiles();
+	// No blocks queued, compiling, or waiting to be installed.
+	bool AsyncCompileIdle();
+	void RunAsyncCompiles();
+
+	bool asyncCompile_ = false;
+	// Held by the task while generating code, and by the emu thread while changing blocks_ or links.
+	std::mutex compileLock_;
+	std::mutex asyncQueueLock_;
+	std::condition_variable asyncIdleCond_;
+	std::deque<int> asyncQueue_;
+	// Block number and whether the backend succeeded, waiting to be installed by the emu thread.
+	std::vector<std::pair<int, bool>> asyncDone_;
+	bool asyncTaskRunning_ = false;
+	// Emu thread only. Start address to block number, for blocks not yet installed.
+	std::unordered_map<u32, int> asyncPending_;
 };
 
 } // namespace MIPSComp
@@ -21,6 +21,7 @@
 
 #include "ext/xxhash.h"
 #include "Common/CommonTypes.h"
+#include "Common/Data/Format/JSONWriter.h"
 #include "Common/Profiler/Profiler.h"
 
 #ifdef _WIN32
@@ -38,6 +39,7 @@
 #include "Core/MIPS/MIPSAnalyst.h"
 
 #include "Core/MIPS/JitCommon/JitBlockCache.h"
+#include "Core/Debugger/SymbolMap.h"
 #include "Core/MIPS/JitCommon/JitCommon.h"
 
 // #include "JitBase.h"
@@ -723,3 +725,57 @@ JitBlockDebugInfo JitBlockCache::GetBlockDebugInfo(int blockNum) const {
 #endif
 	return debugInfo;
 }
+
+std::vector<JitBlockProfileReportEntry> GetJitBlockProfileReport(const JitBlockCacheDebugInterface *blockCache, size_t maxEntries) {
+	std::vector<JitBlockProfileReportEntry> report;
+	if (!blockCache || !blockCache->SupportsProfiling())
+		return report;
+
+	int numBlocks = blockCache->GetNumBlocks();
+	for (int i = 0; i < numBlocks; ++i) {
+		JitBlockProfileStats stats = blockCache->GetBlockProfileStats(i);
+		if (stats.executions == 0)
+			continue;
+		// Invalidated blocks no longer know their address, so not much use reporting them.
+		JitBlockMeta meta = blockCache->GetBlockMeta(i);
+		if (!meta.valid)
+			continue;
+		report.push_back(JitBlockProfileReportEntry{ i, meta.addr, meta.sizeInBytes, stats });
+	}
+
+	auto hotter = [](const JitBlockProfileReportEntry &a, const JitBlockProfileReportEntry &b) {
+		return a.stats.totalNanos > b.stats.totalNanos;
+	};
+	if (report.size() > maxEntries) {
+		std::partial_sort(report.begin(), report.begin() + maxEntries, report.end(), hotter);
+		report.resize(maxEntries);
+	} else {
+		std::sort(report.begin(), report.end(), hotter);
+	}
+	return report;
+}
+
+void WriteJitBlockProfileReport(json::JsonWriter &j, const std::vector<JitBlockProfileReportEntry> &report) {
+	j.pushArray("blocks");
+	for (const auto &entry : report) {
+		j.pushDict();
+		j.writeInt("block", entry.blockNum);
+		j.writeUint("address", entry.addr);
+		j.writeUint("size", entry.sizeInBytes);
+		j.writeFloat("executions", (double)entry.stats.executions);
+		j.writeFloat("totalNanos", (double)entry.stats.totalNanos);
+		j.writeFloat("avgNanos", entry.stats.executions != 0 ? (double)entry.stats.totalNanos / (double)entry.stats.executions : 0.0);
+
+		u32 funcStart = g_symbolMap ? g_symbolMap->GetFunctionStart(entry.addr) : SymbolMap::INVALID_ADDRESS;
+		if (funcStart != SymbolMap::INVALID_ADDRESS) {
+			std::string name = g_symbolMap->GetLabelString(funcStart);
+			j.writeUint("function", funcStart);
+			if (!name.empty())
+				j.writeString("functionName", name);
+		} else {
+			j.writeNull("function");
+		}
+		j.pop();
+	}
+	j.pop();
+}
@@ -123,10 +123,29 @@ class JitBlockCacheDebugInterface {
 	virtual void ComputeStats(BlockCacheStats &bcStats) const = 0;
 	virtual bool IsValidBlock(int blockNum) const = 0;
 	virtual bool SupportsProfiling() const { return false; }
+	// Runtime sampling profiler, cheap enough to leave on. 0 disables. Returns false if unsupported.
+	virtual bool SetProfileSampleInterval(int interval) { return false; }
+	virtual void ResetProfileStats() {}
 
 	virtual ~JitBlockCacheDebugInterface() {}
 };
 
+struct JitBlockProfileReportEntry {
+	int blockNum;
+	u32 addr;
+	u32 sizeInBytes;
+	JitBlockProfileStats stats;
+};
+
+namespace json {
+class JsonWriter;
+}
+
+// Profiled blocks, most total time first.
+std::vector<JitBlockProfileReportEntry> GetJitBlockProfileReport(const JitBlockCacheDebugInterface *blockCache, size_t maxEntries);
+// Writes a "blocks" array, including the containing function where symbols are known.
+void WriteJitBlockProfileReport(json::JsonWriter &j, const std::vector<JitBlockProfileReportEntry> &report);
+
 class JitBlockCache : public JitBlockCacheDebugInterface {
 public:
 	JitBlockCache(MIPSState *mipsState, CodeBlockCommon *codeBlock);
@@ -918,6 +918,13 @@ void Jit::CheckMemoryBreakpoint(int instructionOffset, MIPSGPReg rs, int offset)
 		// We need to flush, or conditions and log expressions will see old register values.
 		FlushAll();
 
+		// Most accesses aren't on a page with any memchecks, skip the range compares for those.
+		MOV(32, R(EDX), R(EAX));
+		SHR(32, R(EDX), Imm8(BreakpointManager::MEMCHECK_PAGE_SHIFT));
+		MOV(PTRBITS, R(ECX), ImmPtr(g_breakpoints.GetMemCheckPageBitmap(isWrite)));
+		BT(32, MatR(ECX), R(EDX));
+		FixupBranch noPage = J_CC(CC_NC, true);
+
 		std::vector<FixupBranch> hitChecks;
 		hitChecks.reserve(memchecks.size());
 		for (auto it = memchecks.begin(), end = memchecks.end(); it != end; ++it) {
@@ -952,6 +959,7 @@ void Jit::CheckMemoryBreakpoint(int instructionOffset, MIPSGPReg rs, int offset)
 
 		SetJumpTarget(skipCheck);
 		SetJumpTarget(noHits);
+		SetJumpTarget(noPage);
 	}
 }
 
@@ -262,13 +262,23 @@ void X64JitBackend::GenerateFixedCode(MIPSState *mipsState) {
 			SetJumpTarget(needsCompile);
 
 			// No block found, let's jit.  We don't need to save static regs, they're all callee saved.
+			// With background compile, the block may instead be run through the IR interpreter,
+			// which needs the downcount and can change the core state.
+			if (asyncCompile_)
+				SaveStaticRegisters();
 			RestoreRoundingMode(true);
 			WriteDebugProfilerStatus(IRProfilerStatus::COMPILING);
 			ABI_CallFunction(&MIPSComp::JitAt);
 			WriteDebugProfilerStatus(IRProfilerStatus::IN_JIT);
 			ApplyRoundingMode(true);
-			// Let's just dispatch again, we'll enter the block since we know it's there.
-			JMP(dispatcherNoCheck_, true);
+			if (asyncCompile_) {
+				LoadStaticRegisters();
+				// Let's just dispatch again, we'll enter the block if it's there, or come back.
+				JMP(dispatcherCheckCoreState_, true);
+			} else {
+				// Let's just dispatch again, we'll enter the block since we know it's there.
+				JMP(dispatcherNoCheck_, true);
+			}
 
 		SetJumpTarget(bail);
 
@@ -158,6 +158,13 @@ void X64JitBackend::CompIR_Breakpoint(IRInst inst) {
 			// We need to flush, or conditions and log expressions will see old register values.
 			FlushAll();
 
+			// Most accesses aren't on a page with any memchecks, skip the range compares for those.
+			MOV(32, R(EDX), R(SCRATCH1));
+			SHR(32, R(EDX), Imm8(BreakpointManager::MEMCHECK_PAGE_SHIFT));
+			MOV(PTRBITS, R(ECX), ImmPtr(g_breakpoints.GetMemCheckPageBitmap(isWrite)));
+			BT(32, MatR(ECX), R(EDX));
+			FixupBranch noPage = J_CC(CC_NC, true);
+
 			std::vector<FixupBranch> hitChecks;
 			for (const auto &it : memchecks) {
 				if (it.end != 0) {
@@ -186,6 +193,7 @@ void X64JitBackend::CompIR_Breakpoint(IRInst inst) {
 			J_CC(CC_NZ, dispatcherCheckCoreState_, true);
 
 			SetJumpTarget(noHits);
+			SetJumpTarget(noPage);
 		}
 		break;
 
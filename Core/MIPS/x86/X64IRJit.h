@@ -172,6 +172,9 @@ class X64IRJit : public IRNativeJit {
 		: IRNativeJit(mipsState), x64Backend_(jo, blocks_) {
 		Init(x64Backend_);
 	}
+	~X64IRJit() {
+		ShutdownAsyncCompile();
+	}
 
 private:
 	X64JitBackend x64Backend_;
@@ -350,7 +350,7 @@ static void DoMemoryVoid(PointerWrap &p, uint32_t start, uint32_t size) {
 	storage += size;
 }
 
-void DoState(PointerWrap &p) {
+void DoState(PointerWrap &p, bool includeRAM) {
 	auto s = p.Section("Memory", 1, 3);
 	if (!s)
 		return;
@@ -382,8 +382,10 @@ void DoState(PointerWrap &p) {
 		}
 	}
 
-	DoMemoryVoid(p, PSP_GetKernelMemoryBase(), g_MemorySize);
-	p.DoMarker("RAM");
+	if (includeRAM) {
+		DoMemoryVoid(p, PSP_GetKernelMemoryBase(), g_MemorySize);
+		p.DoMarker("RAM");
+	}
 
 	DoMemoryVoid(p, PSP_GetVidMemBase(), VRAM_SIZE);
 	p.DoMarker("VRAM");
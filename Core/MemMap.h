@@ -111,7 +111,8 @@ void MemoryMap_Shutdown(u32 flags);
 // Init and Shutdown
 bool Init();
 void Shutdown();
-void DoState(PointerWrap &p);
+// When includeRAM is false, main RAM is left untouched (used by page-tracked rewind.)
+void DoState(PointerWrap &p, bool includeRAM = true);
 void Clear();
 // False when shutdown has already been called.
 bool IsActive();
@@ -20,7 +20,10 @@
 #include <thread>
 #include <mutex>
 
+#include "ext/xxhash.h"
 #include "Common/Data/Text/I18n.h"
+#include "Common/Thread/ParallelLoop.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Common/Thread/ThreadUtil.h"
 #include "Common/Data/Text/Parsers.h"
 #include "Common/System/System.h"
@@ -99,17 +102,35 @@ double g_lastSaveTime = -1.0;
 		return CChunkFileReader::LoadPtr(&data[0], state, errorString);
 	}
 
+	// Set while the rewind buffer saves or loads a state without main RAM in it (see bRewindTrackPages.)
+	static bool rewindTrackingPages = false;
+
+	static const u32 REWIND_PAGE_SIZE = 4096;
+
+	static void HashRAMPages(const u8 *ram, std::vector<u64> &hashes) {
+		hashes.resize(Memory::g_MemorySize / REWIND_PAGE_SIZE);
+		ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+			for (int i = l; i < h; i++)
+				hashes[i] = XXH3_64bits(ram + i * REWIND_PAGE_SIZE, REWIND_PAGE_SIZE);
+		}, 0, (int)hashes.size(), 512);
+	}
+
 	// This ring buffer of states is for rewind save states, which are kept in RAM.
 	// Save states are compressed against one of two reference saves (bases_), and the reference
 	// is switched to a fresh save every N saves, where N is BASE_USAGE_INTERVAL.
 	// The compression is a simple block based scheme where 0 means to copy a block from the base,
 	// and 1 means that the following bytes are the next block. See Compress/LockedDecompress.
+	//
+	// In page mode, main RAM is left out of the states entirely. Instead, shadowRAM_ holds RAM as of
+	// the latest snapshot, and each snapshot keeps the previous contents of the pages that changed
+	// (undo_), found by comparing page hashes. Rewinding copies back only pages that differ.
 	class StateRingbuffer {
 	public:
 		StateRingbuffer() {
 			size_ = REWIND_NUM_STATES;
 			states_.resize(size_);
 			baseMapping_.resize(size_);
+			undo_.resize(size_);
 		}
 
 		~StateRingbuffer() {
@@ -122,6 +143,12 @@ double g_lastSaveTime = -1.0;
 		{
 			rewindLastTime_ = time_now_d();
 
+			// The states don't contain the same things, so we can't mix them.
+			if (pageMode_ != g_Config.bRewindTrackPages) {
+				Clear();
+				pageMode_ = g_Config.bRewindTrackPages;
+			}
+
 			// Make sure we're not processing a previous save. That'll cause a hitch though, but at least won't
 			// crash due to contention over buffer_.
 			if (compressThread_.joinable())
@@ -136,6 +163,8 @@ double g_lastSaveTime = -1.0;
 			std::vector<u8> *compressBuffer = &buffer_;
 			CChunkFileReader::Error err;
 
+			captureSlot_ = n;
+			rewindTrackingPages = pageMode_;
 			if (base_ == -1 || ++baseUsage_ > BASE_USAGE_INTERVAL)
 			{
 				base_ = (base_ + 1) % ARRAY_SIZE(bases_);
@@ -146,11 +175,16 @@ double g_lastSaveTime = -1.0;
 			}
 			else
 				err = SaveToRam(buffer_);
+			rewindTrackingPages = false;
 
-			if (err == CChunkFileReader::ERROR_NONE)
+			if (err == CChunkFileReader::ERROR_NONE) {
 				ScheduleCompress(&states_[n], compressBuffer, &bases_[base_]);
-			else
+			} else {
 				states_[n].clear();
+				// We may or may not have captured RAM, so the page history can't be trusted anymore.
+				if (pageMode_)
+					LockedClearPages();
+			}
 
 			baseMapping_[n] = base_;
 			return err;
@@ -164,17 +198,60 @@ double g_lastSaveTime = -1.0;
 			if (Empty())
 				return CChunkFileReader::ERROR_BAD_FILE;
 
-			int n = (--next_ + size_) % size_;
+			// Only consume the slot once we know we can use it, or the page history gets out of step.
+			int n = (next_ - 1 + size_) % size_;
 			if (states_[n].empty())
 				return CChunkFileReader::ERROR_BAD_FILE;
 
+			// RAM must be in place before loading, since modules reapply replacements during the load.
+			if (pageMode_ && !LockedRestoreRAMPages(n))
+				return CChunkFileReader::ERROR_BAD_FILE;
+			--next_;
+
 			static std::vector<u8> buffer;
 			LockedDecompress(buffer, states_[n], bases_[baseMapping_[n]]);
+			rewindTrackingPages = pageMode_;
 			CChunkFileReader::Error error = LoadFromRam(buffer, errorString);
+			rewindTrackingPages = false;
 			rewindLastTime_ = time_now_d();
 			return error;
 		}
 
+		// Called from SaveStart::DoState while saving in page mode, with emuhacks and replacements cleared.
+		void CaptureRAMPages()
+		{
+			const u8 *ram = Memory::GetPointerUnchecked(PSP_GetKernelMemoryBase());
+			PageUndo &undo = undo_[captureSlot_];
+			undo.pages.clear();
+			undo.data.clear();
+
+			if (shadowRAM_.size() != Memory::g_MemorySize) {
+				// Nothing to diff against, so this becomes the oldest state we can rewind to.
+				shadowRAM_.assign(ram, ram + Memory::g_MemorySize);
+				HashRAMPages(ram, pageHashes_);
+				pageStates_ = 1;
+				return;
+			}
+
+			double start_time = time_now_d();
+			HashRAMPages(ram, curHashes_);
+			u8 *shadow = &shadowRAM_[0];
+			for (size_t i = 0; i < curHashes_.size(); ++i) {
+				if (curHashes_[i] == pageHashes_[i])
+					continue;
+				const u32 offset = (u32)i * REWIND_PAGE_SIZE;
+				undo.pages.push_back((u32)i);
+				undo.data.insert(undo.data.end(), shadow + offset, shadow + offset + REWIND_PAGE_SIZE);
+				memcpy(shadow + offset, ram + offset, REWIND_PAGE_SIZE);
+				pageHashes_[i] = curHashes_[i];
+			}
+			// The ring always keeps one slot free, so that's the deepest we can go.
+			pageStates_ = std::min(pageStates_ + 1, size_ - 1);
+
+			double taken_s = time_now_d() - start_time;
+			DEBUG_LOG(Log::SaveState, "Rewind: %d of %d RAM pages changed, captured in %0.2f ms.", (int)undo.pages.size(), (int)curHashes_.size(), taken_s * 1000.0);
+		}
+
 		void ScheduleCompress(std::vector<u8> *result, const std::vector<u8> *state, const std::vector<u8> *base)
 		{
 			if (compressThread_.joinable())
@@ -259,6 +336,7 @@ double g_lastSaveTime = -1.0;
 			for (auto &s : states_) {
 				s.clear();
 			}
+			LockedClearPages();
 			buffer_.clear();
 			base_ = -1;
 			baseUsage_ = 0;
@@ -294,6 +372,61 @@ double g_lastSaveTime = -1.0;
 		}
 
 	private:
+		// Puts RAM back to how it was at the latest snapshot (slot n), then steps shadowRAM_ back one snapshot.
+		bool LockedRestoreRAMPages(int n)
+		{
+			if (pageStates_ <= 0 || shadowRAM_.size() != Memory::g_MemorySize)
+				return false;
+
+			// The snapshot was taken without emuhacks or replacements, and unchanged pages stay as they are.
+			// No need to restore either afterward: the load resets the jit and reapplies replacements.
+			SaveAndClearReplacements();
+			if (MIPSComp::jit) {
+				std::lock_guard<std::recursive_mutex> guard(MIPSComp::jitLock);
+				if (MIPSComp::jit)
+					MIPSComp::jit->SaveAndClearEmuHackOps();
+			}
+
+			u8 *ram = Memory::GetPointerWriteUnchecked(PSP_GetKernelMemoryBase());
+			const u8 *shadow = &shadowRAM_[0];
+			HashRAMPages(ram, curHashes_);
+			ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+				for (int i = l; i < h; i++) {
+					if (curHashes_[i] != pageHashes_[i])
+						memcpy(ram + i * REWIND_PAGE_SIZE, shadow + i * REWIND_PAGE_SIZE, REWIND_PAGE_SIZE);
+				}
+			}, 0, (int)curHashes_.size(), 512);
+
+			if (--pageStates_ == 0) {
+				// There's no older RAM to go back to, the next save will start over.
+				LockedClearPages();
+				return true;
+			}
+
+			PageUndo &undo = undo_[n];
+			for (size_t i = 0; i < undo.pages.size(); ++i) {
+				const u32 offset = undo.pages[i] * REWIND_PAGE_SIZE;
+				memcpy(&shadowRAM_[offset], &undo.data[i * REWIND_PAGE_SIZE], REWIND_PAGE_SIZE);
+				pageHashes_[undo.pages[i]] = XXH3_64bits(&shadowRAM_[offset], REWIND_PAGE_SIZE);
+			}
+			undo.pages.clear();
+			undo.data.clear();
+			return true;
+		}
+
+		void LockedClearPages()
+		{
+			shadowRAM_.clear();
+			shadowRAM_.shrink_to_fit();
+			pageHashes_.clear();
+			curHashes_.clear();
+			for (auto &undo : undo_) {
+				undo.pages.clear();
+				undo.data.clear();
+			}
+			pageStates_ = 0;
+		}
+
 		const int BLOCK_SIZE = 8192;
 		const int REWIND_NUM_STATES = 20;
 		// TODO: Instead, based on size of compressed state?
@@ -315,6 +448,21 @@ double g_lastSaveTime = -1.0;
 		int base_ = -1;
 		int baseUsage_ = 0;
 
+		struct PageUndo {
+			std::vector<u32> pages;
+			// REWIND_PAGE_SIZE bytes for each entry in pages.
+			std::vector<u8> data;
+		};
+
+		bool pageMode_ = false;
+		std::vector<u8> shadowRAM_;
+		std::vector<u64> pageHashes_;
+		std::vector<u64> curHashes_;
+		std::vector<PageUndo> undo_;
+		int captureSlot_ = 0;
+		// How many snapshots back we can still reconstruct RAM for.
+		int pageStates_ = 0;
+
 		double rewindLastTime_ = 0.0f;
 	};
 
@@ -339,6 +487,12 @@ double g_lastSaveTime = -1.0;
 	static const int SCREENSHOT_FAILURE_RETRIES = 6;
 	static StateRingbuffer rewindStates;
 
+	static void DoMemoryState(PointerWrap &p) {
+		Memory::DoState(p, !rewindTrackingPages);
+		if (rewindTrackingPages && p.mode == PointerWrap::MODE_WRITE)
+			rewindStates.CaptureRAMPages();
+	}
+
 	void SaveStart::DoState(PointerWrap &p)
 	{
 		auto s = p.Section("SaveStart", 1, 3);
@@ -376,13 +530,13 @@ double g_lastSaveTime = -1.0;
 			if (MIPSComp::jit) {
 				std::vector<u32> savedBlocks;
 				savedBlocks = MIPSComp::jit->SaveAndClearEmuHackOps();
-				Memory::DoState(p);
+				DoMemoryState(p);
 				MIPSComp::jit->RestoreSavedEmuHackOps(savedBlocks);
 			} else {
-				Memory::DoState(p);
+				DoMemoryState(p);
 			}
 		} else {
-			Memory::DoState(p);
+			DoMemoryState(p);
 		}
 
 		if (s >= 3) {
@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/Log.h"
@@ -25,7 +26,9 @@
 #include "Core/Util/BlockAllocator.h"
 #include "Core/Reporting.h"
 
-// Slow freaking thing but works (eventually) :)
+// Blocks are kept in a linked list in address order, and also in a treap by address which knows
+// the largest free block in each subtree. That makes finding the first (or last) block an allocation
+// fits in, or the block at an address, O(log n), while picking exactly the same blocks as a walk would.
 
 BlockAllocator::~BlockAllocator()
 {
@@ -39,6 +42,7 @@ void BlockAllocator::Init(u32 rangeStart, u32 rangeSize, bool suballoc) {
 	//Initial block, covering everything
 	top_ = new Block(rangeStart_, rangeSize_, false, NULL, NULL);
 	bottom_ = top_;
+	IndexInsert(top_);
 	suballoc_ = suballoc;
 }
 
@@ -51,6 +55,7 @@ void BlockAllocator::Shutdown()
 		bottom_ = next;
 	}
 	top_ = NULL;
+	root_ = nullptr;
 }
 
 u32 BlockAllocator::AllocAligned(u32 &size, u32 sizeGrain, u32 grain, bool fromTop, const char *tag)
@@ -73,62 +78,65 @@ u32 BlockAllocator::AllocAligned(u32 &size, u32 sizeGrain, u32 grain, bool fromT
 	if (!fromTop)
 	{
 		//Allocate from bottom of mem
-		for (Block *bp = bottom_; bp != NULL; bp = bp->next)
-		{
-			Block &b = *bp;
+		auto bottomOffset = [grain](const Block &b) {
 			u32 offset = b.start % grain;
 			if (offset != 0)
 				offset = grain - offset;
+			return offset;
+		};
+		Block *bp = FindLowest(root_, size, [&](const Block &b) {
+			return b.size >= bottomOffset(b) + size;
+		});
+		if (bp != NULL)
+		{
+			Block &b = *bp;
+			u32 offset = bottomOffset(b);
 			u32 needed = offset + size;
-			if (b.taken == false && b.size >= needed)
+			if (b.size == needed)
+			{
+				if (offset >= grain_)
+					InsertFreeBefore(&b, offset);
+				Take(b, tag);
+				return b.start;
+			}
+			else
 			{
-				if (b.size == needed)
-				{
-					if (offset >= grain_)
-						InsertFreeBefore(&b, offset);
-					b.taken = true;
-					b.SetAllocated(tag, suballoc_);
-					return b.start;
-				}
-				else
-				{
-					InsertFreeAfter(&b, b.size - needed);
-					if (offset >= grain_)
-						InsertFreeBefore(&b, offset);
-					b.taken = true;
-					b.SetAllocated(tag, suballoc_);
-					return b.start;
-				}
+				InsertFreeAfter(&b, b.size - needed);
+				if (offset >= grain_)
+					InsertFreeBefore(&b, offset);
+				Take(b, tag);
+				return b.start;
 			}
 		}
 	}
 	else
 	{
 		// Allocate from top of mem.
-		for (Block *bp = top_; bp != NULL; bp = bp->prev)
+		auto topOffset = [grain, size](const Block &b) {
+			return (b.start + b.size - size) % grain;
+		};
+		Block *bp = FindHighest(root_, size, [&](const Block &b) {
+			return b.size >= topOffset(b) + size;
+		});
+		if (bp != NULL)
 		{
 			Block &b = *bp;
-			u32 offset = (b.start + b.size - size) % grain;
+			u32 offset = topOffset(b);
 			u32 needed = offset + size;
-			if (b.taken == false && b.size >= needed)
+			if (b.size == needed)
+			{
+				if (offset >= grain_)
+					InsertFreeAfter(&b, offset);
+				Take(b, tag);
+				return b.start;
+			}
+			else
 			{
-				if (b.size == needed)
-				{
-					if (offset >= grain_)
-						InsertFreeAfter(&b, offset);
-					b.taken = true;
-					b.SetAllocated(tag, suballoc_);
-					return b.start;
-				}
-				else
-				{
-					InsertFreeBefore(&b, b.size - needed);
-					if (offset >= grain_)
-						InsertFreeAfter(&b, offset);
-					b.taken = true;
-					b.SetAllocated(tag, suballoc_);
-					return b.start;
-				}
+				InsertFreeBefore(&b, b.size - needed);
+				if (offset >= grain_)
+					InsertFreeAfter(&b, offset);
+				Take(b, tag);
+				return b.start;
 			}
 		}
 	}
@@ -147,7 +155,10 @@ u32 BlockAllocator::Alloc(u32 &size, bool fromTop, const char *tag)
 
 u32 BlockAllocator::AllocAt(u32 position, u32 size, const char *tag)
 {
+#ifdef _DEBUG
+	// This walks every block, so only in debug builds.
 	CheckBlocks();
+#endif
 	if (size > rangeSize_) {
 		ERROR_LOG(Log::sceKernel, "Clearly bogus size: %08x - failing allocation", size);
 		return -1;
@@ -191,9 +202,7 @@ u32 BlockAllocator::AllocAt(u32 position, u32 size, const char *tag)
 			{
 				if (b.size != alignedSize)
 					InsertFreeAfter(&b, b.size - alignedSize);
-				b.taken = true;
-				b.SetAllocated(tag, suballoc_);
-				CheckBlocks();
+				Take(b, tag);
 				return position;
 			}
 			else
@@ -201,8 +210,7 @@ u32 BlockAllocator::AllocAt(u32 position, u32 size, const char *tag)
 				InsertFreeBefore(&b, alignedPosition - b.start);
 				if (b.size > alignedSize)
 					InsertFreeAfter(&b, b.size - alignedSize);
-				b.taken = true;
-				b.SetAllocated(tag, suballoc_);
+				Take(b, tag);
 
 				return position;
 			}
@@ -220,6 +228,13 @@ u32 BlockAllocator::AllocAt(u32 position, u32 size, const char *tag)
 	return -1;
 }
 
+void BlockAllocator::Take(Block &b, const char *tag)
+{
+	b.taken = true;
+	b.SetAllocated(tag, suballoc_);
+	IndexUpdate(&b);
+}
+
 void BlockAllocator::MergeFreeBlocks(Block *fromBlock)
 {
 	VERBOSE_LOG(Log::sceKernel, "Merging Blocks");
@@ -234,6 +249,7 @@ void BlockAllocator::MergeFreeBlocks(Block *fromBlock)
 		else
 			fromBlock->next->prev = prev;
 		prev->next = fromBlock->next;
+		IndexErase(fromBlock);
 		delete fromBlock;
 		fromBlock = prev;
 		prev = fromBlock->prev;
@@ -250,6 +266,7 @@ void BlockAllocator::MergeFreeBlocks(Block *fromBlock)
 		VERBOSE_LOG(Log::sceKernel, "Block Alloc found adjacent free blocks - merging");
 		fromBlock->size += next->size;
 		fromBlock->next = next->next;
+		IndexErase(next);
 		delete next;
 		next = fromBlock->next;
 	}
@@ -258,6 +275,8 @@ void BlockAllocator::MergeFreeBlocks(Block *fromBlock)
 		top_ = fromBlock;
 	else
 		next->prev = fromBlock;
+
+	IndexUpdate(fromBlock);
 }
 
 bool BlockAllocator::Free(u32 position)
@@ -303,8 +322,12 @@ BlockAllocator::Block *BlockAllocator::InsertFreeBefore(Block *b, u32 size)
 	else
 		inserted->prev->next = inserted;
 
+	// The start address is the key, so take it out while it changes.
+	IndexErase(b);
 	b->start += size;
 	b->size -= size;
+	IndexInsert(b);
+	IndexInsert(inserted);
 	return inserted;
 }
 
@@ -318,9 +341,136 @@ BlockAllocator::Block *BlockAllocator::InsertFreeAfter(Block *b, u32 size)
 		inserted->next->prev = inserted;
 
 	b->size -= size;
+	IndexUpdate(b);
+	IndexInsert(inserted);
 	return inserted;
 }
 
+void BlockAllocator::IndexRecalc(Block *t)
+{
+	u32 ownFree = t->taken ? 0 : t->size;
+	t->maxFree = ownFree;
+	t->totalFree = ownFree;
+	if (t->left) {
+		t->maxFree = std::max(t->maxFree, t->left->maxFree);
+		t->totalFree += t->left->totalFree;
+	}
+	if (t->right) {
+		t->maxFree = std::max(t->maxFree, t->right->maxFree);
+		t->totalFree += t->right->totalFree;
+	}
+}
+
+// Splits into blocks before start, and blocks at or after start.
+void BlockAllocator::IndexSplit(Block *t, u32 start, Block *&left, Block *&right)
+{
+	if (!t) {
+		left = nullptr;
+		right = nullptr;
+	} else if (t->start < start) {
+		IndexSplit(t->right, start, t->right, right);
+		left = t;
+		IndexRecalc(t);
+	} else {
+		IndexSplit(t->left, start, left, t->left);
+		right = t;
+		IndexRecalc(t);
+	}
+}
+
+// Everything in left must be before everything in right.
+BlockAllocator::Block *BlockAllocator::IndexMerge(Block *left, Block *right)
+{
+	if (!left)
+		return right;
+	if (!right)
+		return left;
+	if (left->priority > right->priority) {
+		left->right = IndexMerge(left->right, right);
+		IndexRecalc(left);
+		return left;
+	}
+	right->left = IndexMerge(left, right->left);
+	IndexRecalc(right);
+	return right;
+}
+
+void BlockAllocator::IndexUpdatePath(Block *t, u32 start)
+{
+	if (!t)
+		return;
+	if (start < t->start)
+		IndexUpdatePath(t->left, start);
+	else if (start > t->start)
+		IndexUpdatePath(t->right, start);
+	IndexRecalc(t);
+}
+
+void BlockAllocator::IndexInsert(Block *b)
+{
+	// xorshift, the tree only needs to be balanced, not unpredictable.
+	prioritySeed_ ^= prioritySeed_ << 13;
+	prioritySeed_ ^= prioritySeed_ >> 17;
+	prioritySeed_ ^= prioritySeed_ << 5;
+	b->priority = prioritySeed_;
+	b->left = nullptr;
+	b->right = nullptr;
+	IndexRecalc(b);
+
+	Block *left, *right;
+	IndexSplit(root_, b->start, left, right);
+	root_ = IndexMerge(IndexMerge(left, b), right);
+}
+
+void BlockAllocator::IndexErase(Block *b)
+{
+	Block *left, *middle, *right;
+	IndexSplit(root_, b->start, left, middle);
+	IndexSplit(middle, b->start + 1, middle, right);
+	_dbg_assert_(middle == b);
+	root_ = IndexMerge(left, right);
+	b->left = nullptr;
+	b->right = nullptr;
+}
+
+void BlockAllocator::IndexUpdate(Block *b)
+{
+	IndexUpdatePath(root_, b->start);
+}
+
+void BlockAllocator::IndexRebuild()
+{
+	root_ = nullptr;
+	for (Block *bp = bottom_; bp != NULL; bp = bp->next)
+		IndexInsert(bp);
+}
+
+template <typename F>
+BlockAllocator::Block *BlockAllocator::FindLowest(Block *t, u32 minSize, F fits)
+{
+	if (!t || t->maxFree < minSize)
+		return nullptr;
+	Block *found = FindLowest(t->left, minSize, fits);
+	if (found)
+		return found;
+	if (!t->taken && t->size >= minSize && fits(*t))
+		return t;
+	return FindLowest(t->right, minSize, fits);
+}
+
+template <typename F>
+BlockAllocator::Block *BlockAllocator::FindHighest(Block *t, u32 minSize, F fits)
+{
+	if (!t || t->maxFree < minSize)
+		return nullptr;
+	Block *found = FindHighest(t->right, minSize, fits);
+	if (found)
+		return found;
+	if (!t->taken && t->size >= minSize && fits(*t))
+		return t;
+	return FindHighest(t->left, minSize, fits);
+}
+
 void BlockAllocator::CheckBlocks() const
 {
 	for (const Block *bp = bottom_; bp != NULL; bp = bp->next)
@@ -343,29 +493,27 @@ const char *BlockAllocator::GetBlockTag(u32 addr) const {
 
 inline BlockAllocator::Block *BlockAllocator::GetBlockFromAddress(u32 addr)
 {
-	for (Block *bp = bottom_; bp != NULL; bp = bp->next)
-	{
-		Block &b = *bp;
-		if (b.start <= addr && b.start + b.size > addr)
-		{
-			// Got one!
-			return bp;
-		}
-	}
-	return NULL;
+	return const_cast<Block *>(const_cast<const BlockAllocator *>(this)->GetBlockFromAddress(addr));
 }
 
 const BlockAllocator::Block *BlockAllocator::GetBlockFromAddress(u32 addr) const
 {
-	for (const Block *bp = bottom_; bp != NULL; bp = bp->next)
+	// The last block starting at or before addr is the only one that can contain it.
+	const Block *candidate = NULL;
+	for (const Block *t = root_; t != NULL; )
 	{
-		const Block &b = *bp;
-		if (b.start <= addr && b.start + b.size > addr)
+		if (t->start <= addr)
 		{
-			// Got one!
-			return bp;
+			candidate = t;
+			t = t->right;
+		}
+		else
+		{
+			t = t->left;
 		}
 	}
+	if (candidate && candidate->start + candidate->size > addr)
+		return candidate;
 	return NULL;
 }
 
@@ -400,16 +548,7 @@ void BlockAllocator::ListBlocks() const
 
 u32 BlockAllocator::GetLargestFreeBlockSize() const
 {
-	u32 maxFreeBlock = 0;
-	for (const Block *bp = bottom_; bp != NULL; bp = bp->next)
-	{
-		const Block &b = *bp;
-		if (!b.taken)
-		{
-			if (b.size > maxFreeBlock)
-				maxFreeBlock = b.size;
-		}
-	}
+	u32 maxFreeBlock = root_ ? root_->maxFree : 0;
 	if (maxFreeBlock & (grain_ - 1))
 		WARN_LOG_REPORT(Log::HLE, "GetLargestFreeBlockSize: free size %08x does not align to grain %08x.", maxFreeBlock, grain_);
 	return maxFreeBlock;
@@ -417,15 +556,7 @@ u32 BlockAllocator::GetLargestFreeBlockSize() const
 
 u32 BlockAllocator::GetTotalFreeBytes() const
 {
-	u32 sum = 0;
-	for (const Block *bp = bottom_; bp != NULL; bp = bp->next)
-	{
-		const Block &b = *bp;
-		if (!b.taken)
-		{
-			sum += b.size;
-		}
-	}
+	u32 sum = root_ ? root_->totalFree : 0;
 	if (sum & (grain_ - 1))
 		WARN_LOG_REPORT(Log::HLE, "GetTotalFreeBytes: free size %08x does not align to grain %08x.", sum, grain_);
 	return sum;
@@ -455,6 +586,7 @@ void BlockAllocator::DoState(PointerWrap &p)
 			top_->next->DoState(p);
 			top_ = top_->next;
 		}
+		IndexRebuild();
 	}
 	else
 	{
@@ -69,19 +69,45 @@ class BlockAllocator
 		char tag[32];
 		Block *prev;
 		Block *next;
+
+		// Index (a treap by start address), not saved.
+		Block *left = nullptr;
+		Block *right = nullptr;
+		u32 priority = 0;
+		// Largest and total free size in this subtree.
+		u32 maxFree = 0;
+		u32 totalFree = 0;
 	};
 
 	Block *bottom_ = nullptr;
 	Block *top_ = nullptr;
+	Block *root_ = nullptr;
+	u32 prioritySeed_ = 0x12345678;
 	u32 rangeStart_ = 0;
 	u32 rangeSize_ = 0;
 
 	u32 grain_;
 	bool suballoc_ = false;
 
+	void Take(Block &b, const char *tag);
 	void MergeFreeBlocks(Block *fromBlock);
 	Block *GetBlockFromAddress(u32 addr);
 	const Block *GetBlockFromAddress(u32 addr) const;
 	Block *InsertFreeBefore(Block *b, u32 size);
 	Block *InsertFreeAfter(Block *b, u32 size);
+
+	// The index has to be told about every block that's added, removed or resized.
+	void IndexInsert(Block *b);
+	void IndexErase(Block *b);
+	// After size or taken changed (but not start.)
+	void IndexUpdate(Block *b);
+	void IndexRebuild();
+	static void IndexRecalc(Block *t);
+	static void IndexSplit(Block *t, u32 start, Block *&left, Block *&right);
+	static Block *IndexMerge(Block *left, Block *right);
+	static void IndexUpdatePath(Block *t, u32 start);
+	template <typename F>
+	static Block *FindLowest(Block *t, u32 minSize, F fits);
+	template <typename F>
+	static Block *FindHighest(Block *t, u32 minSize, F fits);
 };
@@ -27,6 +27,7 @@
 #include "Common/TimeUtil.h"
 #include "Core/System.h"
 #include "Core/Config.h"
+#include "Core/MemMap.h"
 #include "GPU/Common/DrawEngineCommon.h"
 #include "GPU/Common/SplineCommon.h"
 #include "GPU/Common/DepthRaster.h"
@@ -39,7 +40,16 @@ enum {
 	TRANSFORMED_VERTEX_BUFFER_SIZE = VERTEX_BUFFER_MAX * sizeof(TransformedVertex),
 };
 
-DrawEngineCommon::DrawEngineCommon() : decoderMap_(32) {
+// Smaller draws are cheaper to just decode than to look up.
+static const int VERTEX_CACHE_MIN_VERTS = 32;
+static const size_t VERTEX_CACHE_MAX_BYTES = 32 * 1024 * 1024;
+static const int VERTEX_CACHE_DECIMATION_INTERVAL = 37;
+static const int VERTEX_CACHE_KILL_AGE = 120;
+static const int VERTEX_CACHE_KILL_AGE_PRESSURE = 10;
+// After this many changes, we give up and just decode every time (until the entry ages out.)
+static const int VERTEX_CACHE_MAX_CHANGES = 8;
+
+DrawEngineCommon::DrawEngineCommon() : decoderMap_(32), decodedVertsCache_(256) {
 	if (g_Config.bVertexDecoderJit && (g_Config.iCpuCore == (int)CPUCore::JIT || g_Config.iCpuCore == (int)CPUCore::JIT_IR)) {
 		decJitCache_ = new VertexDecoderJitCache();
 	}
@@ -62,6 +72,7 @@ DrawEngineCommon::~DrawEngineCommon() {
 	decoderMap_.Iterate([&](const uint32_t vtype, VertexDecoder *decoder) {
 		delete decoder;
 	});
+	ClearDecodedVertsCache();
 	ClearSplineBezierWeights();
 }
 
@@ -100,6 +111,9 @@ void DrawEngineCommon::NotifyConfigChanged() {
 		delete decoder;
 	});
 	decoderMap_.Clear();
+	// Decoder options might have changed.
+	ClearDecodedVertsCache();
+	useVertexCache_ = g_Config.bVertexCache;
 
 	useHWTransform_ = g_Config.bHardwareTransform;
 	useHWTessellation_ = UpdateUseHWTessellation(g_Config.bHardwareTessellation);
@@ -767,6 +781,11 @@ bool DrawEngineCommon::SubmitPrim(const void *verts, const void *inds, GEPrimiti
 
 void DrawEngineCommon::BeginFrame() {
 	applySkinInDecode_ = g_Config.bSoftwareSkinning;
+
+	decodedVertsInvalidatedAll_ = 0;
+	if (useVertexCache_ && (gpuStats.numFlips % VERTEX_CACHE_DECIMATION_INTERVAL) == 0) {
+		DecimateDecodedVertsCache();
+	}
 }
 
 void DrawEngineCommon::DecodeVerts(const VertexDecoder *dec, u8 *dest) {
@@ -790,12 +809,203 @@ void DrawEngineCommon::DecodeVerts(const VertexDecoder *dec, u8 *dest) {
 		}
 
 		// Decode the verts (and at the same time apply morphing/skinning). Simple.
-		dec->DecodeVerts(dest + numDecodedVerts_ * stride, dv.verts, &dv.uvScale, indexLowerBound, indexUpperBound);
+		u8 *vertsDest = dest + numDecodedVerts_ * stride;
+		if (!useVertexCache_ || !DecodeVertsCached(dec, dv, vertsDest)) {
+			dec->DecodeVerts(vertsDest, dv.verts, &dv.uvScale, indexLowerBound, indexUpperBound);
+		}
 		numDecodedVerts_ += indexUpperBound - indexLowerBound + 1;
 	}
 	decodeVertsCounter_ = i;
 }
 
+static u32 VertsMiniHash(const u8 *src, u32 size) {
+	// Just the start and end, in case only part of a buffer was rewritten.
+	const u32 sampleSize = 64;
+	if (size <= sampleSize * 2)
+		return XXH32(src, size, 0xC0108888);
+	return XXH32(src, sampleSize, 0xC0108888) ^ XXH32(src + size - sampleSize, sampleSize, 0xC0108888);
+}
+
+// Returns false if the caller should decode normally.
+bool DrawEngineCommon::DecodeVertsCached(const VertexDecoder *dec, const DeferredVerts &dv, u8 *dest) {
+	const int count = dv.indexUpperBound + 1 - dv.indexLowerBound;
+	// Skinning and morphing depend on state other than the vertex data.
+	if (count < VERTEX_CACHE_MIN_VERTS || dec->skinInDecode || (dec->VertexType() & GE_VTYPE_MORPHCOUNT_MASK) != 0) {
+		return false;
+	}
+
+	DecodedVertsKey key;
+	key.verts = dv.verts;
+	key.vertType = dec->VertexType();
+	key.indexLowerBound = dv.indexLowerBound;
+	key.indexUpperBound = dv.indexUpperBound;
+	key.uvScale[0] = dv.uvScale.uScale;
+	key.uvScale[1] = dv.uvScale.vScale;
+	key.uvScale[2] = dv.uvScale.uOff;
+	key.uvScale[3] = dv.uvScale.vOff;
+
+	const u8 *src = (const u8 *)dv.verts + dv.indexLowerBound * dec->VertexSize();
+	const u32 srcSize = count * dec->VertexSize();
+	const size_t decodedSize = count * dec->GetDecVtxFmt().stride;
+	const int frame = gpuStats.numFlips;
+
+	// Splines and immediate draws are generated into temporary buffers, those can't be tracked.
+	const u32 srcAddr = Memory::GetAddressFromHostPointerUnchecked(src);
+	if (!Memory::IsValidRange(srcAddr, srcSize) || Memory::GetPointerUnchecked(srcAddr) != src) {
+		return false;
+	}
+
+	DecodedVertsEntry *entry = decodedVertsCache_.GetOrNull(key);
+	if (!entry) {
+		if (decodedVertsCacheBytes_ + decodedSize > VERTEX_CACHE_MAX_BYTES) {
+			return false;
+		}
+		// First time we see it, just remember the hash. If it's the same next time, we'll cache it.
+		entry = new DecodedVertsEntry();
+		entry->fullHash = XXH3_64bits(src, srcSize);
+		entry->minihash = VertsMiniHash(src, srcSize);
+		entry->srcAddr = srcAddr & 0x3FFFFFFF;
+		entry->srcSize = srcSize;
+		entry->lastFrame = frame;
+		entry->numFrames = 0;
+		entry->framesUntilNextFullHash = 0;
+		entry->numChanges = 0;
+		entry->status = DecodedVertsEntry::HASHING;
+		decodedVertsCache_.Insert(key, entry);
+		decodedVertsCacheMinAddr_ = std::min(decodedVertsCacheMinAddr_, entry->srcAddr);
+		decodedVertsCacheMaxAddr_ = std::max(decodedVertsCacheMaxAddr_, entry->srcAddr + srcSize);
+		return false;
+	}
+
+	if (entry->status == DecodedVertsEntry::UNRELIABLE) {
+		entry->lastFrame = frame;
+		return false;
+	}
+
+	bool rehash = entry->status == DecodedVertsEntry::HASHING;
+	if (entry->lastFrame != frame) {
+		int diff = frame - entry->lastFrame;
+		entry->numFrames++;
+		if (entry->framesUntilNextFullHash < diff) {
+			// Exponential backoff up to 256 frames, spread out a bit so they don't all rehash the same frame.
+			if (entry->numFrames > 32) {
+				entry->framesUntilNextFullHash = std::min(256, entry->numFrames) + ((entry->srcAddr >> 6) & 15);
+			} else {
+				entry->framesUntilNextFullHash = entry->numFrames;
+			}
+			rehash = true;
+		} else {
+			entry->framesUntilNextFullHash -= diff;
+		}
+		entry->lastFrame = frame;
+	}
+
+	u32 minihash = VertsMiniHash(src, srcSize);
+	u64 fullHash = entry->fullHash;
+	if (minihash != entry->minihash || rehash) {
+		fullHash = XXH3_64bits(src, srcSize);
+	}
+
+	if (minihash != entry->minihash || fullHash != entry->fullHash) {
+		entry->fullHash = fullHash;
+		entry->minihash = minihash;
+		entry->numFrames = 0;
+		entry->framesUntilNextFullHash = 0;
+		entry->numChanges++;
+		entry->status = entry->numChanges > VERTEX_CACHE_MAX_CHANGES ? DecodedVertsEntry::UNRELIABLE : DecodedVertsEntry::HASHING;
+		decodedVertsCacheBytes_ -= entry->decoded.size();
+		entry->decoded.clear();
+		entry->decoded.shrink_to_fit();
+		return false;
+	}
+
+	if (entry->decoded.empty()) {
+		if (decodedVertsCacheBytes_ + decodedSize > VERTEX_CACHE_MAX_BYTES) {
+			return false;
+		}
+		// Unchanged since last time, so it's probably static. Decode it into the cache.
+		entry->decoded.resize(decodedSize);
+		dec->DecodeVerts(entry->decoded.data(), dv.verts, &dv.uvScale, dv.indexLowerBound, dv.indexUpperBound);
+		decodedVertsCacheBytes_ += decodedSize;
+		entry->status = DecodedVertsEntry::RELIABLE;
+	} else {
+		if (entry->status == DecodedVertsEntry::HASHING) {
+			// Invalidated, but the full hash still matched. Back to checking it on the backoff schedule.
+			entry->status = DecodedVertsEntry::RELIABLE;
+			entry->framesUntilNextFullHash = 0;
+		}
+		gpuStats.numCachedVertsDecoded += count;
+	}
+
+	memcpy(dest, entry->decoded.data(), decodedSize);
+	return true;
+}
+
+void DrawEngineCommon::DecimateDecodedVertsCache() {
+	const int frame = gpuStats.numFlips;
+	const int killAge = decodedVertsCacheBytes_ > VERTEX_CACHE_MAX_BYTES / 2 ? VERTEX_CACHE_KILL_AGE_PRESSURE : VERTEX_CACHE_KILL_AGE;
+
+	std::vector<DecodedVertsKey> toRemove;
+	u32 minAddr = 0xFFFFFFFF;
+	u32 maxAddr = 0;
+	decodedVertsCache_.Iterate([&](const DecodedVertsKey &key, DecodedVertsEntry *entry) {
+		if (frame - entry->lastFrame > killAge) {
+			toRemove.push_back(key);
+		} else {
+			minAddr = std::min(minAddr, entry->srcAddr);
+			maxAddr = std::max(maxAddr, entry->srcAddr + entry->srcSize);
+		}
+	});
+
+	for (const DecodedVertsKey &key : toRemove) {
+		DecodedVertsEntry *entry = decodedVertsCache_.GetOrNull(key);
+		decodedVertsCacheBytes_ -= entry->decoded.size();
+		delete entry;
+		decodedVertsCache_.Remove(key);
+	}
+	decodedVertsCache_.Maintain();
+	decodedVertsCacheMinAddr_ = minAddr;
+	decodedVertsCacheMaxAddr_ = maxAddr;
+}
+
+void DrawEngineCommon::ClearDecodedVertsCache() {
+	decodedVertsCache_.Iterate([&](const DecodedVertsKey &key, DecodedVertsEntry *entry) {
+		delete entry;
+	});
+	decodedVertsCache_.Clear();
+	decodedVertsCacheBytes_ = 0;
+	decodedVertsCacheMinAddr_ = 0xFFFFFFFF;
+	decodedVertsCacheMaxAddr_ = 0;
+}
+
+void DrawEngineCommon::InvalidateDecodedVerts(u32 addr, int size, GPUInvalidationType type) {
+	if (decodedVertsCache_.size() == 0) {
+		return;
+	}
+
+	if (size <= 0) {
+		// Games do this a lot, so we only take it seriously a few times a frame.
+		if (decodedVertsInvalidatedAll_ > 5) {
+			return;
+		}
+		decodedVertsInvalidatedAll_++;
+	} else {
+		addr &= 0x3FFFFFFF;
+		if (addr >= decodedVertsCacheMaxAddr_ || addr + size <= decodedVertsCacheMinAddr_) {
+			return;
+		}
+	}
+
+	decodedVertsCache_.Iterate([&](const DecodedVertsKey &key, DecodedVertsEntry *entry) {
+		if (size > 0 && (addr >= entry->srcAddr + entry->srcSize || addr + size <= entry->srcAddr)) {
+			return;
+		}
+		if (entry->status == DecodedVertsEntry::RELIABLE) {
+			entry->status = DecodedVertsEntry::HASHING;
+		}
+	});
+}
+
 int DrawEngineCommon::DecodeInds() {
 	// Note that this should be able to continue a partial decode - we don't necessarily start from zero here (although we do most of the time).
 
@@ -23,6 +23,7 @@
 #include "Common/Data/Collections/Hashmaps.h"
 
 #include "GPU/Math3D.h"
+#include "GPU/GPUDefinitions.h"
 #include "GPU/GPUState.h"
 #include "GPU/Common/GPUStateUtils.h"
 #include "GPU/Common/IndexGenerator.h"
@@ -166,6 +167,9 @@ class DrawEngineCommon {
 
 	void FlushQueuedDepth();
 
+	// Memory in this range may have changed, so cached decoded vertices from it get rehashed before reuse.
+	void InvalidateDecodedVerts(u32 addr, int size, GPUInvalidationType type);
+
 protected:
 	virtual bool UpdateUseHWTessellation(bool enabled) const { return enabled; }
 	void UpdatePlanes();
@@ -371,4 +375,45 @@ class DrawEngineCommon {
 	std::vector<DepthDraw> depthDraws_;
 
 	double rasterTimeStart_ = 0.0;
+
+	// Decoded vertex cache (optional, see bVertexCache.) Static meshes tend to be drawn from the same
+	// unchanged memory every frame, so we keep their decoded form around and revalidate it with a
+	// backoff, like the texture cache does.
+	struct DecodedVertsKey {
+		const void *verts;
+		u32 vertType;
+		u16 indexLowerBound;
+		u16 indexUpperBound;
+		float uvScale[4];
+	};
+
+	struct DecodedVertsEntry {
+		enum Status : u8 {
+			HASHING,  // Changed recently (or new), check the full hash on every use.
+			RELIABLE,  // Only check the full hash every framesUntilNextFullHash frames.
+			UNRELIABLE,  // Changes too often to be worth caching.
+		};
+
+		std::vector<u8> decoded;
+		u64 fullHash;
+		u32 minihash;
+		u32 srcAddr;
+		u32 srcSize;
+		int lastFrame;
+		int numFrames;
+		int framesUntilNextFullHash;
+		int numChanges;
+		Status status;
+	};
+
+	bool DecodeVertsCached(const VertexDecoder *dec, const DeferredVerts &dv, u8 *dest);
+	void DecimateDecodedVertsCache();
+	void ClearDecodedVertsCache();
+
+	DenseHashMap<DecodedVertsKey, DecodedVertsEntry *> decodedVertsCache_;
+	size_t decodedVertsCacheBytes_ = 0;
+	u32 decodedVertsCacheMinAddr_ = 0xFFFFFFFF;
+	u32 decodedVertsCacheMaxAddr_ = 0;
+	int decodedVertsInvalidatedAll_ = 0;
+	bool useVertexCache_ = false;
 };
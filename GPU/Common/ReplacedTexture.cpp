@@ -25,6 +25,7 @@
 #include "ext/basis_universal/basisu_file_headers.h"
 
 #include "GPU/Common/ReplacedTexture.h"
+#include "GPU/Common/ReplacementArchive.h"
 #include "GPU/Common/TextureReplacer.h"
 
 #include "Common/Data/Format/DDSLoad.h"
@@ -92,7 +93,7 @@ class ReplacedTextureTask : public Task {
 	LimitedWaitable *waitable_;
 };
 
-ReplacedTexture::ReplacedTexture(VFSBackend *vfs, const ReplacementDesc &desc) : vfs_(vfs), desc_(desc) {
+ReplacedTexture::ReplacedTexture(VFSBackend *vfs, ReplacementArchive *archive, const ReplacementDesc &desc) : vfs_(vfs), archive_(archive), desc_(desc) {
 	logId_ = desc.logId;
 }
 
@@ -135,6 +136,7 @@ void ReplacedTexture::PurgeIfNotUsedSinceTime(double t) {
 
 	data_.clear();
 	levels_.clear();
+	mapping_.reset();
 	fmt = Draw::DataFormat::UNDEFINED;
 	alphaStatus_ = ReplacedTextureAlpha::UNKNOWN;
 
@@ -223,25 +225,32 @@ void ReplacedTexture::Prepare(VFSBackend *vfs) {
 			break;
 		}
 
-		VFSFileReference *fileRef = vfs_->GetFile(desc_.filenames[i].c_str());
-		if (!fileRef) {
+		// Images that were decoded when the archive was built are used straight from the mapping.
+		ReplacementArchiveLevel archived;
+		if (archive_ && archive_->FindLevel(desc_.filenames[i], &archived)) {
+			mapping_ = archive_->Mapping();
+			result = LoadArchivedLevelData(archived, i, &pixelFormat);
+		} else {
+			VFSFileReference *fileRef = vfs_->GetFile(desc_.filenames[i].c_str());
+			if (!fileRef) {
+				if (i == 0) {
+					INFO_LOG(Log::TexReplacement, "Texture replacement file '%s' not found in %s", desc_.filenames[i].c_str(), vfs_->toString().c_str());
+					// No file at all. Mark as NOT_FOUND.
+					SetState(ReplacementState::NOT_FOUND);
+					return;
+				}
+				// If the file doesn't exist, let's just bail immediately here.
+				// Mark as DONE, not error.
+				result = LoadLevelResult::DONE;
+				break;
+			}
+
 			if (i == 0) {
-				INFO_LOG(Log::TexReplacement, "Texture replacement file '%s' not found in %s", desc_.filenames[i].c_str(), vfs_->toString().c_str());
-				// No file at all. Mark as NOT_FOUND.
-				SetState(ReplacementState::NOT_FOUND);
-				return;
+				fmt = Draw::DataFormat::R8G8B8A8_UNORM;
 			}
-			// If the file doesn't exist, let's just bail immediately here.
-			// Mark as DONE, not error.
-			result = LoadLevelResult::DONE;
-			break;
-		}
 
-		if (i == 0) {
-			fmt = Draw::DataFormat::R8G8B8A8_UNORM;
+			result = LoadLevelData(fileRef, desc_.filenames[i], i, &pixelFormat);
 		}
-
-		result = LoadLevelData(fileRef, desc_.filenames[i], i, &pixelFormat);
 		if (result == LoadLevelResult::DONE) {
 			// Loaded all the levels we're gonna get.
 			fmt = pixelFormat;
@@ -704,6 +713,35 @@ ReplacedTexture::LoadLevelResult ReplacedTexture::LoadLevelData(VFSFileReference
 	return LoadLevelResult::LOAD_ERROR;
 }
 
+ReplacedTexture::LoadLevelResult ReplacedTexture::LoadArchivedLevelData(const ReplacementArchiveLevel &archived, int mipLevel, Draw::DataFormat *pixelFormat) {
+	if (data_.size() <= mipLevel) {
+		data_.resize(mipLevel + 1);
+	}
+
+	// Same checks as when loading the original image, the archive only saves us the decoding.
+	if (mipLevel != 0) {
+		if (archived.w != std::max(1, (levels_[0].w >> mipLevel)) || archived.h != std::max(1, (levels_[0].h >> mipLevel))) {
+			WARN_LOG(Log::TexReplacement, "Replacement mipmap invalid: size=%dx%d, expected=%dx%d (level %d)",
+				archived.w, archived.h, levels_[0].w >> mipLevel, levels_[0].h >> mipLevel, mipLevel);
+			return LoadLevelResult::LOAD_ERROR;
+		}
+	}
+
+	if (archived.alphaStatus == CHECKALPHA_ANY || mipLevel == 0) {
+		alphaStatus_ = ReplacedTextureAlpha(archived.alphaStatus);
+	}
+
+	ReplacedTextureLevel level;
+	level.w = archived.w;
+	level.h = archived.h;
+	level.mappedData = archived.data;
+	level.mappedSize = archived.size;
+	levels_.push_back(level);
+
+	*pixelFormat = archived.format;
+	return LoadLevelResult::CONTINUE;
+}
+
 bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, int rowPitch) {
 	_assert_msg_((size_t)level < levels_.size(), "Invalid miplevel");
 	_assert_msg_(out != nullptr && rowPitch > 0, "Invalid out/pitch");
@@ -724,9 +762,10 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 	std::lock_guard<std::mutex> guard(lock_);
 
 	const ReplacedTextureLevel &info = levels_[level];
-	const std::vector<uint8_t> &data = data_[level];
+	const uint8_t *data = info.mappedData ? info.mappedData : data_[level].data();
+	const size_t dataSize = info.mappedData ? info.mappedSize : data_[level].size();
 
-	if (data.empty()) {
+	if (dataSize == 0) {
 		WARN_LOG(Log::TexReplacement, "Level %d is empty", level);
 		return false;
 	}
@@ -745,13 +784,13 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 			return false;
 		}
 
-		_assert_msg_(data.size() == info.w * info.h * 4, "Data has wrong size");
+		_assert_msg_(dataSize == info.w * info.h * 4, "Data has wrong size");
 
 		if (rowPitch == info.w * 4) {
 #ifdef PARALLEL_COPY
-			ParallelMemcpy(&g_threadManager, out, data.data(), info.w * 4 * info.h);
+			ParallelMemcpy(&g_threadManager, out, data, info.w * 4 * info.h);
 #else
-			memcpy(out, data.data(), info.w * 4 * info.h);
+			memcpy(out, data, info.w * 4 * info.h);
 #endif
 		} else {
 #ifdef PARALLEL_COPY
@@ -759,7 +798,7 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 			ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
 				int extraPixels = outW - info.w;
 				for (int y = l; y < h; ++y) {
-					memcpy((uint8_t *)out + rowPitch * y, data.data() + info.w * 4 * y, info.w * 4);
+					memcpy((uint8_t *)out + rowPitch * y, data + info.w * 4 * y, info.w * 4);
 					// Fill the rest of the line with black.
 					memset((uint8_t *)out + rowPitch * y + info.w * 4, 0, extraPixels * 4);
 				}
@@ -767,7 +806,7 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 #else
 			int extraPixels = outW - info.w;
 			for (int y = 0; y < info.h; ++y) {
-				memcpy((uint8_t *)out + rowPitch * y, data.data() + info.w * 4 * y, info.w * 4);
+				memcpy((uint8_t *)out + rowPitch * y, data + info.w * 4 * y, info.w * 4);
 				memset((uint8_t *)out + rowPitch * y + info.w * 4, 0, extraPixels * 4);
 			}
 #endif
@@ -782,7 +821,7 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 		// Only parallel copy in the simple case for now.
 		if (info.w == outW && info.h == outH) {
 			// TODO: Add sanity checks here for other formats?
-			ParallelMemcpy(&g_threadManager, out, data.data(), data.size());
+			ParallelMemcpy(&g_threadManager, out, data, dataSize);
 			return true;
 		}
 #endif
@@ -796,7 +835,7 @@ bool ReplacedTexture::CopyLevelTo(int level, uint8_t *out, size_t outDataSize, i
 
 		// Copy all the known blocks, and zero-fill out the lines.
 		for (int y = 0; y < inBlocksH; y++) {
-			const uint8_t *input = data.data() + y * inBlocksW * blockSize;
+			const uint8_t *input = data + y * inBlocksW * blockSize;
 			uint8_t *output = (uint8_t *)out + y * outBlocksW * blockSize;
 			memcpy(output, input, inBlocksW * blockSize);
 			memset(output + inBlocksW * blockSize, 0, paddingBlocksX * blockSize);
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -26,6 +27,9 @@
 
 class TextureReplacer;
 class LimitedWaitable;
+class ReplacementArchive;
+class ReplacementArchiveMapping;
+struct ReplacementArchiveLevel;
 
 // These must match the constants in TextureCacheCommon.
 enum class ReplacedTextureAlpha {
@@ -107,11 +111,15 @@ struct ReplacedTextureLevel {
 	// To be able to reload, we need to be able to reopen, unfortunate we can't use zip_file_t.
 	// TODO: This really belongs on the level in the cache, not in the individual ReplacedTextureLevel objects.
 	VFSFileReference *fileRef = nullptr;
+
+	// Set when the level is used directly from a mapped texture pack archive, instead of from data_.
+	const uint8_t *mappedData = nullptr;
+	size_t mappedSize = 0;
 };
 
 class ReplacedTexture {
 public:
-	ReplacedTexture(VFSBackend *vfs, const ReplacementDesc &desc);
+	ReplacedTexture(VFSBackend *vfs, ReplacementArchive *archive, const ReplacementDesc &desc);
 	~ReplacedTexture();
 
 	inline ReplacementState State() const {
@@ -135,6 +143,7 @@ class ReplacedTexture {
 		return levels_[level].fullDataSize;
 	}
 
+	// Levels mapped from an archive aren't counted, the OS can drop those pages whenever it likes.
 	size_t GetTotalDataSize() const {
 		if (State() != ReplacementState::ACTIVE) {
 			return 0;
@@ -187,6 +196,7 @@ class ReplacedTexture {
 
 	void Prepare(VFSBackend *vfs);
 	LoadLevelResult LoadLevelData(VFSFileReference *fileRef, const std::string &filename, int level, Draw::DataFormat *pixelFormat);
+	LoadLevelResult LoadArchivedLevelData(const ReplacementArchiveLevel &archived, int level, Draw::DataFormat *pixelFormat);
 	void PurgeIfNotUsedSinceTime(double t);
 
 	std::vector<std::vector<uint8_t>> data_;
@@ -202,6 +212,10 @@ class ReplacedTexture {
 	std::atomic<ReplacementState> state_ = ReplacementState::UNLOADED;
 
 	VFSBackend *vfs_ = nullptr;
+	// Same as vfs_ if the pack is an archive, otherwise null.
+	ReplacementArchive *archive_ = nullptr;
+	// Keeps the archive mapped while levels point into it, even if the pack is reloaded.
+	std::shared_ptr<ReplacementArchiveMapping> mapping_;
 	ReplacementDesc desc_;
 
 	friend class TextureReplacer;
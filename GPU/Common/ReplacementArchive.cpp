@@ -0,0 +1,638 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include "ppsspp_config.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#include <png.h>
+
+#if PPSSPP_PLATFORM(WINDOWS)
+#include "Common/CommonWindows.h"
+#include <io.h>
+#elif !PPSSPP_PLATFORM(SWITCH)
+#include <sys/mman.h>
+#endif
+
+#include "ext/xxhash.h"
+
+#include "Common/Data/Format/ZIMLoad.h"
+#include "Common/File/DirListing.h"
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/StringUtils.h"
+#include "GPU/Common/ReplacementArchive.h"
+#include "GPU/Common/TextureDecoder.h"
+
+static const u32 ARCHIVE_MAGIC = 0x41505050;  // "PPPA"
+// Bump this when the file format changes.
+static const u32 ARCHIVE_VERSION = 2;
+static const u64 ARCHIVE_ALIGNMENT = 16;
+
+// Without a mapping we read the whole file, which only makes sense for smaller packs.
+static const u64 MAX_UNMAPPED_SIZE = 0x20000000;
+
+enum class ArchiveEntryType : u32 {
+	// Stored as-is.
+	FILE = 0,
+	// An image decoded to RGBA8888, w * h * 4 bytes.
+	RGBA8888 = 1,
+};
+
+struct ReplacementArchiveHeader {
+	u32 magic;
+	u32 version;
+	u32 numEntries;
+	u32 reserved;
+	u64 indexOffset;
+	u64 namesOffset;
+	u64 namesSize;
+	// From ComputeSourceStamp() on what the archive was built from.
+	u64 sourceStamp;
+};
+
+struct ReplacementArchive::Entry {
+	// Of the name lowercased, with forward slashes. Lookups are case insensitive like in zips.
+	u64 nameHash;
+	u64 dataOffset;
+	u64 dataSize;
+	u32 nameOffset;
+	u32 nameLength;
+	u32 type;
+	u32 w;
+	u32 h;
+	u32 alphaStatus;
+};
+
+class ReplacementArchiveMapping {
+public:
+	~ReplacementArchiveMapping();
+	static std::shared_ptr<ReplacementArchiveMapping> Map(const Path &filename);
+
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+
+private:
+	bool mapped_ = false;
+};
+
+std::shared_ptr<ReplacementArchiveMapping> ReplacementArchiveMapping::Map(const Path &filename) {
+	FILE *f = File::OpenCFile(filename, "rb");
+	if (!f)
+		return nullptr;
+
+	u64 fileSize = File::GetFileSize(f);
+	if (fileSize == 0 || fileSize > (u64)SIZE_MAX) {
+		fclose(f);
+		return nullptr;
+	}
+
+	auto mapping = std::make_shared<ReplacementArchiveMapping>();
+	mapping->size = (size_t)fileSize;
+
+	// Both kinds of mappings stay valid after the file is closed.
+#if PPSSPP_PLATFORM(WINDOWS) && !PPSSPP_PLATFORM(UWP)
+	HANDLE fileHandle = (HANDLE)_get_osfhandle(_fileno(f));
+	HANDLE mappingHandle = CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle) {
+		mapping->data = (const uint8_t *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mappingHandle);
+	}
+#elif !PPSSPP_PLATFORM(WINDOWS) && !PPSSPP_PLATFORM(SWITCH)
+	void *ptr = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (ptr != MAP_FAILED)
+		mapping->data = (const uint8_t *)ptr;
+#endif
+	mapping->mapped_ = mapping->data != nullptr;
+
+	if (!mapping->mapped_ && fileSize <= MAX_UNMAPPED_SIZE) {
+		WARN_LOG(Log::TexReplacement, "Could not map %s, reading it instead", filename.c_str());
+		uint8_t *buffer = new uint8_t[mapping->size];
+		if (fread(buffer, 1, mapping->size, f) == mapping->size) {
+			mapping->data = buffer;
+		} else {
+			delete[] buffer;
+		}
+	}
+	fclose(f);
+
+	if (!mapping->data) {
+		ERROR_LOG(Log::TexReplacement, "Failed to load texture pack archive %s", filename.c_str());
+		return nullptr;
+	}
+	return mapping;
+}
+
+ReplacementArchiveMapping::~ReplacementArchiveMapping() {
+	if (!data)
+		return;
+	if (!mapped_) {
+		delete[] data;
+		return;
+	}
+#if PPSSPP_PLATFORM(WINDOWS) && !PPSSPP_PLATFORM(UWP)
+	UnmapViewOfFile(data);
+#elif !PPSSPP_PLATFORM(WINDOWS) && !PPSSPP_PLATFORM(SWITCH)
+	munmap((void *)data, size);
+#endif
+}
+
+static std::string NormalizeName(std::string_view name) {
+	std::string normalized(name);
+	for (char &c : normalized) {
+		if (c == '\\')
+			c = '/';
+		else if (c >= 'A' && c <= 'Z')
+			c = c - 'A' + 'a';
+	}
+	return normalized;
+}
+
+static u64 HashName(std::string_view name) {
+	std::string normalized = NormalizeName(name);
+	return XXH3_64bits(normalized.data(), normalized.size());
+}
+
+ReplacementArchive *ReplacementArchive::Create(const Path &filename) {
+	if (!File::Exists(filename))
+		return nullptr;
+
+	std::shared_ptr<ReplacementArchiveMapping> mapping = ReplacementArchiveMapping::Map(filename);
+	if (!mapping)
+		return nullptr;
+
+	ReplacementArchive *archive = new ReplacementArchive(filename, mapping);
+	if (!archive->Validate()) {
+		ERROR_LOG(Log::TexReplacement, "Texture pack archive %s is corrupt or from another version, ignoring", filename.c_str());
+		delete archive;
+		return nullptr;
+	}
+	return archive;
+}
+
+bool ReplacementArchive::Validate() {
+	const uint8_t *base = mapping_->data;
+	const u64 size = mapping_->size;
+
+	ReplacementArchiveHeader header;
+	if (size < sizeof(header))
+		return false;
+	memcpy(&header, base, sizeof(header));
+	if (header.magic != ARCHIVE_MAGIC || header.version != ARCHIVE_VERSION)
+		return false;
+
+	// Entries are used in place, so they need to be aligned.
+	if ((header.indexOffset % 8) != 0 || header.indexOffset > size || (u64)header.numEntries * sizeof(Entry) > size - header.indexOffset)
+		return false;
+	if (header.namesOffset > size || header.namesSize > size - header.namesOffset)
+		return false;
+
+	entries_ = (const Entry *)(base + header.indexOffset);
+	numEntries_ = header.numEntries;
+	names_ = (const char *)(base + header.namesOffset);
+	sourceStamp_ = header.sourceStamp;
+
+	// Cheap compared to opening files, and makes everything else safe to trust.
+	for (u32 i = 0; i < numEntries_; ++i) {
+		const Entry &entry = entries_[i];
+		if (i > 0 && entries_[i - 1].nameHash > entry.nameHash)
+			return false;
+		if ((u64)entry.nameOffset + entry.nameLength > header.namesSize)
+			return false;
+		if (entry.dataOffset > size || entry.dataSize > size - entry.dataOffset)
+			return false;
+
+		switch ((ArchiveEntryType)entry.type) {
+		case ArchiveEntryType::FILE:
+			break;
+		case ArchiveEntryType::RGBA8888:
+			if (entry.w == 0 || entry.h == 0 || (u64)entry.w * entry.h * 4 != entry.dataSize)
+				return false;
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string_view ReplacementArchive::EntryName(const Entry &entry) const {
+	return std::string_view(names_ + entry.nameOffset, entry.nameLength);
+}
+
+const ReplacementArchive::Entry *ReplacementArchive::Find(const char *path) const {
+	std::string normalized = NormalizeName(path);
+	u64 hash = XXH3_64bits(normalized.data(), normalized.size());
+
+	const Entry *end = entries_ + numEntries_;
+	const Entry *iter = std::lower_bound(entries_, end, hash, [](const Entry &entry, u64 hash) {
+		return entry.nameHash < hash;
+	});
+	for (; iter != end && iter->nameHash == hash; ++iter) {
+		if (NormalizeName(EntryName(*iter)) == normalized)
+			return iter;
+	}
+	return nullptr;
+}
+
+bool ReplacementArchive::FindLevel(const std::string &filename, ReplacementArchiveLevel *level) const {
+	const Entry *entry = Find(filename.c_str());
+	if (!entry || (ArchiveEntryType)entry->type != ArchiveEntryType::RGBA8888)
+		return false;
+
+	level->data = mapping_->data + entry->dataOffset;
+	level->size = (size_t)entry->dataSize;
+	level->w = entry->w;
+	level->h = entry->h;
+	level->format = Draw::DataFormat::R8G8B8A8_UNORM;
+	level->alphaStatus = (u8)entry->alphaStatus;
+	return true;
+}
+
+class ReplacementArchiveFileReference : public VFSFileReference {
+public:
+	explicit ReplacementArchiveFileReference(u32 i) : index(i) {}
+	u32 index;
+};
+
+class ReplacementArchiveOpenFile : public VFSOpenFile {
+public:
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+	size_t pos = 0;
+};
+
+uint8_t *ReplacementArchive::ReadFile(const char *path, size_t *size) {
+	const Entry *entry = Find(path);
+	if (!entry)
+		return nullptr;
+
+	// Like the other backends, add a zero terminator for text files.
+	uint8_t *contents = new uint8_t[entry->dataSize + 1];
+	memcpy(contents, mapping_->data + entry->dataOffset, (size_t)entry->dataSize);
+	contents[entry->dataSize] = 0;
+	*size = (size_t)entry->dataSize;
+	return contents;
+}
+
+VFSFileReference *ReplacementArchive::GetFile(const char *path) {
+	const Entry *entry = Find(path);
+	if (!entry)
+		return nullptr;
+	return new ReplacementArchiveFileReference((u32)(entry - entries_));
+}
+
+bool ReplacementArchive::GetFileInfo(VFSFileReference *vfsReference, File::FileInfo *fileInfo) {
+	ReplacementArchiveFileReference *reference = (ReplacementArchiveFileReference *)vfsReference;
+	const Entry *entry = &entries_[reference->index];
+	std::string_view name = EntryName(*entry);
+	size_t slash = name.find_last_of('/');
+	fileInfo->name = std::string(slash == name.npos ? name : name.substr(slash + 1));
+	fileInfo->fullName = Path(std::string(name));
+	fileInfo->exists = true;
+	fileInfo->isDirectory = false;
+	fileInfo->isWritable = false;
+	fileInfo->size = entry->dataSize;
+	return true;
+}
+
+void ReplacementArchive::ReleaseFile(VFSFileReference *vfsReference) {
+	ReplacementArchiveFileReference *reference = (ReplacementArchiveFileReference *)vfsReference;
+	delete reference;
+}
+
+VFSOpenFile *ReplacementArchive::OpenFileForRead(VFSFileReference *vfsReference, size_t *size) {
+	ReplacementArchiveFileReference *reference = (ReplacementArchiveFileReference *)vfsReference;
+	const Entry *entry = &entries_[reference->index];
+	ReplacementArchiveOpenFile *openFile = new ReplacementArchiveOpenFile();
+	openFile->data = mapping_->data + entry->dataOffset;
+	openFile->size = (size_t)entry->dataSize;
+	*size = openFile->size;
+	return openFile;
+}
+
+void ReplacementArchive::Rewind(VFSOpenFile *vfsOpenFile) {
+	ReplacementArchiveOpenFile *openFile = (ReplacementArchiveOpenFile *)vfsOpenFile;
+	openFile->pos = 0;
+}
+
+size_t ReplacementArchive::Read(VFSOpenFile *vfsOpenFile, void *buffer, size_t length) {
+	ReplacementArchiveOpenFile *openFile = (ReplacementArchiveOpenFile *)vfsOpenFile;
+	size_t bytes = std::min(length, openFile->size - openFile->pos);
+	memcpy(buffer, openFile->data + openFile->pos, bytes);
+	openFile->pos += bytes;
+	return bytes;
+}
+
+void ReplacementArchive::CloseFile(VFSOpenFile *vfsOpenFile) {
+	ReplacementArchiveOpenFile *openFile = (ReplacementArchiveOpenFile *)vfsOpenFile;
+	delete openFile;
+}
+
+bool ReplacementArchive::GetFileListing(const char *orig_path, std::vector<File::FileInfo> *listing, const char *filter) {
+	std::string path = NormalizeName(orig_path);
+	if (!path.empty() && path.back() != '/')
+		path.push_back('/');
+
+	std::set<std::string> filters;
+	if (filter) {
+		std::vector<std::string_view> parts;
+		SplitString(filter, ':', parts);
+		for (const auto &part : parts)
+			filters.emplace("." + std::string(part));
+	}
+
+	// Rarely used (only when there's no ini), so we just walk all the names like the zip reader.
+	std::set<std::string> files;
+	std::set<std::string> directories;
+	bool anyPrefixMatched = false;
+	for (u32 i = 0; i < numEntries_; ++i) {
+		std::string_view name = EntryName(entries_[i]);
+		if (name.size() <= path.size() || NormalizeName(name.substr(0, path.size())) != path)
+			continue;
+		anyPrefixMatched = true;
+		std::string_view rest = name.substr(path.size());
+		size_t slash = rest.find_first_of("/\\");
+		if (slash != rest.npos)
+			directories.emplace(rest.substr(0, slash));
+		else
+			files.emplace(rest);
+	}
+	if (!anyPrefixMatched)
+		return false;
+
+	listing->clear();
+	listing->reserve(directories.size() + files.size());
+	for (const auto &dir : directories) {
+		File::FileInfo info;
+		info.name = dir;
+		info.fullName = Path(path + dir);
+		info.exists = true;
+		info.isDirectory = true;
+		listing->push_back(info);
+	}
+	for (const auto &file : files) {
+		File::FileInfo info;
+		info.name = file;
+		info.fullName = Path(path + file);
+		info.exists = true;
+		info.isDirectory = false;
+		if (filter && filters.find(info.fullName.GetFileExtension()) == filters.end())
+			continue;
+		listing->push_back(info);
+	}
+	return true;
+}
+
+bool ReplacementArchive::GetFileInfo(const char *path, File::FileInfo *info) {
+	info->isDirectory = false;
+	info->isWritable = false;
+	info->size = 0;
+
+	VFSFileReference *reference = GetFile(path);
+	if (reference) {
+		GetFileInfo(reference, info);
+		ReleaseFile(reference);
+		return true;
+	}
+
+	// Might be a directory.
+	std::vector<File::FileInfo> listing;
+	if (GetFileListing(path, &listing, nullptr)) {
+		info->name = Path(path).GetFilename();
+		info->fullName = Path(path);
+		info->exists = true;
+		info->isDirectory = true;
+		return true;
+	}
+
+	info->exists = false;
+	return false;
+}
+
+// Returns false if the data isn't an image we pre-decode, in which case it's stored as-is.
+static bool DecodeForArchive(const std::string &name, const uint8_t *data, size_t size, std::vector<uint8_t> *out, u32 *w, u32 *h, u32 *alphaStatus) {
+	if (size < 4)
+		return false;
+
+	if (data[0] == 0x89 && memcmp(data + 1, "PNG", 3) == 0) {
+		png_image png = {};
+		png.version = PNG_IMAGE_VERSION;
+		if (!png_image_begin_read_from_memory(&png, data, size)) {
+			WARN_LOG(Log::TexReplacement, "Could not decode %s: %s, storing it as-is", name.c_str(), png.message);
+			return false;
+		}
+		bool hasAlpha = (png.format & PNG_FORMAT_FLAG_ALPHA) != 0;
+		png.format = PNG_FORMAT_RGBA;
+		out->resize((size_t)png.width * png.height * 4);
+		if (!png_image_finish_read(&png, nullptr, out->data(), png.width * 4, nullptr)) {
+			WARN_LOG(Log::TexReplacement, "Could not decode %s: %s, storing it as-is", name.c_str(), png.message);
+			png_image_free(&png);
+			return false;
+		}
+		png_image_free(&png);
+
+		*w = png.width;
+		*h = png.height;
+		*alphaStatus = hasAlpha ? CheckAlpha32Rect((const u32 *)out->data(), png.width, png.width, png.height, 0xFF000000) : CHECKALPHA_FULL;
+	} else if (memcmp(data, "ZIMG", 4) == 0) {
+		int zimW, zimH, flags;
+		uint8_t *image = nullptr;
+		if (!LoadZIMPtr(data, size, &zimW, &zimH, &flags, &image))
+			return false;
+		if ((flags & ZIM_FORMAT_MASK) != ZIM_RGBA8888) {
+			free(image);
+			return false;
+		}
+		out->assign(image, image + (size_t)zimW * zimH * 4);
+		free(image);
+
+		*w = zimW;
+		*h = zimH;
+		*alphaStatus = CheckAlpha32Rect((const u32 *)out->data(), zimW, zimW, zimH, 0xFF000000);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static void CollectFiles(VFSBackend *source, const std::string &path, const std::vector<std::string> &skip, std::vector<std::string> *files) {
+	std::vector<File::FileInfo> listing;
+	if (!source->GetFileListing(path.c_str(), &listing, nullptr))
+		return;
+
+	for (const auto &file : listing) {
+		if (file.name.empty() || file.name[0] == '.')
+			continue;
+		std::string name = path.empty() ? file.name : path + "/" + file.name;
+		if (std::find_if(skip.begin(), skip.end(), [&](const std::string &s) { return equalsNoCase(s, name); }) != skip.end())
+			continue;
+
+		if (file.isDirectory)
+			CollectFiles(source, name, skip, files);
+		else
+			files->push_back(name);
+	}
+}
+
+struct SourceStampInfo {
+	u64 newestMtime;
+	u64 count;
+	u64 totalSize;
+};
+
+static void CollectStampInfo(const Path &root, const std::string &path, const std::vector<std::string> &skip, SourceStampInfo *info) {
+	std::vector<File::FileInfo> listing;
+	if (!File::GetFilesInDir(path.empty() ? root : root / path, &listing))
+		return;
+
+	for (const auto &file : listing) {
+		// Same rules as CollectFiles, so only what gets packed counts.
+		std::string name = path.empty() ? file.name : path + "/" + file.name;
+		if (std::find_if(skip.begin(), skip.end(), [&](const std::string &s) { return equalsNoCase(s, name); }) != skip.end())
+			continue;
+
+		if (file.isDirectory) {
+			CollectStampInfo(root, name, skip, info);
+		} else {
+			info->newestMtime = std::max(info->newestMtime, (u64)file.mtime);
+			info->count++;
+			info->totalSize += file.size;
+		}
+	}
+}
+
+u64 ReplacementArchive::ComputeSourceStamp(const Path &source, const std::vector<std::string> &skipDirs) {
+	SourceStampInfo info{};
+	File::FileInfo fileInfo;
+	if (!File::GetFileInfo(source, &fileInfo) || !fileInfo.exists)
+		return 0;
+	if (fileInfo.isDirectory) {
+		// The count and size catch deleted files, which wouldn't change the newest mtime.
+		CollectStampInfo(source, "", skipDirs, &info);
+	} else {
+		info.newestMtime = fileInfo.mtime;
+		info.count = 1;
+		info.totalSize = fileInfo.size;
+	}
+	if (info.count == 0)
+		return 0;
+	return XXH3_64bits(&info, sizeof(info));
+}
+
+static bool WritePadding(FILE *f, u64 *offset) {
+	static const uint8_t zeroes[ARCHIVE_ALIGNMENT]{};
+	size_t padding = (size_t)((ARCHIVE_ALIGNMENT - (*offset % ARCHIVE_ALIGNMENT)) % ARCHIVE_ALIGNMENT);
+	*offset += padding;
+	return padding == 0 || fwrite(zeroes, 1, padding, f) == padding;
+}
+
+bool ReplacementArchive::Build(VFSBackend *source, const Path &filename, const std::vector<std::string> &skip, u64 sourceStamp, std::string *error) {
+	std::vector<std::string> files;
+	CollectFiles(source, "", skip, &files);
+	if (files.empty()) {
+		*error = "No files to pack";
+		return false;
+	}
+
+	// Write to a temporary file, so a failed build doesn't leave a broken archive behind to be loaded.
+	Path tempFilename = filename.WithExtraExtension(".tmp");
+	FILE *f = File::OpenCFile(tempFilename, "wb");
+	if (!f) {
+		*error = "Could not open " + tempFilename.ToVisualString() + " for writing";
+		return false;
+	}
+
+	ReplacementArchiveHeader header{};
+	bool writeFailed = fwrite(&header, sizeof(header), 1, f) != 1;
+	u64 offset = sizeof(header);
+
+	std::vector<Entry> entries;
+	std::string names;
+	entries.reserve(files.size());
+	int decodedCount = 0;
+	for (const std::string &name : files) {
+		if (writeFailed)
+			break;
+		size_t size = 0;
+		uint8_t *data = source->ReadFile(name.c_str(), &size);
+		if (!data) {
+			WARN_LOG(Log::TexReplacement, "Could not read %s, skipping it", name.c_str());
+			continue;
+		}
+
+		Entry entry{};
+		entry.nameHash = HashName(name);
+		entry.nameOffset = (u32)names.size();
+		entry.nameLength = (u32)name.size();
+		names += name;
+
+		std::vector<uint8_t> decoded;
+		const uint8_t *contents = data;
+		if (DecodeForArchive(name, data, size, &decoded, &entry.w, &entry.h, &entry.alphaStatus)) {
+			entry.type = (u32)ArchiveEntryType::RGBA8888;
+			contents = decoded.data();
+			size = decoded.size();
+			decodedCount++;
+		}
+
+		writeFailed = !WritePadding(f, &offset);
+		entry.dataOffset = offset;
+		entry.dataSize = size;
+		writeFailed = writeFailed || (size != 0 && fwrite(contents, 1, size, f) != size);
+		offset += size;
+		delete[] data;
+
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [&](const Entry &a, const Entry &b) {
+		return a.nameHash < b.nameHash;
+	});
+
+	writeFailed = writeFailed || !WritePadding(f, &offset);
+	header.magic = ARCHIVE_MAGIC;
+	header.version = ARCHIVE_VERSION;
+	header.numEntries = (u32)entries.size();
+	header.indexOffset = offset;
+	header.namesOffset = offset + entries.size() * sizeof(Entry);
+	header.namesSize = names.size();
+	header.sourceStamp = sourceStamp;
+	writeFailed = writeFailed || (!entries.empty() && fwrite(entries.data(), sizeof(Entry), entries.size(), f) != entries.size());
+	writeFailed = writeFailed || (!names.empty() && fwrite(names.data(), 1, names.size(), f) != names.size());
+	writeFailed = writeFailed || fseek(f, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, f) != 1;
+	writeFailed = fclose(f) != 0 || writeFailed;
+
+	if (writeFailed) {
+		*error = "Failed to write " + tempFilename.ToVisualString() + ", disk full?";
+		File::Delete(tempFilename);
+		return false;
+	}
+
+	if (File::Exists(filename))
+		File::Delete(filename);
+	if (!File::Rename(tempFilename, filename)) {
+		*error = "Failed to rename " + tempFilename.ToVisualString();
+		File::Delete(tempFilename);
+		return false;
+	}
+
+	INFO_LOG(Log::TexReplacement, "Wrote texture pack archive %s: %d files, %d pre-decoded, %lld bytes", filename.c_str(), (int)entries.size(), decodedCount, (long long)offset);
+	return true;
+}
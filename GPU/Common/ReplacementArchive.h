@@ -0,0 +1,111 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
+#include "Common/File/VFS/VFS.h"
+#include "Common/GPU/DataFormat.h"
+
+// A texture pack packed into a single file (textures.pack), meant to be memory mapped.
+//
+// Big packs can have tens of thousands of files, and opening them one by one through a directory
+// or zip, then decoding the PNGs, is slow. The archive keeps every file of the pack under its
+// original name, so textures.ini and its aliases work the same, but PNG and ZIM images are stored
+// already decoded to RGBA8888. Those levels are used straight out of the mapping without copying
+// or decoding. Everything else (inis, DDS, KTX2) is stored as-is and read through the VFSBackend
+// interface like from a directory.
+//
+// File layout: header, file data (16-byte aligned), the index sorted by name hash, then the names.
+
+class ReplacementArchiveMapping;
+
+// A pre-decoded level, pointing into the mapped archive.
+struct ReplacementArchiveLevel {
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+	int w = 0;
+	int h = 0;
+	Draw::DataFormat format = Draw::DataFormat::UNDEFINED;
+	// A CheckAlphaResult.
+	u8 alphaStatus = 0;
+};
+
+class ReplacementArchive : public VFSBackend {
+public:
+	// Returns nullptr if the file doesn't exist, or isn't a valid archive.
+	static ReplacementArchive *Create(const Path &filename);
+
+	// Packs all files in source (recursively) into a new archive. Skips directories starting with '.'
+	// and anything in skipDirs, which are relative to the root of source. sourceStamp is stored for
+	// checking later if the archive is out of date, see ComputeSourceStamp().
+	static bool Build(VFSBackend *source, const Path &filename, const std::vector<std::string> &skipDirs, u64 sourceStamp, std::string *error);
+
+	// Changes when a file is added, removed or modified in the directory at source (skipping like
+	// Build), or when the file at source is modified. 0 if there's nothing there.
+	static u64 ComputeSourceStamp(const Path &source, const std::vector<std::string> &skipDirs);
+	// The stamp passed to Build.
+	u64 SourceStamp() const {
+		return sourceStamp_;
+	}
+
+	// Only finds files that were decoded when the archive was built.
+	bool FindLevel(const std::string &filename, ReplacementArchiveLevel *level) const;
+	// Hold on to this while using data from FindLevel, it keeps the file mapped.
+	const std::shared_ptr<ReplacementArchiveMapping> &Mapping() const {
+		return mapping_;
+	}
+
+	// use delete[] on the returned value.
+	uint8_t *ReadFile(const char *path, size_t *size) override;
+
+	VFSFileReference *GetFile(const char *path) override;
+	bool GetFileInfo(VFSFileReference *vfsReference, File::FileInfo *fileInfo) override;
+	void ReleaseFile(VFSFileReference *vfsReference) override;
+
+	VFSOpenFile *OpenFileForRead(VFSFileReference *vfsReference, size_t *size) override;
+	void Rewind(VFSOpenFile *vfsOpenFile) override;
+	size_t Read(VFSOpenFile *vfsOpenFile, void *buffer, size_t length) override;
+	void CloseFile(VFSOpenFile *vfsOpenFile) override;
+
+	bool GetFileListing(const char *path, std::vector<File::FileInfo> *listing, const char *filter) override;
+	bool GetFileInfo(const char *path, File::FileInfo *info) override;
+	std::string toString() const override {
+		return filename_.ToVisualString();
+	}
+
+private:
+	struct Entry;
+
+	ReplacementArchive(const Path &filename, const std::shared_ptr<ReplacementArchiveMapping> &mapping) : filename_(filename), mapping_(mapping) {}
+	bool Validate();
+	const Entry *Find(const char *path) const;
+	std::string_view EntryName(const Entry &entry) const;
+
+	Path filename_;
+	std::shared_ptr<ReplacementArchiveMapping> mapping_;
+	const Entry *entries_ = nullptr;
+	u32 numEntries_ = 0;
+	const char *names_ = nullptr;
+	u64 sourceStamp_ = 0;
+};
@@ -158,6 +158,7 @@ void TextureCacheCommon::StartFrame() {
 		VERBOSE_LOG(Log::G3D, "Scaled %d texels", texelsScaledThisFrame_);
 	}
 	texelsScaledThisFrame_ = 0;
+	texelsDecodedThisFrame_ = 0;
 
 	if (clearCacheNextFrame_) {
 		Clear(true);
@@ -552,6 +553,12 @@ TexCacheEntry *TextureCacheCommon::SetTexture() {
 			}
 		}
 
+		if (match && (entry->status & TexCacheEntry::STATUS_TO_DECODE) && (!g_Config.bAsyncTextureDecode || texelsDecodedThisFrame_ < TEXCACHE_MAX_TEXELS_DECODED)) {
+			// We drew with a small mip or the old contents, now there's time to decode it properly.
+			match = false;
+			reason = "deferred decode";
+		}
+
 		if (match && (entry->status & TexCacheEntry::STATUS_TO_REPLACE) && replacementTimeThisFrame_ < replacementFrameBudgetSeconds_) {
 			int w0 = gstate.getTextureWidth(0);
 			int h0 = gstate.getTextureHeight(0);
@@ -920,6 +927,17 @@ void TextureCacheCommon::HandleTextureChange(TexCacheEntry *const entry, const c
 	entry->numFrames = 0;
 }
 
+bool TextureCacheCommon::CanDeferDecode(const TexCacheEntry *entry, int texels) const {
+	if (!g_Config.bAsyncTextureDecode || texels < TEXCACHE_MIN_TEXELS_DEFERRED) {
+		return false;
+	}
+	// Already waited once, and frequently changing textures would just stay stale.
+	if (entry->status & (TexCacheEntry::STATUS_TO_DECODE | TexCacheEntry::STATUS_CHANGE_FREQUENT | TexCacheEntry::STATUS_VIDEO | TexCacheEntry::STATUS_CLUT_GPU)) {
+		return false;
+	}
+	return texelsDecodedThisFrame_ + texels > TEXCACHE_MAX_TEXELS_DECODED;
+}
+
 void TextureCacheCommon::NotifyFramebuffer(VirtualFramebuffer *framebuffer, FramebufferNotification msg) {
 	const u32 fb_addr = framebuffer->fb_address;
 	const u32 z_addr = framebuffer->z_address;
@@ -1516,7 +1534,7 @@ void TextureCacheCommon::UnswizzleFromMem(u32 *dest, u32 destPitch, const u8 *te
 	// The height is not always aligned to 8, but rounds up.
 	int byc = (height + 7) / 8;
 
-	DoUnswizzleTex16(texptr, dest, bxc, byc, destPitch);
+	ParallelUnswizzleTex16(texptr, dest, bxc, byc, destPitch);
 }
 
 bool TextureCacheCommon::GetCurrentClutBuffer(GPUDebugBuffer &buffer) {
@@ -1690,25 +1708,29 @@ static CheckAlphaResult DecodeDXTBlocks(uint8_t *out, int outPitch, uint32_t tex
 		h = (((int)limited / sizeof(DXTBlock)) / (bufw / 4)) * 4;
 	}
 
+	// Each block row is independent, so big textures are split across threads.
 	u32 alphaSum = 1;
-	for (int y = 0; y < h; y += 4) {
-		u32 blockIndex = (y / 4) * (bufw / 4);
-		int blockHeight = std::min(h - y, 4);
-		for (int x = 0; x < minw; x += 4) {
-			int blockWidth = std::min(minw - x, 4);
-			if constexpr (n == 1)
-				DecodeDXT1Block(dst + outPitch32 * y + x, (const DXT1Block *)src + blockIndex, outPitch32, blockWidth, blockHeight, &alphaSum);
-			else if constexpr (n == 3)
-				DecodeDXT3Block(dst + outPitch32 * y + x, (const DXT3Block *)src + blockIndex, outPitch32, blockWidth, blockHeight);
-			else if constexpr (n == 5)
-				DecodeDXT5Block(dst + outPitch32 * y + x, (const DXT5Block *)src + blockIndex, outPitch32, blockWidth, blockHeight);
-			blockIndex++;
+	ParallelDecode((h + 3) / 4, minw * 4, &alphaSum, [&](int byStart, int byEnd, u32 *rangeAlphaSum) {
+		for (int y = byStart * 4; y < byEnd * 4 && y < h; y += 4) {
+			u32 blockIndex = (y / 4) * (bufw / 4);
+			int blockHeight = std::min(h - y, 4);
+			for (int x = 0; x < minw; x += 4) {
+				int blockWidth = std::min(minw - x, 4);
+				if constexpr (n == 1)
+					DecodeDXT1Block(dst + outPitch32 * y + x, (const DXT1Block *)src + blockIndex, outPitch32, blockWidth, blockHeight, rangeAlphaSum);
+				else if constexpr (n == 3)
+					DecodeDXT3Block(dst + outPitch32 * y + x, (const DXT3Block *)src + blockIndex, outPitch32, blockWidth, blockHeight);
+				else if constexpr (n == 5)
+					DecodeDXT5Block(dst + outPitch32 * y + x, (const DXT5Block *)src + blockIndex, outPitch32, blockWidth, blockHeight);
+				blockIndex++;
+			}
 		}
-	}
 
-	if (reverseColors) {
-		ReverseColors(out, out, GE_TFMT_8888, outPitch32 * h);
-	}
+		if (reverseColors) {
+			int yEnd = std::min(byEnd * 4, h);
+			ReverseColors(out + outPitch * byStart * 4, out + outPitch * byStart * 4, GE_TFMT_8888, outPitch32 * (yEnd - byStart * 4));
+		}
+	});
 
 	if constexpr (n == 1) {
 		return alphaSum == 1 ? CHECKALPHA_FULL : CHECKALPHA_ANY;
@@ -1749,6 +1771,30 @@ static void Expand4To8Bits(u8 *dest, const u8 *src, int srcWidth) {
 	}
 }
 
+template <typename ClutT>
+static void DeIndexTexture4Rows(u8 *out, int outPitch, const u8 *texptr, int bufw, int w, int h, const ClutT *clut, u32 *alphaSum) {
+	const bool simpleIndex = gstate.isClutIndexSimple();
+	ParallelDecode(h, w, alphaSum, [&](int yStart, int yEnd, u32 *rangeAlphaSum) {
+		for (int y = yStart; y < yEnd; ++y) {
+			ClutT *dest = (ClutT *)(out + outPitch * y);
+			const u8 *indexed = texptr + (bufw * y) / 2;
+			if (simpleIndex)
+				DeIndexTexture4Simple(dest, indexed, w, clut, rangeAlphaSum);
+			else
+				DeIndexTexture4<ClutT>(dest, indexed, w, clut, rangeAlphaSum);
+		}
+	});
+}
+
+template <typename ClutT, typename IndexT>
+static void DeIndexTextureRows(u8 *out, int outPitch, const u8 *texptr, int bufw, int w, int h, const ClutT *clut, u32 *alphaSum) {
+	ParallelDecode(h, w, alphaSum, [&](int yStart, int yEnd, u32 *rangeAlphaSum) {
+		for (int y = yStart; y < yEnd; ++y) {
+			DeIndexTexture((ClutT *)(out + outPitch * y), (const IndexT *)texptr + bufw * y, w, clut, rangeAlphaSum);
+		}
+	});
+}
+
 CheckAlphaResult TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, GETextureFormat format, GEPaletteFormat clutformat, uint32_t texaddr, int level, int bufw, TexDecodeFlags flags) {
 	u32 alphaSum = 0xFFFFFFFF;
 	u32 fullAlphaMask = 0x0;
@@ -1835,16 +1881,12 @@ CheckAlphaResult TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, G
 						ConvertFormatToRGBA8888(clutformat, expandClut_, clut, 512);
 					}
 					fullAlphaMask = 0xFF000000;
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4<u32>((u32 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, expandClut_, &alphaSum);
-					}
+					DeIndexTexture4Rows<u32>(out, outPitch, texptr, bufw, w, h, expandClut_, &alphaSum);
 				} else {
 					// If we're reversing colors, the CLUT was already reversed, no special handling needed.
 					const u16 *clut = GetCurrentClut<u16>() + clutSharingOffset;
 					fullAlphaMask = ClutFormatToFullAlpha(clutformat, reverseColors);
-					for (int y = 0; y < h; ++y) {
-						DeIndexTexture4<u16>((u16 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clut, &alphaSum);
-					}
+					DeIndexTexture4Rows<u16>(out, outPitch, texptr, bufw, w, h, clut, &alphaSum);
 				}
 			}
 
@@ -1859,9 +1901,7 @@ CheckAlphaResult TextureCacheCommon::DecodeTextureLevel(u8 *out, int outPitch, G
 		{
 			const u32 *clut = GetCurrentClut<u32>() + clutSharingOffset;
 			fullAlphaMask = 0xFF000000;
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture4<u32>((u32 *)(out + outPitch * y), texptr + (bufw * y) / 2, w, clut, &alphaSum);
-			}
+			DeIndexTexture4Rows<u32>(out, outPitch, texptr, bufw, w, h, clut, &alphaSum);
 		}
 		break;
 
@@ -2014,7 +2054,9 @@ CheckAlphaResult TextureCacheCommon::ReadIndexedTex(u8 *out, int outPitch, int l
 	int w = gstate.getTextureWidth(level);
 	int h = gstate.getTextureHeight(level);
 
-	if (gstate.isTextureSwizzled()) {
+	// Swizzled CLUT8 with plain indexing is common enough to unswizzle and look up in one pass, see below.
+	const bool fusedUnswizzle = gstate.isTextureSwizzled() && bytesPerIndex == 1 && gstate.isClutIndexSimple() && w <= bufw;
+	if (gstate.isTextureSwizzled() && !fusedUnswizzle) {
 		tmpTexBuf32_.resize(bufw * ((h + 7) & ~7));
 		UnswizzleFromMem(tmpTexBuf32_.data(), bufw * bytesPerIndex, texptr, bufw, h, bytesPerIndex);
 		texptr = (u8 *)tmpTexBuf32_.data();
@@ -2054,21 +2096,21 @@ CheckAlphaResult TextureCacheCommon::ReadIndexedTex(u8 *out, int outPitch, int l
 	{
 		switch (bytesPerIndex) {
 		case 1:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut16, &alphaSum);
+			if (fusedUnswizzle) {
+				ParallelDecode((h + 7) / 8, w * 8, &alphaSum, [&](int byStart, int byEnd, u32 *rangeAlphaSum) {
+					DeIndexSwizzledTexture8((u16 *)out, outPitch, texptr, bufw, w, h, byStart, byEnd, clut16, rangeAlphaSum);
+				});
+			} else {
+				DeIndexTextureRows<u16, u8>(out, outPitch, texptr, bufw, w, h, clut16, &alphaSum);
 			}
 			break;
 
 		case 2:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut16, &alphaSum);
-			}
+			DeIndexTextureRows<u16, u16_le>(out, outPitch, texptr, bufw, w, h, clut16, &alphaSum);
 			break;
 
 		case 4:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u16 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut16, &alphaSum);
-			}
+			DeIndexTextureRows<u16, u32_le>(out, outPitch, texptr, bufw, w, h, clut16, &alphaSum);
 			break;
 		}
 	}
@@ -2079,21 +2121,21 @@ CheckAlphaResult TextureCacheCommon::ReadIndexedTex(u8 *out, int outPitch, int l
 
 		switch (bytesPerIndex) {
 		case 1:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u8 *)texptr + bufw * y, w, clut32, &alphaSum);
+			if (fusedUnswizzle) {
+				ParallelDecode((h + 7) / 8, w * 8, &alphaSum, [&](int byStart, int byEnd, u32 *rangeAlphaSum) {
+					DeIndexSwizzledTexture8((u32 *)out, outPitch, texptr, bufw, w, h, byStart, byEnd, clut32, rangeAlphaSum);
+				});
+			} else {
+				DeIndexTextureRows<u32, u8>(out, outPitch, texptr, bufw, w, h, clut32, &alphaSum);
 			}
 			break;
 
 		case 2:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u16_le *)texptr + bufw * y, w, clut32, &alphaSum);
-			}
+			DeIndexTextureRows<u32, u16_le>(out, outPitch, texptr, bufw, w, h, clut32, &alphaSum);
 			break;
 
 		case 4:
-			for (int y = 0; y < h; ++y) {
-				DeIndexTexture((u32 *)(out + outPitch * y), (const u32_le *)texptr + bufw * y, w, clut32, &alphaSum);
-			}
+			DeIndexTextureRows<u32, u32_le>(out, outPitch, texptr, bufw, w, h, clut32, &alphaSum);
 			break;
 		}
 	}
@@ -2163,8 +2205,14 @@ void TextureCacheCommon::ApplyTexture(bool doBind) {
 		// Okay, this matched and didn't change - but let's check the hash.  Maybe it will change.
 		bool doDelete = true;
 		if (!CheckFullHash(entry, doDelete)) {
-			HandleTextureChange(entry, "hash fail", true, doDelete);
-			nextNeedsRebuild_ = true;
+			if (doDelete && entry->texturePtr && CanDeferDecode(entry, gstate.getTextureWidth(0) * gstate.getTextureHeight(0))) {
+				// Keep drawing the old contents this frame, SetTexture will rebuild it later.
+				entry->status |= TexCacheEntry::STATUS_TO_DECODE;
+				gpuStats.numTexturesDeferred++;
+			} else {
+				HandleTextureChange(entry, "hash fail", true, doDelete);
+				nextNeedsRebuild_ = true;
+			}
 		} else if (nextTexture_ != nullptr) {
 			// The secondary cache may choose an entry from its storage by setting nextTexture_.
 			// This means we should set that, instead of our previous entry.
@@ -2623,8 +2671,9 @@ bool TextureCacheCommon::CheckFullHash(TexCacheEntry *entry, bool &doDelete) {
 					nextTexture_ = secondEntry;
 					return true;
 				}
-			} else {
+			} else if ((entry->status & TexCacheEntry::STATUS_TO_DECODE) == 0) {
 				// It wasn't found, so we're about to throw away the entry and rebuild a texture.
+				// Entries still pending a deferred decode don't have contents matching their hash, so they're skipped.
 				// Let's save this in the secondary cache in case it gets used again.
 				secondKey = entry->fullhash | ((u64)entry->cluthash << 32);
 				secondCacheSizeEstimate_ += EstimateTexMemoryUsage(entry);
@@ -2850,6 +2899,25 @@ bool TextureCacheCommon::PrepareBuildTexture(BuildTexturePlan &plan, TexCacheEnt
 
 	bool isPPGETexture = entry->addr >= PSP_GetKernelMemoryBase() && entry->addr < PSP_GetKernelMemoryEnd();
 
+	// With async texture decode, big textures that don't fit in this frame's budget start out as one of
+	// their small mips, and get fully decoded in a later frame (see SetTexture.)
+	// Fake mipmap changes pick their own base level below, so they're always decoded right away.
+	int placeholderLevel = 0;
+	const int fullScaleFactor = plan.scaleFactor;
+	if (!isPPGETexture && !isFakeMipmapChange && !plan.badMipSizes && plan.levelsToLoad > 1 && CanDeferDecode(entry, plan.w * plan.h)) {
+		placeholderLevel = plan.levelsToLoad - 1;
+		for (int i = 1; i < plan.levelsToLoad; i++) {
+			if (gstate.getTextureWidth(i) * gstate.getTextureHeight(i) <= TEXCACHE_PLACEHOLDER_TEXELS) {
+				placeholderLevel = i;
+				break;
+			}
+		}
+		// Scaling waits for the real thing.
+		plan.scaleFactor = 1;
+	} else {
+		texelsDecodedThisFrame_ += plan.w * plan.h;
+	}
+
 	// Don't scale the PPGe texture.
 	if (isPPGETexture) {
 		plan.scaleFactor = 1;
@@ -2922,6 +2990,12 @@ bool TextureCacheCommon::PrepareBuildTexture(BuildTexturePlan &plan, TexCacheEnt
 		// This is the "trigger point" for replacement.
 		plan.replaced = FindReplacement(entry, &plan.w, &plan.h, &plan.depth);
 		plan.doReplace = plan.replaced ? plan.replaced->State() == ReplacementState::ACTIVE : false;
+		if (plan.doReplace && placeholderLevel != 0) {
+			// The replacement is already loaded, no decode to defer. Undo the placeholder setup from above.
+			placeholderLevel = 0;
+			plan.scaleFactor = fullScaleFactor;
+			texelsDecodedThisFrame_ += gstate.getTextureWidth(0) * gstate.getTextureHeight(0);
+		}
 	} else {
 		plan.replaced = nullptr;
 		plan.doReplace = false;
@@ -2940,7 +3014,7 @@ bool TextureCacheCommon::PrepareBuildTexture(BuildTexturePlan &plan, TexCacheEnt
 		// But, we still need to create the texture at a larger size.
 		plan.replaced->GetSize(0, &plan.createW, &plan.createH);
 	} else {
-		if (replacer_.SaveEnabled() && !plan.doReplace && plan.depth == 1 && canReplace) {
+		if (replacer_.SaveEnabled() && !plan.doReplace && plan.depth == 1 && canReplace && placeholderLevel == 0) {
 			ReplacedTextureDecodeInfo replacedInfo;
 			// TODO: Do we handle the race where a replacement becomes valid AFTER this but before we save?
 			replacedInfo.cachekey = entry->CacheKey();
@@ -2973,6 +3047,19 @@ bool TextureCacheCommon::PrepareBuildTexture(BuildTexturePlan &plan, TexCacheEnt
 		_dbg_assert_(plan.depth == 1);
 	}
 
+	if (placeholderLevel != 0) {
+		plan.baseLevelSrc = placeholderLevel;
+		plan.createW = gstate.getTextureWidth(placeholderLevel);
+		plan.createH = gstate.getTextureHeight(placeholderLevel);
+		plan.levelsToCreate = 1;
+		plan.levelsToLoad = 1;
+		// The rebuild with the full texture shouldn't count as a frequent change.
+		entry->status |= TexCacheEntry::STATUS_TO_DECODE | TexCacheEntry::STATUS_FREE_CHANGE;
+		gpuStats.numTexturesDeferred++;
+	} else {
+		entry->status &= ~TexCacheEntry::STATUS_TO_DECODE;
+	}
+
 	if (plan.isVideo || plan.depth != 1 || plan.decodeToClut8) {
 		plan.levelsToLoad = 1;
 		plan.maxPossibleLevels = 1;
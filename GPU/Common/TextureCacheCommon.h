@@ -46,6 +46,12 @@ enum FramebufferNotification {
 #define TEXCACHE_FRAME_CHANGE_FREQUENT_REGAIN_TRUST 33
 
 #define TEXCACHE_MAX_TEXELS_SCALED (256*256)  // Per frame
+// With async texture decode, decodes past this budget are pushed to a later frame.
+#define TEXCACHE_MAX_TEXELS_DECODED (512*512*2)  // Per frame
+// Smaller textures are cheap enough to always decode right away.
+#define TEXCACHE_MIN_TEXELS_DEFERRED (128*128)
+// Largest mip level we're happy to use as a stand-in while the full texture waits.
+#define TEXCACHE_PLACEHOLDER_TEXELS (64*64)
 
 struct VirtualFramebuffer;
 class TextureReplacer;
@@ -172,6 +178,9 @@ struct TexCacheEntry {
 
 		STATUS_VIDEO = 0x10000,
 		STATUS_BGRA = 0x20000,
+
+		// Async texture decode: currently showing a small mip or the previous contents, full decode pending.
+		STATUS_TO_DECODE = 0x40000,
 	};
 
 	// TexStatus enum flag combination.
@@ -416,6 +425,7 @@ class TextureCacheCommon {
 	void ApplyTextureDepal(TexCacheEntry *entry);
 
 	void HandleTextureChange(TexCacheEntry *const entry, const char *reason, bool initialMatch, bool doDelete);
+	bool CanDeferDecode(const TexCacheEntry *entry, int texels) const;
 	virtual void BuildTexture(TexCacheEntry *const entry) = 0;
 	virtual void UpdateCurrentClut(GEPaletteFormat clutFormat, u32 clutBase, bool clutIndexIsSimple) = 0;
 	bool CheckFullHash(TexCacheEntry *entry, bool &doDelete);
@@ -486,7 +496,7 @@ class TextureCacheCommon {
 		gpuStats.numTextureDataBytesHashed += sizeInRAM;
 
 		if (Memory::IsValidAddress(addr + sizeInRAM)) {
-			return StableQuickTexHash(checkp, sizeInRAM);
+			return ParallelQuickTexHash(checkp, sizeInRAM);
 		} else {
 			return 0;
 		}
@@ -510,6 +520,7 @@ class TextureCacheCommon {
 
 	int decimationCounter_;
 	int texelsScaledThisFrame_ = 0;
+	int texelsDecodedThisFrame_ = 0;
 	int timesInvalidatedAllThisFrame_ = 0;
 	double replacementTimeThisFrame_ = 0;
 	// Recomputed once per frame. Depends FPS and soon also config.
@@ -17,17 +17,27 @@
 
 #include "ppsspp_config.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "ext/xxhash.h"
 
 #include "Common/Common.h"
+#include "Common/CPUDetect.h"
 #include "Common/Log.h"
 #include "Common/Math/SIMDHeaders.h"
+#include "Common/Thread/ParallelLoop.h"
 
 #include "GPU/GPUState.h"
 #include "GPU/Common/TextureDecoder.h"
 
 #include "Common/Math/SIMDHeaders.h"
 
+#if PPSSPP_ARCH(SSE2)
+// For the SSE4 stuff.
+#include <smmintrin.h>
+#endif
+
 const u8 textureBitsPerPixel[16] = {
 	16,  //GE_TFMT_5650,
 	16,  //GE_TFMT_5551,
@@ -324,6 +334,281 @@ u32 StableQuickTexHash(const void *checkp, u32 size) {
 #endif
 }
 
+// Below this, spreading the work out costs more than it saves.
+static const u32 PARALLEL_HASH_MIN_SIZE = 256 * 1024;
+static const u32 PARALLEL_HASH_CHUNK_SIZE = 64 * 1024;
+static const int PARALLEL_DECODE_MIN_PIXELS = 256 * 256;
+
+u32 ParallelQuickTexHash(const void *checkp, u32 size) {
+	if (size < PARALLEL_HASH_MIN_SIZE || g_threadManager.GetNumLooperThreads() <= 1) {
+		return StableQuickTexHash(checkp, size);
+	}
+
+	// Chunk size is a multiple of 64 so the SIMD paths still apply, the last one takes the remainder.
+	const int chunks = (int)(size / PARALLEL_HASH_CHUNK_SIZE);
+	u32 chunkHashes[PARALLEL_HASH_MIN_SIZE / PARALLEL_HASH_CHUNK_SIZE * 16];
+	if (chunks > (int)ARRAY_SIZE(chunkHashes)) {
+		return StableQuickTexHash(checkp, size);
+	}
+
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		for (int i = l; i < h; ++i) {
+			u32 chunkSize = i == chunks - 1 ? size - i * PARALLEL_HASH_CHUNK_SIZE : PARALLEL_HASH_CHUNK_SIZE;
+			chunkHashes[i] = StableQuickTexHash((const u8 *)checkp + i * PARALLEL_HASH_CHUNK_SIZE, chunkSize);
+		}
+	}, 0, chunks, 1);
+
+	return XXH32(chunkHashes, chunks * sizeof(u32), 0);
+}
+
+void ParallelDecode(int count, int unitPixels, u32 *outAlphaSum, const std::function<void(int, int, u32 *)> &decode) {
+	if (count * unitPixels < PARALLEL_DECODE_MIN_PIXELS || g_threadManager.GetNumLooperThreads() <= 1) {
+		decode(0, count, outAlphaSum);
+		return;
+	}
+
+	std::atomic<u32> alphaSum(*outAlphaSum);
+	// Keep each piece at least a few thousand pixels.
+	int minUnits = std::max(1, 8192 / std::max(1, unitPixels));
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		u32 localSum = 0xFFFFFFFF;
+		decode(l, h, &localSum);
+		alphaSum.fetch_and(localSum);
+	}, 0, count, minUnits);
+	*outAlphaSum = alphaSum;
+}
+
+void ParallelUnswizzleTex16(const u8 *texptr, u32 *ydestp, int bxc, int byc, u32 pitch) {
+	// Each block row is 8 rows of 16 bytes per block.
+	if (bxc * byc * 128 < PARALLEL_DECODE_MIN_PIXELS * 4 || g_threadManager.GetNumLooperThreads() <= 1) {
+		DoUnswizzleTex16(texptr, ydestp, bxc, byc, pitch);
+		return;
+	}
+
+	ParallelRangeLoop(&g_threadManager, [&](int l, int h) {
+		DoUnswizzleTex16(texptr + l * bxc * 128, (u32 *)((u8 *)ydestp + l * 8 * pitch), bxc, h - l, pitch);
+	}, 0, byc, 8);
+}
+
+#if defined(_M_SSE) && !PPSSPP_ARCH(X86)
+// With 16 colors, each byte of the color can be looked up with a single byte shuffle.
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
+[[gnu::target("sse4.1")]]
+#endif
+static int DeIndexTexture4SimpleSSE4(u32 *dest, const u8 *indexed, int length, const u32 *clut, u32 *outAlphaSum) {
+	alignas(16) u8 planes[4][16];
+	for (int i = 0; i < 16; ++i) {
+		for (int b = 0; b < 4; ++b)
+			planes[b][i] = (u8)(clut[i] >> (b * 8));
+	}
+	const __m128i plane0 = _mm_load_si128((const __m128i *)planes[0]);
+	const __m128i plane1 = _mm_load_si128((const __m128i *)planes[1]);
+	const __m128i plane2 = _mm_load_si128((const __m128i *)planes[2]);
+	const __m128i plane3 = _mm_load_si128((const __m128i *)planes[3]);
+	const __m128i lowMask = _mm_set1_epi8(0x0F);
+
+	__m128i alphaSum = _mm_set1_epi32(-1);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i packed = _mm_loadl_epi64((const __m128i *)(indexed + i / 2));
+		__m128i lo = _mm_and_si128(packed, lowMask);
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), lowMask);
+		// The low nibble is the first pixel.
+		__m128i index = _mm_unpacklo_epi8(lo, hi);
+
+		__m128i c0 = _mm_shuffle_epi8(plane0, index);
+		__m128i c1 = _mm_shuffle_epi8(plane1, index);
+		__m128i c2 = _mm_shuffle_epi8(plane2, index);
+		__m128i c3 = _mm_shuffle_epi8(plane3, index);
+		__m128i c01lo = _mm_unpacklo_epi8(c0, c1);
+		__m128i c01hi = _mm_unpackhi_epi8(c0, c1);
+		__m128i c23lo = _mm_unpacklo_epi8(c2, c3);
+		__m128i c23hi = _mm_unpackhi_epi8(c2, c3);
+
+		__m128i out0 = _mm_unpacklo_epi16(c01lo, c23lo);
+		__m128i out1 = _mm_unpackhi_epi16(c01lo, c23lo);
+		__m128i out2 = _mm_unpacklo_epi16(c01hi, c23hi);
+		__m128i out3 = _mm_unpackhi_epi16(c01hi, c23hi);
+		_mm_storeu_si128((__m128i *)(dest + i + 0), out0);
+		_mm_storeu_si128((__m128i *)(dest + i + 4), out1);
+		_mm_storeu_si128((__m128i *)(dest + i + 8), out2);
+		_mm_storeu_si128((__m128i *)(dest + i + 12), out3);
+		alphaSum = _mm_and_si128(alphaSum, _mm_and_si128(_mm_and_si128(out0, out1), _mm_and_si128(out2, out3)));
+	}
+
+	alphaSum = _mm_and_si128(alphaSum, _mm_srli_si128(alphaSum, 8));
+	alphaSum = _mm_and_si128(alphaSum, _mm_srli_si128(alphaSum, 4));
+	*outAlphaSum &= (u32)_mm_cvtsi128_si32(alphaSum);
+	return i;
+}
+
+#if defined(__GNUC__) || defined(__clang__) || defined(__INTEL_COMPILER)
+[[gnu::target("sse4.1")]]
+#endif
+static int DeIndexTexture4SimpleSSE4(u16 *dest, const u8 *indexed, int length, const u16 *clut, u32 *outAlphaSum) {
+	alignas(16) u8 planes[2][16];
+	for (int i = 0; i < 16; ++i) {
+		planes[0][i] = (u8)clut[i];
+		planes[1][i] = (u8)(clut[i] >> 8);
+	}
+	const __m128i plane0 = _mm_load_si128((const __m128i *)planes[0]);
+	const __m128i plane1 = _mm_load_si128((const __m128i *)planes[1]);
+	const __m128i lowMask = _mm_set1_epi8(0x0F);
+
+	__m128i alphaSum = _mm_set1_epi32(-1);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i packed = _mm_loadl_epi64((const __m128i *)(indexed + i / 2));
+		__m128i lo = _mm_and_si128(packed, lowMask);
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), lowMask);
+		__m128i index = _mm_unpacklo_epi8(lo, hi);
+
+		__m128i c0 = _mm_shuffle_epi8(plane0, index);
+		__m128i c1 = _mm_shuffle_epi8(plane1, index);
+		__m128i out0 = _mm_unpacklo_epi8(c0, c1);
+		__m128i out1 = _mm_unpackhi_epi8(c0, c1);
+		_mm_storeu_si128((__m128i *)(dest + i + 0), out0);
+		_mm_storeu_si128((__m128i *)(dest + i + 8), out1);
+		alphaSum = _mm_and_si128(alphaSum, _mm_and_si128(out0, out1));
+	}
+
+	alphaSum = _mm_and_si128(alphaSum, _mm_srli_si128(alphaSum, 8));
+	alphaSum = _mm_and_si128(alphaSum, _mm_srli_si128(alphaSum, 4));
+	alphaSum = _mm_and_si128(alphaSum, _mm_srli_si128(alphaSum, 2));
+	*outAlphaSum &= (u32)_mm_cvtsi128_si32(alphaSum) & 0xFFFF;
+	return i;
+}
+#endif
+
+#if PPSSPP_ARCH(ARM64_NEON)
+static inline u8 AndLanesNEON(uint8x16_t v) {
+	uint64x2_t v64 = vreinterpretq_u64_u8(v);
+	u64 x = vgetq_lane_u64(v64, 0) & vgetq_lane_u64(v64, 1);
+	x &= x >> 32;
+	x &= x >> 16;
+	x &= x >> 8;
+	return (u8)x;
+}
+
+// Same as the SSE4 version, but the interleaving stores do most of the work.
+static int DeIndexTexture4SimpleNEON(u32 *dest, const u8 *indexed, int length, const u32 *clut, u32 *outAlphaSum) {
+	const uint8x16x4_t planes = vld4q_u8((const u8 *)clut);
+	const uint8x8_t lowMask = vdup_n_u8(0x0F);
+
+	uint8x16x4_t alphaSum;
+	for (int b = 0; b < 4; ++b)
+		alphaSum.val[b] = vdupq_n_u8(0xFF);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		uint8x8_t packed = vld1_u8(indexed + i / 2);
+		uint8x8x2_t zipped = vzip_u8(vand_u8(packed, lowMask), vshr_n_u8(packed, 4));
+		uint8x16_t index = vcombine_u8(zipped.val[0], zipped.val[1]);
+
+		uint8x16x4_t colors;
+		for (int b = 0; b < 4; ++b) {
+			colors.val[b] = vqtbl1q_u8(planes.val[b], index);
+			alphaSum.val[b] = vandq_u8(alphaSum.val[b], colors.val[b]);
+		}
+		vst4q_u8((u8 *)(dest + i), colors);
+	}
+
+	u32 sum = 0;
+	for (int b = 0; b < 4; ++b)
+		sum |= (u32)AndLanesNEON(alphaSum.val[b]) << (b * 8);
+	*outAlphaSum &= sum;
+	return i;
+}
+
+static int DeIndexTexture4SimpleNEON(u16 *dest, const u8 *indexed, int length, const u16 *clut, u32 *outAlphaSum) {
+	const uint8x16x2_t planes = vld2q_u8((const u8 *)clut);
+	const uint8x8_t lowMask = vdup_n_u8(0x0F);
+
+	uint8x16x2_t alphaSum;
+	alphaSum.val[0] = vdupq_n_u8(0xFF);
+	alphaSum.val[1] = vdupq_n_u8(0xFF);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		uint8x8_t packed = vld1_u8(indexed + i / 2);
+		uint8x8x2_t zipped = vzip_u8(vand_u8(packed, lowMask), vshr_n_u8(packed, 4));
+		uint8x16_t index = vcombine_u8(zipped.val[0], zipped.val[1]);
+
+		uint8x16x2_t colors;
+		colors.val[0] = vqtbl1q_u8(planes.val[0], index);
+		colors.val[1] = vqtbl1q_u8(planes.val[1], index);
+		alphaSum.val[0] = vandq_u8(alphaSum.val[0], colors.val[0]);
+		alphaSum.val[1] = vandq_u8(alphaSum.val[1], colors.val[1]);
+		vst2q_u8((u8 *)(dest + i), colors);
+	}
+
+	*outAlphaSum &= (u32)AndLanesNEON(alphaSum.val[0]) | ((u32)AndLanesNEON(alphaSum.val[1]) << 8);
+	return i;
+}
+#endif
+
+template <typename ClutT>
+static void DeIndexTexture4SimpleT(ClutT *dest, const u8 *indexed, int length, const ClutT *clut, u32 *outAlphaSum) {
+	int i = 0;
+#if defined(_M_SSE) && !PPSSPP_ARCH(X86)
+	if (cpu_info.bSSE4_1)
+		i = DeIndexTexture4SimpleSSE4(dest, indexed, length, clut, outAlphaSum);
+#elif PPSSPP_ARCH(ARM64_NEON)
+	i = DeIndexTexture4SimpleNEON(dest, indexed, length, clut, outAlphaSum);
+#endif
+
+	ClutT alphaSum = (ClutT)(-1);
+	for (; i < length; ++i) {
+		u8 index = indexed[i / 2];
+		ClutT color = clut[(i & 1) ? (index >> 4) : (index & 0xF)];
+		alphaSum &= color;
+		dest[i] = color;
+	}
+	*outAlphaSum &= (u32)alphaSum;
+}
+
+void DeIndexTexture4Simple(u32 *dest, const u8 *indexed, int length, const u32 *clut, u32 *outAlphaSum) {
+	DeIndexTexture4SimpleT(dest, indexed, length, clut, outAlphaSum);
+}
+
+void DeIndexTexture4Simple(u16 *dest, const u8 *indexed, int length, const u16 *clut, u32 *outAlphaSum) {
+	DeIndexTexture4SimpleT(dest, indexed, length, clut, outAlphaSum);
+}
+
+template <typename ClutT>
+static void DeIndexSwizzledTexture8T(ClutT *dest, int destPitch, const u8 *texptr, int bufw, int w, int h, int byStart, int byEnd, const ClutT *clut, u32 *outAlphaSum) {
+	// Each block is 16 bytes wide and 8 rows tall, stored contiguously. See UnswizzleFromMem.
+	const int bxc = bufw / 16;
+	const int bxUsed = std::min(bxc, (w + 15) / 16);
+
+	ClutT alphaSum = (ClutT)(-1);
+	for (int by = byStart; by < byEnd; ++by) {
+		const u8 *blockRow = texptr + by * bxc * 128;
+		const int rows = std::min(8, h - by * 8);
+		for (int n = 0; n < rows; ++n) {
+			ClutT *destRow = (ClutT *)((u8 *)dest + (by * 8 + n) * destPitch);
+			const u8 *src = blockRow + n * 16;
+			for (int bx = 0; bx < bxUsed; ++bx) {
+				const int count = std::min(16, w - bx * 16);
+				for (int i = 0; i < count; ++i) {
+					ClutT color = clut[src[i]];
+					alphaSum &= color;
+					destRow[i] = color;
+				}
+				destRow += 16;
+				src += 128;
+			}
+		}
+	}
+	*outAlphaSum &= (u32)alphaSum;
+}
+
+void DeIndexSwizzledTexture8(u32 *dest, int destPitch, const u8 *texptr, int bufw, int w, int h, int byStart, int byEnd, const u32 *clut, u32 *outAlphaSum) {
+	DeIndexSwizzledTexture8T(dest, destPitch, texptr, bufw, w, h, byStart, byEnd, clut, outAlphaSum);
+}
+
+void DeIndexSwizzledTexture8(u16 *dest, int destPitch, const u8 *texptr, int bufw, int w, int h, int byStart, int byEnd, const u16 *clut, u32 *outAlphaSum) {
+	DeIndexSwizzledTexture8T(dest, destPitch, texptr, bufw, w, h, byStart, byEnd, clut, outAlphaSum);
+}
+
 void DoSwizzleTex16(const u32 *ysrcp, u8 *texptr, int bxc, int byc, u32 pitch) {
 	// ysrcp is in 32-bits, so this is convenient.
 	const u32 pitchBy32 = pitch >> 2;
@@ -19,6 +19,8 @@
 
 #include "ppsspp_config.h"
 
+#include <functional>
+
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
 #include "Core/MemMap.h"
@@ -34,8 +36,17 @@ enum CheckAlphaResult {
 // For both of these, pitch must be aligned to 16 bits (as is the case on a PSP).
 void DoSwizzleTex16(const u32 *ysrcp, u8 *texptr, int bxc, int byc, u32 pitch);
 void DoUnswizzleTex16(const u8 *texptr, u32 *ydestp, int bxc, int byc, u32 pitch);
+// Same, but big textures are split by block rows across threads.
+void ParallelUnswizzleTex16(const u8 *texptr, u32 *ydestp, int bxc, int byc, u32 pitch);
 
 u32 StableQuickTexHash(const void *checkp, u32 size);
+// Same idea, but big textures are hashed in fixed size pieces on several threads. The result depends only
+// on the data, not the thread count, but differs from StableQuickTexHash so don't persist it anywhere.
+u32 ParallelQuickTexHash(const void *checkp, u32 size);
+
+// Runs decode(start, end, &alphaSum) over [0, count) rows (or block rows), on several threads if
+// count * unitPixels is big enough to be worth it. The alpha sums are ANDed into outAlphaSum.
+void ParallelDecode(int count, int unitPixels, u32 *outAlphaSum, const std::function<void(int, int, u32 *)> &decode);
 
 // outMask is an in/out parameter.
 void CopyAndSumMask16(u16 *dst, const u16 *src, int width, u32 *outMask);
@@ -224,6 +235,15 @@ inline void DeIndexTexture4OptimalRev(u16 *dest, const u8 *indexed, int length,
 	}
 }
 
+// CLUT4 lookup when the index is simple (no shift, mask or offset.) Uses byte table lookups where available.
+void DeIndexTexture4Simple(u32 *dest, const u8 *indexed, int length, const u32 *clut, u32 *outAlphaSum);
+void DeIndexTexture4Simple(u16 *dest, const u8 *indexed, int length, const u16 *clut, u32 *outAlphaSum);
+
+// Unswizzles and looks up a swizzled CLUT8 texture in one pass, without a temporary buffer.
+// Covers block rows (8 pixel rows each) [byStart, byEnd). Only for simple CLUT indexing.
+void DeIndexSwizzledTexture8(u32 *dest, int destPitch, const u8 *texptr, int bufw, int w, int h, int byStart, int byEnd, const u32 *clut, u32 *outAlphaSum);
+void DeIndexSwizzledTexture8(u16 *dest, int destPitch, const u8 *texptr, int bufw, int w, int h, int byStart, int byEnd, const u16 *clut, u32 *outAlphaSum);
+
 template <typename ClutT>
 inline void DeIndexTexture4(ClutT *dest, const u32 texaddr, int length, const ClutT *clut) {
 	const u8 *indexed = (const u8 *) Memory::GetPointer(texaddr);
@@ -38,16 +38,32 @@
 #include "Core/Config.h"
 #include "Core/System.h"
 #include "Core/ELF/ParamSFO.h"
+#include "GPU/Common/ReplacementArchive.h"
 #include "GPU/Common/TextureReplacer.h"
 #include "GPU/Common/TextureDecoder.h"
 
 static const std::string INI_FILENAME = "textures.ini";
 static const std::string ZIP_FILENAME = "textures.zip";
+static const std::string ARCHIVE_FILENAME = "textures.pack";
 static const std::string NEW_TEXTURE_DIR = "new/";
 static const int VERSION = 1;
 static const double MAX_CACHE_SIZE = 4.0;
 static bool basisu_initialized = false;
 
+// The archive replaces these, and new/ has dumped textures that aren't part of the pack.
+static std::vector<std::string> ArchiveSkipDirs() {
+	return { ARCHIVE_FILENAME, ARCHIVE_FILENAME + ".tmp", ZIP_FILENAME, "new" };
+}
+
+// Of the zip or directory that textures.pack gets built from. Stats every file for directories,
+// which is still far cheaper than what loading them without the archive takes.
+static u64 ArchiveSourceStamp(const Path &texturesDirectory) {
+	Path zipPath = texturesDirectory / ZIP_FILENAME;
+	if (File::Exists(zipPath))
+		return ReplacementArchive::ComputeSourceStamp(zipPath, {});
+	return ReplacementArchive::ComputeSourceStamp(texturesDirectory, ArchiveSkipDirs());
+}
+
 TextureReplacer::TextureReplacer(Draw::DrawContext *draw) {
 	if (!basisu_initialized) {
 		basist::basisu_transcoder_init();
@@ -90,6 +106,7 @@ void TextureReplacer::NotifyConfigChanged() {
 	if (!replaceEnabled_ && wasReplaceEnabled) {
 		delete vfs_;
 		vfs_ = nullptr;
+		archive_ = nullptr;
 		Decimate(ReplacerDecimateMode::ALL);
 	} else if (!wasReplaceEnabled && replaceEnabled_) {
 		std::string error;
@@ -127,20 +144,36 @@ bool TextureReplacer::LoadIni(std::string *error, bool notify) {
 
 	delete vfs_;
 	vfs_ = nullptr;
+	archive_ = nullptr;
 
 	Path zipPath = basePath_ / ZIP_FILENAME;
 
-	// First, check for textures.zip, which is used to reduce IO.
-	VFSBackend *dir = ZipFileReader::Create(zipPath, "", false);
+	// A textures.pack archive is the fastest to load, so it wins over the zip and the directory.
+	// Not when saving though, since then we want to see the changes to the directory.
+	ReplacementArchive *archive = replaceEnabled_ && !saveEnabled_ ? ReplacementArchive::Create(basePath_ / ARCHIVE_FILENAME) : nullptr;
+	if (archive) {
+		// If the pack it was built from is gone (only the archive was shipped), there's nothing to compare.
+		u64 sourceStamp = ArchiveSourceStamp(basePath_);
+		if (sourceStamp != 0 && sourceStamp != archive->SourceStamp()) {
+			WARN_LOG(Log::TexReplacement, "%s is out of date with the texture pack, ignoring it. Rebuild it to load faster.", (basePath_ / ARCHIVE_FILENAME).c_str());
+			delete archive;
+			archive = nullptr;
+		}
+	}
+	VFSBackend *dir = archive;
+	vfsIsZip_ = false;
 	if (!dir) {
-		INFO_LOG(Log::TexReplacement, "%s wasn't a zip file - opening the directory %s instead.", zipPath.c_str(), basePath_.c_str());
-		vfsIsZip_ = false;
-		dir = new DirectoryReader(basePath_);
-	} else {
-		if (!replaceEnabled_ && saveEnabled_) {
-			WARN_LOG(Log::TexReplacement, "Found zip file even though only saving is enabled! This is weird.");
+		// Then check for textures.zip, which is used to reduce IO.
+		dir = ZipFileReader::Create(zipPath, "", false);
+		if (!dir) {
+			INFO_LOG(Log::TexReplacement, "%s wasn't a zip file - opening the directory %s instead.", zipPath.c_str(), basePath_.c_str());
+			dir = new DirectoryReader(basePath_);
+		} else {
+			if (!replaceEnabled_ && saveEnabled_) {
+				WARN_LOG(Log::TexReplacement, "Found zip file even though only saving is enabled! This is weird.");
+			}
+			vfsIsZip_ = true;
 		}
-		vfsIsZip_ = true;
 	}
 
 	IniFile ini;
@@ -207,15 +240,19 @@ bool TextureReplacer::LoadIni(std::string *error, bool notify) {
 	}
 
 	vfs_ = dir;
+	archive_ = archive;
 
 	// If we have stuff loaded from before, need to update the vfs pointers to avoid
 	// crash on exit. The actual problem is that we tend to call LoadIni a little too much...
 	for (auto &repl : levelCache_) {
 		repl.second->vfs_ = vfs_;
+		repl.second->archive_ = archive_;
 	}
 
 	if (replaceEnabled_) {
-		if (vfsIsZip_) {
+		if (archive_) {
+			INFO_LOG(Log::TexReplacement, "Texture pack activated from '%s'", (basePath_ / ARCHIVE_FILENAME).c_str());
+		} else if (vfsIsZip_) {
 			INFO_LOG(Log::TexReplacement, "Texture pack activated from '%s'", (basePath_ / ZIP_FILENAME).c_str());
 		} else {
 			INFO_LOG(Log::TexReplacement, "Texture pack activated from '%s'", basePath_.c_str());
@@ -667,7 +704,7 @@ ReplacedTexture *TextureReplacer::FindReplacement(u64 cachekey, u32 hash, int w,
 	desc.basePath = basePath_;
 	desc.formatSupport = formatSupport_;
 
-	ReplacedTexture *texture = new ReplacedTexture(vfs_, desc);
+	ReplacedTexture *texture = new ReplacedTexture(vfs_, archive_, desc);
 
 	ReplacedTextureRef ref;
 	ref.hashfiles = hashfiles;
@@ -1092,3 +1129,28 @@ ignoreAddress = false    # Reduces duplicates at the cost of making hash less re
 	}
 	return File::Exists(generatedFilename);
 }
+
+bool TextureReplacer::BuildArchive(const std::string &gameID, Path &archiveFilename, std::string *error) {
+	if (gameID.empty()) {
+		*error = "No game running";
+		return false;
+	}
+
+	Path texturesDirectory = GetSysDirectory(DIRECTORY_TEXTURES) / gameID;
+	archiveFilename = texturesDirectory / ARCHIVE_FILENAME;
+
+	// Pack whatever LoadIni would otherwise load. Stamp it first, so changes made during the build make it stale.
+	u64 sourceStamp = ArchiveSourceStamp(texturesDirectory);
+	std::unique_ptr<VFSBackend> source(ZipFileReader::Create(texturesDirectory / ZIP_FILENAME, "", false));
+	std::vector<std::string> skip;
+	if (!source) {
+		if (!File::IsDirectory(texturesDirectory)) {
+			*error = "No texture pack found";
+			return false;
+		}
+		source.reset(new DirectoryReader(texturesDirectory));
+		skip = ArchiveSkipDirs();
+	}
+
+	return ReplacementArchive::Build(source.get(), archiveFilename, skip, sourceStamp, error);
+}
@@ -42,6 +42,7 @@ class TextureReplacer;
 class ReplacedTextureTask;
 class LimitedWaitable;
 class VFSBackend;
+class ReplacementArchive;
 
 struct SavedTextureCacheData {
 	int levelW[8]{};
@@ -122,6 +123,9 @@ class TextureReplacer {
 
 	static bool GenerateIni(const std::string &gameID, Path &generatedFilename);
 	static bool IniExists(const std::string &gameID);
+	// Packs the game's texture directory or zip into a textures.pack archive, which is then preferred.
+	// Slow, call it on a thread.
+	static bool BuildArchive(const std::string &gameID, Path &archiveFilename, std::string *error);
 
 	int GetNumTrackedTextures() const { return (int)cache_.size(); }
 	int GetNumCachedReplacedTextures() const { return (int)levelCache_.size(); }
@@ -161,6 +165,8 @@ class TextureReplacer {
 
 	VFSBackend *vfs_ = nullptr;
 	bool vfsIsZip_ = false;
+	// Same object as vfs_ when loaded from textures.pack.
+	ReplacementArchive *archive_ = nullptr;
 
 	GPUFormatSupport formatSupport_{};
 
@@ -60,6 +60,7 @@ enum class OpType {
 	EnqueueList,
 	ListSync,
 	ReapplyGfxState,
+	NextChunk,
 	Done,
 };
 
@@ -70,6 +71,7 @@ static const char *OpTypeToString(OpType type) {
 	case OpType::EnqueueList: return "EnqueueList";
 	case OpType::ListSync: return "ListSync";
 	case OpType::ReapplyGfxState: return "ReapplyGfxState";
+	case OpType::NextChunk: return "NextChunk";
 	case OpType::Done: return "Done";
 	default: return "N/A";
 	}
@@ -86,6 +88,21 @@ static uint32_t lastExecVersion;
 static std::vector<Command> lastExecCommands;
 static std::vector<u8> lastExecPushbuf;
 
+// Streamed dumps (version 7+) are kept open and read one chunk at a time.
+static u32 lastExecFile = 0;
+static size_t lastExecFirstChunkPos = 0;
+static int lastExecChunk = 0;
+// Where the next replay call picks up, since each call replays one frame of a streamed dump.
+static size_t lastExecResume = 0;
+static int lastExecPasses = 0;
+
+enum class ChunkResult {
+	Error = 0,
+	Next = 1,
+	// Reached the end, and went back to the first chunk.
+	Wrapped = 2,
+};
+
 // This thread is restarted every frame (dump execution) for simplicity. TODO: Make persistent?
 // Alternatively, get rid of it, but the code is written in a way that makes it difficult (you'll see if you try).
 static std::thread replayThread;
@@ -361,6 +378,7 @@ class DumpExecute {
 	ReplayResult Run();
 
 private:
+	ReplayResult RunChunk(size_t start, bool &executedAny);
 	void SyncStall();
 	void SubmitListEnd();
 
@@ -372,6 +390,7 @@ class DumpExecute {
 	void Clut(u32 ptr, u32 sz);
 	void TransferSrc(u32 ptr, u32 sz);
 	void Memset(u32 ptr, u32 sz);
+	void ResetVRAM();
 	void MemcpyDest(u32 ptr, u32 sz);
 	void Memcpy(u32 ptr, u32 sz);
 	void Texture(int level, u32 ptr, u32 sz);
@@ -397,6 +416,8 @@ class DumpExecute {
 	uint32_t version_ = 0;
 
 	int resumeIndex_ = -1;
+	// Streamed dumps end a frame at the first display after something was drawn, same as recording.
+	bool frameHasDraws_ = false;
 };
 
 void DumpExecute::SyncStall() {
@@ -623,6 +644,14 @@ void DumpExecute::Memset(u32 ptr, u32 sz) {
 	}
 }
 
+void DumpExecute::ResetVRAM() {
+	if (!gpu)
+		return;
+	SyncStall();
+	// The recording only captured VRAM it saw as dirty, which assumed a fresh start like this.
+	gpu->PerformMemorySet(PSP_GetVidMemBase(), 0, 2 * 1024 * 1024);
+}
+
 void DumpExecute::MemcpyDest(u32 ptr, u32 sz) {
 	execMemcpyDest = *(const u32 *)(pushbuf_.data() + ptr);
 }
@@ -726,21 +755,77 @@ DumpExecute::~DumpExecute() {
 }
 
 ReplayResult DumpExecute::Run() {
-	// Start with the default value.
-	if (gpu)
-		gpu->SetAddrTranslation(0x400);
+	const bool streamed = version_ >= 7;
+	if (!streamed || (lastExecChunk == 0 && lastExecResume == 0)) {
+		// Start with the default value.
+		if (gpu)
+			gpu->SetAddrTranslation(0x400);
+		// Each pass over a streamed dump should start from the same VRAM as the first did.
+		if (streamed && lastExecPasses > 0)
+			ResetVRAM();
+	} else {
+		// Continuing a streamed dump from the last frame, so pick up the texture state where it left off.
+		for (int i = 0; i < 8; ++i)
+			lastBufw_[i] = gstate.texbufwidth[i] & 0xFFFF;
+	}
 
 	if (resumeIndex_ >= 0) {
 		SyncStall();
 	}
 
-	int start = resumeIndex_ >= 0 ? resumeIndex_ : 0;
+	bool executedAny = false;
+	while (true) {
+		ReplayResult result = RunChunk(streamed ? lastExecResume : (resumeIndex_ >= 0 ? resumeIndex_ : 0), executedAny);
+		if (result == ReplayResult::Error)
+			return result;
+		if (result != ReplayResult::Break || !streamed || g_cancelled)
+			break;
+
+		// Ran out of commands in this chunk without finishing a frame, time for the next one.
+		// Make sure nothing still needs the old chunk's data before replacing it.
+		SyncStall();
+		mapping_.Reset();
+		lastExecResume = 0;
+		ChunkResult next = (ChunkResult)ExecuteOnMain(Operation{ OpType::NextChunk });
+		if (next == ChunkResult::Error) {
+			ERROR_LOG(Log::GeDebugger, "Unable to read next chunk of GE dump");
+			break;
+		}
+		if (next == ChunkResult::Wrapped) {
+			// If we drew anything, this call's frame ended with the dump.  Otherwise start over now.
+			if (executedAny)
+				break;
+			if (gpu)
+				gpu->SetAddrTranslation(0x400);
+			ResetVRAM();
+		}
+	}
+
+	SubmitListEnd();
+
+	if (streamed && lastExecResume >= commands_.size() && !g_cancelled) {
+		// The frame ended right at the end of the chunk, so move on now.  That way reaching the end of
+		// the dump is part of this frame, not the first frame of the next pass.
+		mapping_.Reset();
+		lastExecResume = 0;
+		if ((ChunkResult)ExecuteOnMain(Operation{ OpType::NextChunk }) == ChunkResult::Error)
+			ERROR_LOG(Log::GeDebugger, "Unable to read next chunk of GE dump");
+	}
+	return ReplayResult::Done;
+}
+
+// Returns Break if it reached the end of the chunk, Done if it ended a frame (or the dump), or Error.
+ReplayResult DumpExecute::RunChunk(size_t start, bool &executedAny) {
+	const bool streamed = version_ >= 7;
 	for (size_t i = start; i < commands_.size(); i++) {
 		if (g_cancelled) {
-			break;
+			return ReplayResult::Done;
 		}
+		executedAny = true;
 
 		const Command &cmd = commands_[i];
+		if (cmd.type != CommandType::INIT && cmd.type != CommandType::DISPLAY)
+			frameHasDraws_ = true;
 		switch (cmd.type) {
 		case CommandType::INIT:
 			Init(cmd.ptr, cmd.sz);
@@ -809,6 +894,12 @@ ReplayResult DumpExecute::Run() {
 			break;
 
 		case CommandType::DISPLAY:
+			if (streamed && frameHasDraws_) {
+				// Each frame of a streamed dump gets its own replay call (and flip.)
+				Display(cmd.ptr, cmd.sz, true);
+				lastExecResume = i + 1;
+				return ReplayResult::Done;
+			}
 			Display(cmd.ptr, cmd.sz, i == commands_.size() - 1);
 			break;
 
@@ -818,8 +909,7 @@ ReplayResult DumpExecute::Run() {
 		}
 	}
 
-	SubmitListEnd();
-	return ReplayResult::Done;
+	return streamed ? ReplayResult::Break : ReplayResult::Done;
 }
 
 static bool ReadCompressed(u32 fp, void *dest, size_t sz, uint32_t version) {
@@ -844,12 +934,34 @@ static bool ReadCompressed(u32 fp, void *dest, size_t sz, uint32_t version) {
 	return real_size == sz;
 }
 
+// Reads one set of commands and pushbuf (the entire dump before version 7.)
+static bool ReadChunk(u32 fp, uint32_t version) {
+	u32 sz = 0;
+	if (pspFileSystem.ReadFile(fp, (u8 *)&sz, sizeof(sz)) != sizeof(sz))
+		return false;
+	u32 bufsz = 0;
+	if (pspFileSystem.ReadFile(fp, (u8 *)&bufsz, sizeof(bufsz)) != sizeof(bufsz))
+		return false;
+
+	lastExecCommands.resize(sz);
+	lastExecPushbuf.resize(bufsz);
+
+	bool truncated = false;
+	truncated = truncated || !ReadCompressed(fp, lastExecCommands.data(), sizeof(Command) * sz, version);
+	truncated = truncated || !ReadCompressed(fp, lastExecPushbuf.data(), bufsz, version);
+	return !truncated;
+}
+
 static u32 LoadReplay(const std::string &filename) {
 	PROFILE_THIS_SCOPE("ReplayLoad");
 
 	NOTICE_LOG(Log::GeDebugger, "LoadReplay %s", filename.c_str());
 
 	g_cancelled = false;
+	if (lastExecFile) {
+		pspFileSystem.CloseFile(lastExecFile);
+		lastExecFile = 0;
+	}
 
 	u32 fp = pspFileSystem.OpenFile(filename, FILEACCESS_READ);
 	Header header;
@@ -882,30 +994,54 @@ static u32 LoadReplay(const std::string &filename) {
 		System_SetWindowTitle("(GE frame dump: old format, missing DISC_ID)");
 	}
 
-	u32 sz = 0;
-	pspFileSystem.ReadFile(fp, (u8 *)&sz, sizeof(sz));
-	u32 bufsz = 0;
-	pspFileSystem.ReadFile(fp, (u8 *)&bufsz, sizeof(bufsz));
-
-	lastExecCommands.resize(sz);
-	lastExecPushbuf.resize(bufsz);
-
-	bool truncated = false;
-	truncated = truncated || !ReadCompressed(fp, lastExecCommands.data(), sizeof(Command) * sz, header.version);
-	truncated = truncated || !ReadCompressed(fp, lastExecPushbuf.data(), bufsz, header.version);
-
-	pspFileSystem.CloseFile(fp);
+	size_t firstChunkPos = pspFileSystem.GetSeekPos(fp);
+	bool truncated = !ReadChunk(fp, header.version);
 
 	if (truncated) {
+		pspFileSystem.CloseFile(fp);
 		ERROR_LOG(Log::GeDebugger, "Truncated GE dump detected - can't replay");
 		return 0;
 	}
 
+	if (version >= 7) {
+		// The rest is streamed in as we go.
+		lastExecFile = fp;
+		lastExecFirstChunkPos = firstChunkPos;
+	} else {
+		pspFileSystem.CloseFile(fp);
+	}
+	lastExecChunk = 0;
+	lastExecResume = 0;
+	lastExecPasses = 0;
+
 	lastExecFilename = filename;
 	lastExecVersion = version;
 	return version;
 }
 
+static ChunkResult LoadNextChunk() {
+	if (!lastExecFile)
+		return ChunkResult::Error;
+
+	u32 marker = 0;
+	bool atEnd = pspFileSystem.ReadFile(lastExecFile, (u8 *)&marker, sizeof(marker)) != sizeof(marker);
+	ChunkResult result = ChunkResult::Next;
+	if (atEnd) {
+		lastExecChunk = 0;
+		lastExecPasses++;
+		result = ChunkResult::Wrapped;
+	} else {
+		lastExecChunk++;
+	}
+	pspFileSystem.SeekFile(lastExecFile, atEnd ? (s32)lastExecFirstChunkPos : -(s32)sizeof(marker), atEnd ? FILEMOVE_BEGIN : FILEMOVE_CURRENT);
+
+	if (!ReadChunk(lastExecFile, lastExecVersion)) {
+		ERROR_LOG(Log::GeDebugger, "Truncated GE dump chunk %d", lastExecChunk);
+		return ChunkResult::Error;
+	}
+	return result;
+}
+
 void Replay_Unload() {
 	// We might be paused inside a replay - in this case, the thread is still running and we need to tell it to stop.
 	if (replayThread.joinable()) {
@@ -925,11 +1061,22 @@ void Replay_Unload() {
 	lastExecVersion = 0;
 	lastExecCommands.clear();
 	lastExecPushbuf.clear();
+	if (lastExecFile) {
+		pspFileSystem.CloseFile(lastExecFile);
+		lastExecFile = 0;
+	}
+	lastExecChunk = 0;
+	lastExecResume = 0;
+	lastExecPasses = 0;
 
 	g_opDone = true;
 	g_retVal = 0;
 }
 
+int Replay_PassesCompleted() {
+	return lastExecPasses;
+}
+
 void WriteRunDumpCode(u32 codeStart) {
 	// NOTE: Not static, since parts are run-time computed (MIPS_MAKE_SYSCALL etc)
 	const u32 runDumpCode[] = {
@@ -1037,6 +1184,11 @@ ReplayResult RunMountedReplay(const std::string &filename) {
 		gpu->ReapplyGfxState();
 		return ReplayResult::Break;
 	}
+	case OpType::NextChunk:
+	{
+		g_retVal = (u32)LoadNextChunk();
+		return ReplayResult::Break;
+	}
 	case OpType::ListSync:
 	{
 		u32 execListID = g_opToExec.listID;
@@ -1056,6 +1208,9 @@ ReplayResult RunMountedReplay(const std::string &filename) {
 		}
 		replayThread.join();
 		g_opToExec = { OpType::None };
+		// Older dumps are a single frame, so every replay is a full pass.
+		if (lastExecVersion < 7)
+			lastExecPasses++;
 		break;
 	}
 	case OpType::None:
@@ -34,4 +34,7 @@ ReplayResult RunMountedReplay(const std::string &filename);
 // Will also cancel a currently running replay.
 void Replay_Unload();
 
+// How many times the loaded dump has been replayed all the way through. Updated before the last frame of a pass flips.
+int Replay_PassesCompleted();
+
 }  // namespace GPURecord
@@ -48,6 +48,11 @@
 
 namespace GPURecord {
 
+// Chunks are written out at the end of a frame once they reach this size.
+static const size_t CHUNK_FLUSH_SIZE = 16 * 1024 * 1024;
+// And in the middle of a frame (between prims) if it gets this big.
+static const size_t CHUNK_MAX_SIZE = 64 * 1024 * 1024;
+
 void Recorder::FlushRegisters() {
 	if (!lastRegisters.empty()) {
 		Command last{ CommandType::REGISTERS };
@@ -125,14 +130,51 @@ void Recorder::DirtyDrawnVRAM() {
 	DirtyVRAM(gstate.getFrameBufAddress(), bytes, DirtyVRAMFlag::DRAWN);
 }
 
+static void WriteCompressed(FILE *fp, const void *p, size_t sz) {
+	size_t compressed_size = ZSTD_compressBound(sz);
+	u8 *compressed = new u8[compressed_size];
+	compressed_size = ZSTD_compress(compressed, compressed_size, p, sz, 6);
+
+	u32 write_size = (u32)compressed_size;
+	fwrite(&write_size, sizeof(write_size), 1, fp);
+	fwrite(compressed, compressed_size, 1, fp);
+
+	delete[] compressed;
+}
+
+Recorder::~Recorder() {
+	// Shut down mid-recording, the chunks already written are still usable.
+	if (recordFile)
+		fclose(recordFile);
+}
+
 bool Recorder::BeginRecording() {
 	if (PSP_CoreParameter().fileType == IdentifiedFileType::PPSSPP_GE_DUMP) {
 		// Can't record a GE dump.
 		return false;
 	}
 
+	recordFilename = GenRecordingFilename();
+	NOTICE_LOG(Log::G3D, "Recording filename: %s", recordFilename.c_str());
+
+	recordFile = File::OpenCFile(recordFilename, "wb");
+	if (!recordFile) {
+		ERROR_LOG(Log::G3D, "Unable to open GE dump for writing");
+		nextFrame = false;
+		return false;
+	}
+
+	Header header{};
+	memcpy(header.magic, HEADER_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	strncpy(header.gameID, g_paramSFO.GetDiscID().c_str(), sizeof(header.gameID));
+	fwrite(&header, sizeof(header), 1, recordFile);
+
 	active = true;
 	nextFrame = false;
+	framesLeft = framesToRecord;
+	frameStart = 0;
+	frameFlushedDraws = false;
 	lastTextures.clear();
 	lastRenderTargets.clear();
 	flipLastAction = gpuStats.numFlips;
@@ -160,43 +202,28 @@ bool Recorder::BeginRecording() {
 	return true;
 }
 
-static void WriteCompressed(FILE *fp, const void *p, size_t sz) {
-	size_t compressed_size = ZSTD_compressBound(sz);
-	u8 *compressed = new u8[compressed_size];
-	compressed_size = ZSTD_compress(compressed, compressed_size, p, sz, 6);
-
-	u32 write_size = (u32)compressed_size;
-	fwrite(&write_size, sizeof(write_size), 1, fp);
-	fwrite(compressed, compressed_size, 1, fp);
-
-	delete[] compressed;
-}
-
-Path Recorder::WriteRecording() {
+// Each chunk is self contained (command pointers are relative to its own pushbuf), so the
+// player only needs one in memory at a time.  VRAM tracking carries across chunks.
+void Recorder::FlushChunk() {
 	FlushRegisters();
-
-	const Path filename = GenRecordingFilename();
-
-	NOTICE_LOG(Log::G3D, "Recording filename: %s", filename.c_str());
-
-	FILE *fp = File::OpenCFile(filename, "wb");
-	Header header{};
-	memcpy(header.magic, HEADER_MAGIC, sizeof(header.magic));
-	header.version = VERSION;
-	strncpy(header.gameID, g_paramSFO.GetDiscID().c_str(), sizeof(header.gameID));
-	fwrite(&header, sizeof(header), 1, fp);
+	if (commands.empty())
+		return;
 
 	u32 sz = (u32)commands.size();
-	fwrite(&sz, sizeof(sz), 1, fp);
+	fwrite(&sz, sizeof(sz), 1, recordFile);
 	u32 bufsz = (u32)pushbuf.size();
-	fwrite(&bufsz, sizeof(bufsz), 1, fp);
-
-	WriteCompressed(fp, commands.data(), commands.size() * sizeof(Command));
-	WriteCompressed(fp, pushbuf.data(), bufsz);
+	fwrite(&bufsz, sizeof(bufsz), 1, recordFile);
 
-	fclose(fp);
+	WriteCompressed(recordFile, commands.data(), commands.size() * sizeof(Command));
+	WriteCompressed(recordFile, pushbuf.data(), bufsz);
 
-	return filename;
+	// The frame may continue in the next chunk, so remember if it already drew.
+	if (HasDrawCommands())
+		frameFlushedDraws = true;
+	commands.clear();
+	pushbuf.clear();
+	lastTextures.clear();
+	frameStart = 0;
 }
 
 static void GetVertDataSizes(int vcount, const void *indices, u32 &vbytes, u32 &ibytes) {
@@ -413,14 +440,18 @@ void Recorder::EmitTextureData(int level, u32 texaddr) {
 
 		u32 flags = GetTargetFlags(texaddr, bytes);
 		FramebufData framebuf{ texaddr, bufw, flags };
+		if ((flags & 2) == 0) {
+			UpdateLastVRAM(texaddr, bytes);
+		} else {
+			// Playback already has this in VRAM and won't copy it, so skip the data.
+			bytes = 0;
+		}
 		framebufData.resize(sizeof(framebuf) + bytes);
 		memcpy(&framebufData[0], &framebuf, sizeof(framebuf));
-		memcpy(&framebufData[sizeof(framebuf)], p, bytes);
+		if (bytes != 0)
+			memcpy(&framebufData[sizeof(framebuf)], p, bytes);
 		p = &framebufData[0];
 
-		if ((flags & 2) == 0)
-			UpdateLastVRAM(texaddr, bytes);
-
 		// Okay, now we'll just emit this instead.
 		type = CommandType((int)CommandType::FRAMEBUF0 + level);
 		bytes += (u32)sizeof(framebuf);
@@ -452,6 +483,10 @@ void Recorder::FlushPrimState(int vcount) {
 	// TODO: Eventually, how do we handle texturing from framebuf/zbuf?
 	// TODO: Do we need to preload color/depth/stencil (in case from last frame)?
 
+	// Keep memory bounded even within a single huge frame.
+	if (pushbuf.size() >= CHUNK_MAX_SIZE)
+		FlushChunk();
+
 	lastRenderTargets.insert(PSP_GetVidMemBase() | gstate.getFrameBufRawAddress());
 	lastRenderTargets.insert(PSP_GetVidMemBase() | gstate.getDepthBufRawAddress());
 
@@ -574,9 +609,14 @@ void Recorder::EmitBezierSpline(u32 op) {
 }
 
 bool Recorder::RecordNextFrame(const std::function<void(const Path &)> callback) {
-	if (!nextFrame) {
+	return RecordNextFrames(1, callback);
+}
+
+bool Recorder::RecordNextFrames(int frames, const std::function<void(const Path &)> callback) {
+	if (!nextFrame && !active) {
 		flipLastAction = gpuStats.numFlips;
 		flipFinishAt = -1;
+		framesToRecord = std::max(frames, 1);
 		writeCallback = callback;
 		nextFrame = true;
 		return true;
@@ -584,13 +624,30 @@ bool Recorder::RecordNextFrame(const std::function<void(const Path &)> callback)
 	return false;
 }
 
+void Recorder::EndFrame() {
+	if (--framesLeft > 0) {
+		DEBUG_LOG(Log::System, "Recorded frame, %d left", framesLeft);
+		frameStart = commands.size();
+		frameFlushedDraws = false;
+		if (pushbuf.size() >= CHUNK_FLUSH_SIZE)
+			FlushChunk();
+		return;
+	}
+
+	NOTICE_LOG(Log::System, "Recording complete");
+	FinishRecording();
+}
+
 void Recorder::FinishRecording() {
 	// We're done - this was just to write the result out.
 	if (!active) {
 		return;
 	}
 
-	Path filename = WriteRecording();
+	FlushChunk();
+	fclose(recordFile);
+	recordFile = nullptr;
+	Path filename = recordFilename;
 	commands.clear();
 	pushbuf.clear();
 	lastVRAM.clear();
@@ -731,11 +788,13 @@ void Recorder::NotifyUpload(u32 dest, u32 sz) {
 }
 
 bool Recorder::HasDrawCommands() const {
-	if (commands.empty())
+	if (frameFlushedDraws)
+		return true;
+	if (commands.size() <= frameStart)
 		return false;
 
-	for (const Command &cmd : commands) {
-		switch (cmd.type) {
+	for (size_t i = frameStart; i < commands.size(); ++i) {
+		switch (commands[i].type) {
 		case CommandType::INIT:
 		case CommandType::DISPLAY:
 			continue;
@@ -779,8 +838,8 @@ void Recorder::NotifyDisplay(u32 framebuf, int stride, int fmt) {
 	commands.push_back({ CommandType::DISPLAY, sz, ptr });
 
 	if (writePending) {
-		NOTICE_LOG(Log::System, "Recording complete on display");
-		FinishRecording();
+		VERBOSE_LOG(Log::System, "Recording frame complete on display");
+		EndFrame();
 	}
 }
 
@@ -788,7 +847,7 @@ void Recorder::NotifyBeginFrame() {
 	const bool noDisplayAction = flipLastAction + 4 < gpuStats.numFlips;
 	// We do this only to catch things that don't call NotifyDisplay.
 	if (active && HasDrawCommands() && (noDisplayAction || gpuStats.numFlips == flipFinishAt)) {
-		NOTICE_LOG(Log::System, "Recording complete on frame");
+		VERBOSE_LOG(Log::System, "Recording frame complete on frame");
 
 		CheckEdramTrans();
 		struct DisplayBufData {
@@ -807,7 +866,10 @@ void Recorder::NotifyBeginFrame() {
 
 		commands.push_back({ CommandType::DISPLAY, sz, ptr });
 
-		FinishRecording();
+		EndFrame();
+		// Keep ending frames on BeginFrame.
+		if (active && flipFinishAt != -1)
+			flipFinishAt = gpuStats.numFlips + 1;
 	}
 	if (!active && nextFrame && (gstate_c.skipDrawReason & SKIPDRAW_SKIPFRAME) == 0 && noDisplayAction) {
 		NOTICE_LOG(Log::System, "Recording starting on frame...");
@@ -17,16 +17,16 @@
 
 #pragma once
 
+#include <cstdio>
 #include <functional>
 #include <atomic>
 #include <vector>
 #include <set>
 
 #include "Common/CommonTypes.h"
+#include "Common/File/Path.h"
 #include "GPU/Debugger/RecordFormat.h"
 
-class Path;
-
 namespace GPURecord {
 
 constexpr uint32_t DIRTY_VRAM_SHIFT = 8;
@@ -42,6 +42,8 @@ enum class DirtyVRAMFlag : uint8_t {
 
 class Recorder {
 public:
+	~Recorder();
+
 	bool IsActive() const {
 		return active;
 	}
@@ -49,6 +51,8 @@ class Recorder {
 		return nextFrame || active;
 	}
 	bool RecordNextFrame(const std::function<void(const Path &)> callback);
+	// Data is written out in chunks as it's recorded, so this can cover many frames.
+	bool RecordNextFrames(int frames, const std::function<void(const Path &)> callback);
 	void ClearCallback() {
 		// Not super thread safe..
 		writeCallback = nullptr;
@@ -68,10 +72,11 @@ class Recorder {
 	void DirtyDrawnVRAM();
 
 	bool BeginRecording();
-	Path WriteRecording();
+	void FlushChunk();
 
 	bool HasDrawCommands() const;
 	void CheckEdramTrans();
+	void EndFrame();
 	void FinishRecording();
 
 	Command EmitCommandWithRAM(CommandType t, const void *p, u32 sz, u32 align);
@@ -95,6 +100,14 @@ class Recorder {
 	int flipFinishAt = -1;
 	uint32_t lastEdramTrans = 0x400;
 	std::function<void(const Path &)> writeCallback;
+	int framesToRecord = 1;
+	int framesLeft = 0;
+	// Index into commands where the current frame started.
+	size_t frameStart = 0;
+	// Whether the current frame drew anything in chunks already flushed.
+	bool frameFlushedDraws = false;
+	FILE *recordFile = nullptr;
+	Path recordFilename;
 
 	std::vector<u8> pushbuf;
 	std::vector<Command> commands;
@@ -83,6 +83,7 @@ struct GPUStatistics {
 		numListSyncs = 0;
 		numVertsSubmitted = 0;
 		numVertsDecoded = 0;
+		numCachedVertsDecoded = 0;
 		numUncachedVertsDrawn = 0;
 		numTextureInvalidations = 0;
 		numTextureInvalidationsByFramebuffer = 0;
@@ -92,6 +93,7 @@ struct GPUStatistics {
 		numBBOXJumps = 0;
 		numPlaneUpdates = 0;
 		numTexturesDecoded = 0;
+		numTexturesDeferred = 0;
 		numFramebufferEvaluations = 0;
 		numFBOsCreated = 0;
 		numBlockingReadbacks = 0;
@@ -135,12 +137,14 @@ struct GPUStatistics {
 	int numPlaneUpdates;
 	int numVertsSubmitted;
 	int numVertsDecoded;
+	int numCachedVertsDecoded;
 	int numUncachedVertsDrawn;
 	int numTextureInvalidations;
 	int numTextureInvalidationsByFramebuffer;
 	int numTexturesHashed;
 	int numTextureDataBytesHashed;
 	int numTexturesDecoded;
+	int numTexturesDeferred;
 	int numFramebufferEvaluations;
 	int numFBOsCreated;
 	int numBlockingReadbacks;
@@ -649,7 +649,11 @@ bool GPUCommon::SlowRunLoop(DisplayList &list) {
 		}
 		gstate.cmdmem[cmd] = op;
 
-		ExecuteOp(op, diff);
+		if (drawTimes_) {
+			ExecuteOpTimed(op, diff);
+		} else {
+			ExecuteOp(op, diff);
+		}
 
 		list.pc += 4;
 		--downcount;
@@ -657,6 +661,29 @@ bool GPUCommon::SlowRunLoop(DisplayList &list) {
 	return true;
 }
 
+void GPUCommon::ExecuteOpTimed(u32 op, u32 diff) {
+	u32 cmd = op >> 24;
+	bool isDraw = cmd == GE_CMD_PRIM || cmd == GE_CMD_BEZIER || cmd == GE_CMD_SPLINE;
+	double start = time_now_d();
+	ExecuteOp(op, diff);
+	double elapsed = time_now_d() - start;
+
+	bool flushed = gpuStats.numFlushes != drawTimesFlushes_;
+	drawTimesFlushes_ = gpuStats.numFlushes;
+	if (isDraw) {
+		// A draw flushes what came before it (if anything), so the older draws are done.
+		// Can't tell how much of the time was that flush, so it's all counted for this draw.
+		if (flushed)
+			drawTimesPending_ = drawTimes_->size();
+		drawTimes_->push_back(elapsed);
+	} else if (flushed && drawTimesPending_ < drawTimes_->size()) {
+		double share = elapsed / (double)(drawTimes_->size() - drawTimesPending_);
+		for (size_t i = drawTimesPending_; i < drawTimes_->size(); ++i)
+			(*drawTimes_)[i] += share;
+		drawTimesPending_ = drawTimes_->size();
+	}
+}
+
 // The newPC parameter is used for jumps, we don't count cycles between.
 void GPUCommon::UpdatePC(u32 currentPC, u32 newPC) {
 	// Rough estimate, 2 CPU ticks (it's double the clock rate) per GPU instruction.
@@ -790,7 +817,7 @@ DLResult GPUCommon::ProcessDLQueue() {
 
 			// To enable breakpoints, we don't do fast matrix loads while debugger active.
 			debugRecording_ = recorder_.IsActive();
-			useFastRunLoop_ = !(dumpThisFrame_ || debugRecording_ || NeedsSlowInterpreter() || breakpoints_.HasBreakpoints());
+			useFastRunLoop_ = !(dumpThisFrame_ || debugRecording_ || drawTimes_ || NeedsSlowInterpreter() || breakpoints_.HasBreakpoints());
 		} else {
 			resumingFromDebugBreak_ = false;
 			// The bottom part of the gpuState loop below, that wasn't executed
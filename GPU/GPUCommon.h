@@ -413,6 +413,17 @@ class GPUCommon : public GPUDebugInterface {
 
 	void NotifyFlush();
 
+	// Benchmarking: when set, the time (in seconds) spent on each draw command is appended.
+	// Backends that batch draws do most of the work when flushing, so the time of any command
+	// that flushes is split evenly across the draws it flushed. Flushes outside the command loop
+	// (like at frame end) and work on other threads (like software rendering) aren't counted.
+	// This forces the slow run loop.
+	void SetDrawTimeLog(std::vector<double> *drawTimes) {
+		drawTimes_ = drawTimes;
+		drawTimesPending_ = drawTimes ? drawTimes->size() : 0;
+		drawTimesFlushes_ = gpuStats.numFlushes;
+	}
+
 protected:
 	// While debugging is active, these may block.
 	void NotifyDisplay(u32 framebuf, u32 stride, int format);
@@ -562,7 +573,13 @@ class GPUCommon : public GPUDebugInterface {
 	std::vector<std::pair<int, int>> restrictPrimRanges_;
 	std::string restrictPrimRule_;
 
+	std::vector<double> *drawTimes_ = nullptr;
+	// Index of the first draw in drawTimes_ not yet flushed.
+	size_t drawTimesPending_ = 0;
+	int drawTimesFlushes_ = 0;
+
 private:
+	void ExecuteOpTimed(u32 op, u32 diff);
 	void DoExecuteCall(u32 target);
 	void PopDLQueue();
 	void CheckDrawSync();
@@ -15,9 +15,12 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
 
 #include "Common/Profiler/Profiler.h"
 #include "Common/Thread/ThreadManager.h"
@@ -98,8 +101,8 @@ static inline void DrawBinItem(const BinItem &item, const RasterizerState &state
 
 class DrawBinItemsTask : public Task {
 public:
-	DrawBinItemsTask(BinWaitable *notify, BinManager::BinItemQueue &items, std::atomic<bool> &status, const BinManager::BinStateQueue &states)
-		: notify_(notify), items_(items), status_(status), states_(states) {
+	DrawBinItemsTask(BinWaitable *notify, BinManager *binner, int index)
+		: notify_(notify), binner_(binner), index_(index) {
 	}
 
 	TaskType Type() const override {
@@ -112,10 +115,12 @@ class DrawBinItemsTask : public Task {
 	}
 
 	void Run() override {
-		ProcessItems();
-		status_ = false;
+		DrawQueue(index_, true);
+		binner_->taskStatus_[index_] = false;
 		// In case of any atomic issues, do another pass.
-		ProcessItems();
+		DrawQueue(index_, true);
+		// Help out with any queues whose threads haven't gotten to them yet.
+		StealQueues();
 		notify_->Drain();
 	}
 
@@ -124,20 +129,71 @@ class DrawBinItemsTask : public Task {
 	}
 
 private:
-	void ProcessItems() {
-		while (!items_.Empty()) {
-			const BinItem &item = items_.PeekNext();
-			DrawBinItem(item, states_[item.stateIndex]);
-			items_.SkipNext();
+	// Draws everything in the queue, unless another task is already drawing it and we don't wait.
+	void DrawQueue(int index, bool wait) {
+		std::atomic<bool> &drawing = binner_->taskDrawing_[index];
+		while (drawing.exchange(true)) {
+			if (!wait)
+				return;
+			std::this_thread::yield();
+		}
+
+		BinManager::BinItemQueue &items = binner_->taskQueues_[index];
+		const BinManager::BinStateQueue &states = binner_->states_;
+		double st = coreCollectDebugStats ? time_now_d() : 0.0;
+		int count = 0;
+		while (!items.Empty()) {
+			const BinItem &item = items.PeekNext();
+			DrawBinItem(item, states[item.stateIndex]);
+			items.SkipNext();
+			count++;
+		}
+
+		if (coreCollectDebugStats && count != 0) {
+			binner_->taskBusyTimes_[index] = binner_->taskBusyTimes_[index] + (time_now_d() - st);
+			if (index != index_)
+				binner_->taskSteals_[index] += count;
+		}
+		drawing = false;
+	}
+
+	void StealQueues() {
+		// Only whole queues, since the items in each must be drawn in order.
+		for (int i = 0; i < BinManager::MAX_POSSIBLE_TASKS; ++i) {
+			if (i == index_ || !binner_->taskStatus_[i] || binner_->taskQueues_[i].Empty())
+				continue;
+			DrawQueue(i, false);
 		}
 	}
 
 	BinWaitable *notify_;
-	BinManager::BinItemQueue &items_;
-	std::atomic<bool> &status_;
-	const BinManager::BinStateQueue &states_;
+	BinManager *binner_;
+	int index_;
 };
 
+// Roughly what setting up a primitive costs, in pixels drawn.
+static constexpr float BIN_PRIM_COST = 64.0f;
+
+void BinCostHistogram::Add(int start, int end, float cost) {
+	int b1 = std::clamp(start / BAND_SIZE, 0, BANDS - 1);
+	int b2 = std::clamp(end / BAND_SIZE, 0, BANDS - 1);
+	float perBand = cost / (float)(b2 - b1 + 1);
+	delta[b1] += perBand;
+	delta[b2 + 1] -= perBand;
+}
+
+void BinCostHistogram::AddTo(float *out) const {
+	float sum = 0.0f;
+	for (int i = 0; i < BANDS; ++i) {
+		sum += delta[i];
+		out[i] += sum;
+	}
+}
+
+void BinCostHistogram::Reset() {
+	memset(delta, 0, sizeof(delta));
+}
+
 constexpr int BinManager::MAX_POSSIBLE_TASKS;
 
 BinManager::BinManager() {
@@ -147,14 +203,18 @@ BinManager::BinManager() {
 	queueRange_.y2 = 0;
 
 	waitable_ = new BinWaitable();
-	for (auto &s : taskStatus_)
-		s = false;
+	for (int i = 0; i < MAX_POSSIBLE_TASKS; ++i) {
+		taskStatus_[i] = false;
+		taskDrawing_[i] = false;
+		taskBusyTimes_[i] = 0.0;
+		taskSteals_[i] = 0;
+	}
 
 	int maxInitTasks = std::min(g_threadManager.GetNumLooperThreads(), MAX_POSSIBLE_TASKS);
 	for (int i = 0; i < maxInitTasks; ++i) {
 		taskQueues_[i].Setup();
 		for (DrawBinItemsTask *&task : taskLists_[i].tasks)
-			task = new DrawBinItemsTask(waitable_, taskQueues_[i], taskStatus_[i], states_);
+			task = new DrawBinItemsTask(waitable_, this, i);
 	}
 	states_.Setup();
 	cluts_.Setup();
@@ -188,6 +248,11 @@ void BinManager::UpdateState() {
 	if (lastFlipstats_ != gpuStats.numFlips) {
 		lastFlipstats_ = gpuStats.numFlips;
 		ResetStats();
+
+		lastCostX_ = costX_;
+		lastCostY_ = costY_;
+		costX_.Reset();
+		costY_.Reset();
 	}
 
 	const auto &state = State();
@@ -480,20 +545,23 @@ void BinManager::Drain(bool flushing) {
 		}
 
 		taskRanges_.clear();
+		taskSplits_.clear();
 		if (h2 >= 18 && w2 >= h2 * 4) {
-			int bin_w = std::max(4, (w2 + maxTasks_ - 1) / maxTasks_) * SCREEN_SCALE_FACTOR * 2;
-			taskRanges_.push_back(BinCoords{ tl.x, tl.y, queueRange_.x1 + bin_w - 1, br.y - 1 });
-			for (int x = queueRange_.x1 + bin_w; x <= queueRange_.x2; x += bin_w) {
-				int x2 = x + bin_w > queueRange_.x2 ? br.x : x + bin_w;
-				taskRanges_.push_back(BinCoords{ x, tl.y, x2 - 1, br.y - 1 });
+			SplitRange(costX_, lastCostX_, queueRange_.x1, queueRange_.x2, taskSplits_);
+			int x = tl.x;
+			for (int split : taskSplits_) {
+				taskRanges_.push_back(BinCoords{ x, tl.y, split - 1, br.y - 1 });
+				x = split;
 			}
+			taskRanges_.push_back(BinCoords{ x, tl.y, br.x - 1, br.y - 1 });
 		} else if (h2 >= 18 && w2 >= 18) {
-			int bin_h = std::max(4, (h2 + maxTasks_ - 1) / maxTasks_) * SCREEN_SCALE_FACTOR * 2;
-			taskRanges_.push_back(BinCoords{ tl.x, tl.y, br.x - 1, queueRange_.y1 + bin_h - 1 });
-			for (int y = queueRange_.y1 + bin_h; y <= queueRange_.y2; y += bin_h) {
-				int y2 = y + bin_h > queueRange_.y2 ? br.y : y + bin_h;
-				taskRanges_.push_back(BinCoords{ tl.x, y, br.x - 1, y2 - 1 });
+			SplitRange(costY_, lastCostY_, queueRange_.y1, queueRange_.y2, taskSplits_);
+			int y = tl.y;
+			for (int split : taskSplits_) {
+				taskRanges_.push_back(BinCoords{ tl.x, y, br.x - 1, split - 1 });
+				y = split;
 			}
+			taskRanges_.push_back(BinCoords{ tl.x, y, br.x - 1, br.y - 1 });
 		}
 
 		tasksSplit_ = true;
@@ -557,6 +625,40 @@ void BinManager::Drain(bool flushing) {
 	}
 }
 
+void BinManager::SplitRange(const BinCostHistogram &cost, const BinCostHistogram &lastCost, int start, int end, std::vector<int> &splits) {
+	float bandCosts[BinCostHistogram::BANDS]{};
+	cost.AddTo(bandCosts);
+	lastCost.AddTo(bandCosts);
+
+	const int b1 = std::clamp(start / BinCostHistogram::BAND_SIZE, 0, BinCostHistogram::BANDS - 1);
+	const int b2 = std::clamp(end / BinCostHistogram::BAND_SIZE, 0, BinCostHistogram::BANDS - 1);
+	float total = 0.0f;
+	for (int b = b1; b <= b2; ++b)
+		total += bandCosts[b];
+
+	if (total <= 0.0f) {
+		// Nothing to go on yet, so just split evenly.
+		int quads = (end - start + (SCREEN_SCALE_FACTOR * 2 - 1)) / (SCREEN_SCALE_FACTOR * 2);
+		int size = std::max(4, (quads + maxTasks_ - 1) / maxTasks_) * SCREEN_SCALE_FACTOR * 2;
+		for (int pos = start + size; pos <= end; pos += size)
+			splits.push_back(pos);
+		return;
+	}
+
+	// Cut at band edges whenever we've passed the next even share of the cost.
+	const float share = total / (float)maxTasks_;
+	float next = share;
+	float sum = 0.0f;
+	for (int b = b1; b < b2 && (int)splits.size() < maxTasks_ - 1; ++b) {
+		sum += bandCosts[b];
+		if (sum >= next) {
+			splits.push_back((b + 1) * BinCostHistogram::BAND_SIZE);
+			while (next <= sum)
+				next += share;
+		}
+	}
+}
+
 void BinManager::Flush(const char *reason) {
 	if (queueRange_.x1 == 0x7FFFFFFF)
 		return;
@@ -696,17 +798,37 @@ void BinManager::GetStats(char *buffer, size_t bufsize) {
 		recentTotal += it.second;
 	}
 
-	snprintf(buffer, bufsize,
+	// Utilization is relative to the busiest task, so 100% everywhere means perfectly balanced.
+	double busiest = 0.0;
+	double busyTotal = 0.0;
+	int busyTasks = 0;
+	for (int i = 0; i < MAX_POSSIBLE_TASKS; ++i) {
+		busiest = std::max(busiest, lastTaskBusyTimes_[i]);
+		busyTotal += lastTaskBusyTimes_[i];
+		if (lastTaskBusyTimes_[i] > 0.0)
+			busyTasks++;
+	}
+
+	int len = snprintf(buffer, bufsize,
 		"Slowest individual flush: %s (%0.4f)\n"
 		"Slowest frame flush: %s (%0.4f)\n"
 		"Slowest recent flush: %s (%0.4f)\n"
 		"Total flush time: %0.4f (%05.2f%%, last 2: %05.2f%%)\n"
-		"Thread enqueues: %d, count %d",
+		"Thread enqueues: %d, count %d, steals %d\n"
+		"Thread balance: %05.2f%% (busiest %0.4f)\n"
+		"Thread utilization:",
 		slowestFlushReason_, slowestFlushTime_,
 		slowestTotalReason, slowestTotalTime,
 		slowestRecentReason, slowestRecentTime,
 		allTotal, allTotal * (6000.0 / 1.001), recentTotal * (3000.0 / 1.001),
-		enqueues_, mostThreads_);
+		enqueues_, mostThreads_, lastTaskSteals_,
+		busyTasks == 0 ? 100.0 : busyTotal * 100.0 / (busiest * busyTasks), busiest);
+
+	for (int i = 0; i < MAX_POSSIBLE_TASKS && len > 0 && (size_t)len < bufsize; ++i) {
+		if (lastTaskBusyTimes_[i] <= 0.0)
+			continue;
+		len += snprintf(buffer + len, bufsize - len, " %d%%", (int)(lastTaskBusyTimes_[i] * 100.0 / busiest));
+	}
 }
 
 void BinManager::ResetStats() {
@@ -716,6 +838,13 @@ void BinManager::ResetStats() {
 	slowestFlushTime_ = 0.0;
 	enqueues_ = 0;
 	mostThreads_ = 0;
+
+	lastTaskSteals_ = 0;
+	for (int i = 0; i < MAX_POSSIBLE_TASKS; ++i) {
+		lastTaskBusyTimes_[i] = taskBusyTimes_[i];
+		taskBusyTimes_[i] = 0.0;
+		lastTaskSteals_ += taskSteals_[i].exchange(0);
+	}
 }
 
 inline BinCoords BinCoords::Intersect(const BinCoords &range) const {
@@ -764,6 +893,12 @@ void BinManager::Expand(const BinCoords &range) {
 	queueRange_.x2 = std::max(queueRange_.x2, range.x2);
 	queueRange_.y2 = std::max(queueRange_.y2, range.y2);
 
+	if (maxTasks_ > 1) {
+		float pixels = (float)(range.x2 - range.x1 + 1) * (float)(range.y2 - range.y1 + 1) / (SCREEN_SCALE_FACTOR * SCREEN_SCALE_FACTOR);
+		costX_.Add(range.x1, range.x2, BIN_PRIM_COST + pixels);
+		costY_.Add(range.y1, range.y2, BIN_PRIM_COST + pixels);
+	}
+
 	if (maxTasks_ == 1 || (queueRange_.y2 - queueRange_.y1 >= 224 * SCREEN_SCALE_FACTOR && enqueues_ < 36 * maxTasks_)) {
 		if (pendingOverlap_)
 			Flush("expand");
@@ -182,6 +182,21 @@ struct BinDirtyRange {
 	void Expand(uint32_t newBase, uint32_t bpp, uint32_t stride, const DrawingCoords &tl, const DrawingCoords &br);
 };
 
+// Estimated drawing cost along one screen axis, in 8 pixel bands.  Used to balance taskRanges_.
+struct BinCostHistogram {
+	static constexpr int BAND_SIZE = 8 * SCREEN_SCALE_FACTOR;
+	static constexpr int BANDS = 1024 * SCREEN_SCALE_FACTOR / BAND_SIZE;
+
+	// Spreads cost evenly over the bands covering start to end (screen coords.)
+	void Add(int start, int end, float cost);
+	// Adds the cost of each band to out, which must have BANDS entries.
+	void AddTo(float *out) const;
+	void Reset();
+
+	// Stored as deltas so adding a range is cheap.
+	float delta[BANDS + 1]{};
+};
+
 class BinManager {
 public:
 	BinManager();
@@ -254,6 +269,8 @@ class BinManager {
 	int maxTasks_ = 1;
 	bool tasksSplit_ = false;
 	std::vector<BinCoords> taskRanges_;
+	// Scratch for SplitRange, kept to avoid allocating on each drain.
+	std::vector<int> taskSplits_;
 	BinItemQueue taskQueues_[MAX_POSSIBLE_TASKS];
 	BinTaskList taskLists_[MAX_POSSIBLE_TASKS];
 	std::atomic<bool> taskStatus_[MAX_POSSIBLE_TASKS];
@@ -274,6 +291,20 @@ class BinManager {
 	int enqueues_ = 0;
 	int mostThreads_ = 0;
 
+	// Cost so far this frame, and for all of last frame.
+	BinCostHistogram costX_;
+	BinCostHistogram costY_;
+	BinCostHistogram lastCostX_;
+	BinCostHistogram lastCostY_;
+
+	// Only one task may draw a queue at a time, but it doesn't have to be the task it was enqueued for.
+	std::atomic<bool> taskDrawing_[MAX_POSSIBLE_TASKS];
+	// Only updated while holding taskDrawing_.  Seconds spent drawing each queue, and items drawn by other tasks.
+	std::atomic<double> taskBusyTimes_[MAX_POSSIBLE_TASKS];
+	std::atomic<int> taskSteals_[MAX_POSSIBLE_TASKS];
+	double lastTaskBusyTimes_[MAX_POSSIBLE_TASKS]{};
+	int lastTaskSteals_ = 0;
+
 	void MarkPendingReads(const Rasterizer::RasterizerState &state);
 	void MarkPendingWrites(const Rasterizer::RasterizerState &state);
 	bool HasTextureWrite(const Rasterizer::RasterizerState &state);
@@ -284,6 +315,7 @@ class BinManager {
 	BinCoords Range(const VertexData &v0, const VertexData &v1);
 	BinCoords Range(const VertexData &v0);
 	void Expand(const BinCoords &range);
+	void SplitRange(const BinCostHistogram &cost, const BinCostHistogram &lastCost, int start, int end, std::vector<int> &splits);
 
 	friend class DrawBinItemsTask;
 };
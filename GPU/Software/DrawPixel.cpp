@@ -19,6 +19,7 @@
 #include <mutex>
 #include "Common/Common.h"
 #include "Common/Data/Convert/ColorConv.h"
+#include "Common/Log.h"
 #include "Core/Config.h"
 #include "GPU/Software/BinManager.h"
 #include "GPU/Software/DrawPixel.h"
@@ -800,6 +801,147 @@ SingleFunc PixelJitCache::GenericSingle(const PixelFuncID &id) {
 	return nullptr;
 }
 
+// Clamps and packs four colors to RGBA8888 at once.
+static inline void PackQuadColors(const Vec4<int> *colors, u32 packed[4]) {
+#if defined(_M_SSE)
+	__m128i lo = _mm_packs_epi32(colors[0].ivec, colors[1].ivec);
+	__m128i hi = _mm_packs_epi32(colors[2].ivec, colors[3].ivec);
+	_mm_storeu_si128((__m128i *)packed, _mm_packus_epi16(lo, hi));
+#elif PPSSPP_ARCH(ARM64_NEON)
+	int16x8_t lo = vcombine_s16(vqmovn_s32(colors[0].ivec), vqmovn_s32(colors[1].ivec));
+	int16x8_t hi = vcombine_s16(vqmovn_s32(colors[2].ivec), vqmovn_s32(colors[3].ivec));
+	vst1q_u8((uint8_t *)packed, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+#else
+	for (int i = 0; i < 4; ++i)
+		packed[i] = colors[i].Clamp(0, 255).ToRGBA();
+#endif
+}
+
+template <GEBufferFormat fbFormat>
+void SOFTRAST_CALL DrawQuadPixels(int x, int y, const Vec4<int> &mask, const Vec4<int> &z, const Vec4<int> *colors, const PixelFuncID &pixelID) {
+	Vec4<int> drawMask = mask;
+	// With early Z checks, the rasterizer already applied the depth range.
+	if (pixelID.applyDepthRange && !pixelID.earlyZChecks) {
+		const Vec4<int> minz = Vec4<int>::AssignToAll(pixelID.cached.minz);
+		const Vec4<int> maxz = Vec4<int>::AssignToAll(pixelID.cached.maxz);
+#if defined(_M_SSE)
+		drawMask.ivec = _mm_or_si128(drawMask.ivec, _mm_or_si128(_mm_cmplt_epi32(z.ivec, minz.ivec), _mm_cmpgt_epi32(z.ivec, maxz.ivec)));
+#elif PPSSPP_ARCH(ARM64_NEON)
+		uint32x4_t outside = vorrq_u32(vcltq_s32(z.ivec, minz.ivec), vcgtq_s32(z.ivec, maxz.ivec));
+		drawMask.ivec = vorrq_s32(drawMask.ivec, vreinterpretq_s32_u32(outside));
+#else
+		for (int i = 0; i < 4; ++i) {
+			if (z[i] < minz[i] || z[i] > maxz[i])
+				drawMask[i] = -1;
+		}
+#endif
+	}
+
+	u32 packed[4];
+	PackQuadColors(colors, packed);
+
+	// No stencil test means the old stencil (alpha) bits are always kept.
+	const int fbStride = pixelID.cached.framebufStride;
+	for (int i = 0; i < 4; ++i) {
+		if (drawMask[i] < 0)
+			continue;
+		const int px = x + (i & 1);
+		const int py = y + (i / 2);
+
+		if (pixelID.depthWrite)
+			SetPixelDepth(px, py, pixelID.cached.depthbufStride, z[i]);
+
+		switch (fbFormat) {
+		case GE_FORMAT_565:
+			fb.Set16(px, py, fbStride, RGBA8888ToRGB565(packed[i]));
+			break;
+		case GE_FORMAT_5551:
+			fb.Set16(px, py, fbStride, (RGBA8888ToRGBA5551(packed[i]) & 0x7FFF) | (fb.Get16(px, py, fbStride) & 0x8000));
+			break;
+		case GE_FORMAT_4444:
+			fb.Set16(px, py, fbStride, (RGBA8888ToRGBA4444(packed[i]) & 0x0FFF) | (fb.Get16(px, py, fbStride) & 0xF000));
+			break;
+		case GE_FORMAT_8888:
+			fb.Set32(px, py, fbStride, (packed[i] & 0x00FFFFFF) | (fb.Get32(px, py, fbStride) & 0xFF000000));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+QuadFunc GetQuadFunc(const PixelFuncID &id) {
+	// Anything that tests, blends, or otherwise reads back per pixel stays with the single funcs.
+	if (id.clearMode || id.AlphaTestFunc() != GE_COMP_ALWAYS || id.colorTest || id.stencilTest || id.applyFog)
+		return nullptr;
+	if (id.alphaBlend || id.dithering || id.applyLogicOp || id.applyColorWriteMask)
+		return nullptr;
+	// Depth testing is only handled as part of the rasterizer's early Z checks.
+	if (id.DepthTestFunc() != GE_COMP_ALWAYS && !id.earlyZChecks)
+		return nullptr;
+
+	switch (id.fbFormat) {
+	case GE_FORMAT_565:
+		return &DrawQuadPixels<GE_FORMAT_565>;
+	case GE_FORMAT_5551:
+		return &DrawQuadPixels<GE_FORMAT_5551>;
+	case GE_FORMAT_4444:
+		return &DrawQuadPixels<GE_FORMAT_4444>;
+	case GE_FORMAT_8888:
+		return &DrawQuadPixels<GE_FORMAT_8888>;
+	}
+	return nullptr;
+}
+
+bool VerifyQuadPixels(QuadFunc quadFunc, SingleFunc singleFunc, int x, int y, const Vec4<int> &mask, const Vec4<int> &z, const Vec4<int> *colors, const PixelFuncID &pixelID) {
+	const bool is32 = pixelID.FBFormat() == GE_FORMAT_8888;
+	const int fbStride = pixelID.cached.framebufStride;
+	const int zStride = pixelID.cached.depthbufStride;
+
+	auto save = [&](u32 color[4], u16 depth[4]) {
+		for (int i = 0; i < 4; ++i) {
+			const int px = x + (i & 1);
+			const int py = y + (i / 2);
+			color[i] = is32 ? fb.Get32(px, py, fbStride) : fb.Get16(px, py, fbStride);
+			depth[i] = depthbuf.Get16(px, py, zStride);
+		}
+	};
+	auto restore = [&](const u32 color[4], const u16 depth[4]) {
+		for (int i = 0; i < 4; ++i) {
+			const int px = x + (i & 1);
+			const int py = y + (i / 2);
+			if (is32)
+				fb.Set32(px, py, fbStride, color[i]);
+			else
+				fb.Set16(px, py, fbStride, (u16)color[i]);
+			depthbuf.Set16(px, py, zStride, depth[i]);
+		}
+	};
+
+	u32 origColor[4], quadColor[4], singleColor[4];
+	u16 origDepth[4], quadDepth[4], singleDepth[4];
+	save(origColor, origDepth);
+	quadFunc(x, y, mask, z, colors, pixelID);
+	save(quadColor, quadDepth);
+	restore(origColor, origDepth);
+
+	// Quad funcs never apply fog, so the fog value doesn't matter.
+	for (int i = 0; i < 4; ++i) {
+		if (mask[i] >= 0)
+			singleFunc(x + (i & 1), y + (i / 2), z[i], 255, ToVec4IntArg(colors[i]), pixelID);
+	}
+	save(singleColor, singleDepth);
+
+	bool match = true;
+	for (int i = 0; i < 4; ++i) {
+		if (quadColor[i] != singleColor[i] || quadDepth[i] != singleDepth[i]) {
+			ERROR_LOG(Log::G3D, "Quad pixel mismatch at %d,%d: %08x/%04x, expected %08x/%04x", x + (i & 1), y + (i / 2), quadColor[i], quadDepth[i], singleColor[i], singleDepth[i]);
+			match = false;
+		}
+	}
+	return match;
+}
+
 thread_local PixelJitCache::LastCache PixelJitCache::lastSingle_;
 int PixelJitCache::clearGen_ = 0;
 
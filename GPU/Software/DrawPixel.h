@@ -42,6 +42,14 @@ namespace Rasterizer {
 typedef void (SOFTRAST_CALL *SingleFunc)(int x, int y, int z, int fog, Vec4IntArg color_in, const PixelFuncID &pixelID);
 SingleFunc GetSingleFunc(const PixelFuncID &id, BinManager *binner);
 
+// Draws the unmasked pixels of a 2x2 quad at (x, y) in one go.  Lanes are ordered like the rasterizer's quads.
+// Only simple opaque states have one (no tests, blending, fog, etc.), otherwise GetQuadFunc() returns nullptr.
+typedef void (SOFTRAST_CALL *QuadFunc)(int x, int y, const Math3D::Vec4<int> &mask, const Math3D::Vec4<int> &z, const Math3D::Vec4<int> *colors, const PixelFuncID &pixelID);
+QuadFunc GetQuadFunc(const PixelFuncID &id);
+// Runs both the quad func and the single func on the same pixels, leaving the single func's result.
+// Returns false (and logs) if they disagree.
+bool VerifyQuadPixels(QuadFunc quadFunc, SingleFunc singleFunc, int x, int y, const Math3D::Vec4<int> &mask, const Math3D::Vec4<int> &z, const Math3D::Vec4<int> *colors, const PixelFuncID &pixelID);
+
 void Init();
 void FlushJit();
 void Shutdown();
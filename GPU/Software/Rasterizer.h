@@ -27,6 +27,8 @@
 #define SOFTGPU_MEMORY_TAGGING_BASIC
 #endif
 // #define SOFTGPU_MEMORY_TAGGING_DETAILED
+// Runs the single pixel funcs after each quad func and logs any differences.
+// #define SOFTGPU_VERIFY_QUAD_PIXELS
 
 struct GPUDebugBuffer;
 struct BinCoords;
@@ -69,6 +71,8 @@ struct RasterizerState {
 	PixelFuncID pixelID;
 	SamplerID samplerID;
 	SingleFunc drawPixel;
+	// Optional, used for triangles when the pixel state is simple enough.
+	QuadFunc drawQuad = nullptr;
 	Sampler::LinearFunc linear;
 	Sampler::NearestFunc nearest;
 	uint32_t texaddr[8]{};
@@ -9,6 +9,7 @@
 #include "Core/MIPS/MIPS.h"
 #include "Core/HW/Display.h"
 #include "Core/FrameTiming.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HLE/sceSas.h"
 #include "Core/HLE/sceKernel.h"
 #include "Core/HLE/scePower.h"
@@ -55,6 +56,28 @@ static void DrawDebugStats(UIContext *ctx, const Bounds &bounds) {
 	ctx->RebindTexture();
 }
 
+static void DrawHLESyscallStats(UIContext *ctx, const Bounds &bounds) {
+	FontID ubuntu24("UBUNTU24");
+
+	char statbuf[4096];
+	StringWriter w(statbuf);
+	w.W("Slowest syscalls in total (us): calls, avg, p99, max\n");
+	for (const auto &entry : GetHLESyscallStatsReport(30)) {
+		w.F("%.*s::%s: %llu, %0.1f, %0.1f, %0.1f\n", (int)entry.module.size(), entry.module.data(), entry.name,
+			(unsigned long long)entry.calls, (double)entry.totalNanos / (double)entry.calls * 0.001,
+			(double)HLESyscallStatsPercentile(entry, 99.0) * 0.001, (double)entry.maxNanos * 0.001);
+	}
+
+	ctx->Flush();
+	ctx->BindFontTexture();
+	ctx->Draw()->SetFontScale(.7f, .7f);
+	ctx->Draw()->DrawTextRect(ubuntu24, statbuf, bounds.x + 11, bounds.y + 31, bounds.w - 20, bounds.h - 30, 0xc0000000, FLAG_DYNAMIC_ASCII);
+	ctx->Draw()->DrawTextRect(ubuntu24, statbuf, bounds.x + 10, bounds.y + 30, bounds.w - 20, bounds.h - 30, 0xFFFFFFFF, FLAG_DYNAMIC_ASCII);
+	ctx->Draw()->SetFontScale(1.0f, 1.0f);
+	ctx->Flush();
+	ctx->RebindTexture();
+}
+
 static void DrawAudioDebugStats(UIContext *ctx, const Bounds &bounds) {
 	FontID ubuntu24("UBUNTU24");
 
@@ -236,6 +259,10 @@ void DrawDebugOverlay(UIContext *ctx, const Bounds &bounds, DebugOverlay overlay
 	case DebugOverlay::Audio:
 		DrawAudioDebugStats(ctx, ctx->GetLayoutBounds());
 		break;
+	case DebugOverlay::HLE_STATS:
+		if (inGame)
+			DrawHLESyscallStats(ctx, ctx->GetLayoutBounds());
+		break;
 #if !PPSSPP_PLATFORM(UWP) && !PPSSPP_PLATFORM(SWITCH)
 	case DebugOverlay::GPU_PROFILE:
 		if (g_Config.iGPUBackend == (int)GPUBackend::VULKAN || g_Config.iGPUBackend == (int)GPUBackend::OPENGL) {
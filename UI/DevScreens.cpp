@@ -101,6 +101,7 @@ static const char *g_debugOverlayList[] = {
 #endif
 	"Control Debug",
 	"Audio Debug",
+	"HLE Syscall Stats",
 	"GPU Profile",
 	"GPU Allocator Viewer",
 	"Framebuffer List",
@@ -15,6 +15,7 @@
 // Official git repository and contact information can be found at
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
+#include <atomic>
 #include <string>
 
 #include "Common/UI/View.h"
@@ -23,6 +24,7 @@
 #include "Common/GPU/OpenGL/GLFeatures.h"
 #include "Common/File/FileUtil.h"
 #include "Common/StringUtils.h"
+#include "Common/Thread/Promise.h"
 #include "GPU/Common/TextureReplacer.h"
 #include "GPU/Common/PostShader.h"
 #include "Core/MIPS/MIPSTracer.h"
@@ -64,6 +66,8 @@ static bool SupportsCustomDriver() {
 
 #endif
 
+static std::atomic<bool> g_buildingTextureArchive;
+
 static std::string PostShaderTranslateName(std::string_view value) {
 	const ShaderInfo *info = GetPostShaderInfo(value);
 	if (info) {
@@ -98,6 +102,12 @@ void DeveloperToolsScreen::CreateTextureReplacementTab(UI::LinearLayout *list) {
 		return true;
 	});
 
+	Choice *buildTextureArchive = list->Add(new Choice(dev->T("Build textures.pack archive for current game")));
+	buildTextureArchive->OnClick.Handle(this, &DeveloperToolsScreen::OnBuildTextureArchive);
+	buildTextureArchive->SetEnabledFunc([] {
+		return PSP_IsInited() && !g_buildingTextureArchive;
+	});
+
 	if (System_GetPropertyBool(SYSPROP_CAN_SHOW_FILE)) {
 		// Best string we have
 		list->Add(new Choice(di->T("Show in folder")))->OnClick.Add([=](UI::EventParams &) {
@@ -525,6 +535,25 @@ UI::EventReturn DeveloperToolsScreen::OnOpenTexturesIniFile(UI::EventParams &e)
 	return UI::EVENT_DONE;
 }
 
+UI::EventReturn DeveloperToolsScreen::OnBuildTextureArchive(UI::EventParams &e) {
+	std::string gameID = g_paramSFO.GetDiscID();
+	g_buildingTextureArchive = true;
+
+	// Big packs can take minutes, so don't block the UI.
+	g_threadManager.EnqueueTask(new IndependentTask(TaskType::IO_BLOCKING, TaskPriority::NORMAL, [gameID]() {
+		Path archiveFilename;
+		std::string error;
+		if (TextureReplacer::BuildArchive(gameID, archiveFilename, &error)) {
+			auto dev = GetI18NCategory(I18NCat::DEVELOPER);
+			g_OSD.Show(OSDType::MESSAGE_SUCCESS, archiveFilename.ToVisualString() + ": " + dev->T_cstr("Texture pack archive created"), 5.0f);
+		} else {
+			g_OSD.Show(OSDType::MESSAGE_ERROR, error, 5.0f);
+		}
+		g_buildingTextureArchive = false;
+	}));
+	return UI::EVENT_DONE;
+}
+
 UI::EventReturn DeveloperToolsScreen::OnLogConfig(UI::EventParams &e) {
 	screenManager()->push(new LogConfigScreen());
 	return UI::EVENT_DONE;
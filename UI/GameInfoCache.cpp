@@ -25,6 +25,7 @@
 
 #include "Common/GPU/thin3d.h"
 #include "Common/Thread/ThreadManager.h"
+#include "Common/Thread/Promise.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/VFS/ZipFileReader.h"
 #include "Common/File/FileUtil.h"
@@ -45,6 +46,7 @@
 #include "Core/Util/RecentFiles.h"
 #include "Core/Config.h"
 #include "UI/GameInfoCache.h"
+#include "UI/GameInfoIndex.h"
 
 GameInfoCache *g_gameInfoCache;
 
@@ -496,8 +498,8 @@ static bool LoadReplacementImage(GameInfo *info, GameInfoTex *tex, const char *f
 
 class GameInfoWorkItem : public Task {
 public:
-	GameInfoWorkItem(const Path &gamePath, std::shared_ptr<GameInfo> &info, GameInfoFlags flags)
-		: gamePath_(gamePath), info_(info), flags_(flags) {}
+	GameInfoWorkItem(const Path &gamePath, std::shared_ptr<GameInfo> &info, GameInfoFlags flags, const std::shared_ptr<GameInfoIndex> &index)
+		: gamePath_(gamePath), info_(info), flags_(flags), index_(index) {}
 
 	~GameInfoWorkItem() {
 		info_->DisposeFileLoader();
@@ -520,6 +522,17 @@ class GameInfoWorkItem : public Task {
 	}
 
 	void Run() override {
+		// If the file hasn't changed since last time, this can save us from opening it at all.
+		GameInfoFlags fromIndex = LoadFromIndex();
+		if (fromIndex != (GameInfoFlags)0) {
+			std::unique_lock<std::mutex> lock(info_->lock);
+			info_->MarkReadyNoLock(fromIndex);
+			flags_ &= ~fromIndex;
+		}
+		if (flags_ == (GameInfoFlags)0) {
+			return;
+		}
+
 		// An early-return will result in the destructor running, where we can set
 		// flags like working and pending.
 		if (!info_->CreateLoader() || !info_->GetFileLoader() || !info_->GetFileLoader()->Exists()) {
@@ -568,15 +581,7 @@ class GameInfoWorkItem : public Task {
 						std::lock_guard<std::mutex> lock(info_->lock);
 						info_->paramSFO.ReadSFO(sfoData);
 						info_->ParseParamSFO();
-
-						// Assuming PSP_PBP_DIRECTORY without ID or with disc_total < 1 in GAME dir must be homebrew
-						if ((info_->id.empty() || !info_->disc_total)
-							&& gamePath_.FilePathContainsNoCase("PSP/GAME/")
-							&& info_->fileType == IdentifiedFileType::PSP_PBP_DIRECTORY) {
-							info_->id = g_paramSFO.GenerateFakeID(gamePath_);
-							info_->id_version = info_->id + "_1.00";
-							info_->region = GameRegion::HOMEBREW; // Homebrew
-						}
+						FixHomebrewID();
 						info_->MarkReadyNoLock(GameInfoFlags::PARAM_SFO);
 					}
 				}
@@ -587,7 +592,7 @@ class GameInfoWorkItem : public Task {
 						// Nothing more to do
 					} else if (pbp.GetSubFileSize(PBP_ICON0_PNG) > 0) {
 						std::lock_guard<std::mutex> lock(info_->lock);
-						pbp.GetSubFileAsString(PBP_ICON0_PNG, &info_->icon.data);
+						iconFromImage_ = pbp.GetSubFileAsString(PBP_ICON0_PNG, &info_->icon.data);
 					} else {
 						Path screenshot_jpg = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.jpg");
 						Path screenshot_png = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.png");
@@ -732,7 +737,7 @@ class GameInfoWorkItem : public Task {
 				}
 
 				if (flags_ & GameInfoFlags::ICON) {
-					ReadFileToString(&umd, "/PSP_GAME/ICON0.PNG", &info_->icon.data, &info_->lock);
+					iconFromImage_ = ReadFileToString(&umd, "/PSP_GAME/ICON0.PNG", &info_->icon.data, &info_->lock);
 					info_->icon.dataLoaded = true;
 				}
 				if (flags_ & GameInfoFlags::BG) {
@@ -803,6 +808,7 @@ class GameInfoWorkItem : public Task {
 						// Nothing more to do
 					} else if (ReadFileToString(&umd, "/PSP_GAME/ICON0.PNG", &info_->icon.data, &info_->lock)) {
 						info_->icon.dataLoaded = true;
+						iconFromImage_ = true;
 					} else {
 						Path screenshot_jpg = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.jpg");
 						Path screenshot_png = GetSysDirectory(DIRECTORY_SCREENSHOT) / (info_->id + "_00000.png");
@@ -854,35 +860,143 @@ class GameInfoWorkItem : public Task {
 		if (flags_ & GameInfoFlags::SIZE) {
 			std::lock_guard<std::mutex> lock(info_->lock);
 			info_->gameSizeOnDisk = info_->GetSizeOnDiskInBytes();
-			switch (info_->fileType) {
-			case IdentifiedFileType::PSP_ISO:
-			case IdentifiedFileType::PSP_ISO_NP:
-			case IdentifiedFileType::PSP_DISC_DIRECTORY:
-			case IdentifiedFileType::PSP_PBP:
-			case IdentifiedFileType::PSP_PBP_DIRECTORY:
-				info_->saveDataSize = info_->GetGameSavedataSizeInBytes();
-				info_->installDataSize = info_->GetInstallDataSizeInBytes();
-				break;
-			default:
-				info_->saveDataSize = 0;
-				info_->installDataSize = 0;
-				break;
-			}
+			UpdateSaveDataSizes();
 		}
 		if (flags_ & GameInfoFlags::UNCOMPRESSED_SIZE) {
 			info_->gameSizeUncompressed = info_->GetSizeUncompressedInBytes();
 		}
 
 		// Time to update the flags.
-		std::unique_lock<std::mutex> lock(info_->lock);
-		info_->MarkReadyNoLock(flags_);
-		// INFO_LOG(Log::System, "Completed writing info for %s", info_->GetTitle().c_str());
+		{
+			std::unique_lock<std::mutex> lock(info_->lock);
+			info_->MarkReadyNoLock(flags_);
+			// INFO_LOG(Log::System, "Completed writing info for %s", info_->GetTitle().c_str());
+		}
+		UpdateIndex();
 	}
 
 private:
+	// Call with the info lock held.
+	void FixHomebrewID() {
+		// Assuming PSP_PBP_DIRECTORY without ID or with disc_total < 1 in GAME dir must be homebrew
+		if ((info_->id.empty() || !info_->disc_total)
+			&& gamePath_.FilePathContainsNoCase("PSP/GAME/")
+			&& info_->fileType == IdentifiedFileType::PSP_PBP_DIRECTORY) {
+			info_->id = g_paramSFO.GenerateFakeID(gamePath_);
+			info_->id_version = info_->id + "_1.00";
+			info_->region = GameRegion::HOMEBREW; // Homebrew
+		}
+	}
+
+	// Call with the info lock held. Savedata is local and changes often, so this isn't indexed.
+	void UpdateSaveDataSizes() {
+		switch (info_->fileType) {
+		case IdentifiedFileType::PSP_ISO:
+		case IdentifiedFileType::PSP_ISO_NP:
+		case IdentifiedFileType::PSP_DISC_DIRECTORY:
+		case IdentifiedFileType::PSP_PBP:
+		case IdentifiedFileType::PSP_PBP_DIRECTORY:
+			info_->saveDataSize = info_->GetGameSavedataSizeInBytes();
+			info_->installDataSize = info_->GetInstallDataSizeInBytes();
+			break;
+		default:
+			info_->saveDataSize = 0;
+			info_->installDataSize = 0;
+			break;
+		}
+	}
+
+	// Returns the flags that were filled in from the index.
+	GameInfoFlags LoadFromIndex() {
+		const GameInfoFlags indexed = GameInfoFlags::FILE_TYPE | GameInfoFlags::PARAM_SFO | GameInfoFlags::ICON | GameInfoFlags::SIZE | GameInfoFlags::UNCOMPRESSED_SIZE;
+		GameInfoIndexEntry entry;
+		if (!index_ || !(flags_ & indexed) || !index_->Lookup(gamePath_, &entry)) {
+			return (GameInfoFlags)0;
+		}
+		// Everything else depends on the file type, if we already have it, it must match.
+		if (!(flags_ & GameInfoFlags::FILE_TYPE) && info_->fileType != entry.fileType) {
+			return (GameInfoFlags)0;
+		}
+		info_->fileType = entry.fileType;
+		GameInfoFlags found = GameInfoFlags::FILE_TYPE;
+
+		if ((flags_ & GameInfoFlags::PARAM_SFO) && (entry.flags & GameInfoFlags::PARAM_SFO)) {
+			std::lock_guard<std::mutex> lock(info_->lock);
+			if (info_->paramSFO.ReadSFO((const u8 *)entry.paramSFO.data(), entry.paramSFO.size())) {
+				info_->ParseParamSFO();
+				FixHomebrewID();
+				// Mark it right away, the size calculation below wants the ID.
+				info_->MarkReadyNoLock(GameInfoFlags::PARAM_SFO);
+				found |= GameInfoFlags::PARAM_SFO;
+			}
+		}
+		if (found & GameInfoFlags::PARAM_SFO) {
+			info_->hasConfig = g_Config.hasGameConfig(info_->id);
+		}
+
+		if ((flags_ & GameInfoFlags::ICON) && (entry.flags & GameInfoFlags::ICON)) {
+			// A replacement icon still wins, as when reading the image.
+			if (!LoadReplacementImage(info_.get(), &info_->icon, "icon.png")) {
+				std::lock_guard<std::mutex> lock(info_->lock);
+				info_->icon.data = std::move(entry.icon);
+			}
+			info_->icon.dataLoaded = true;
+			found |= GameInfoFlags::ICON;
+		}
+
+		if ((flags_ & GameInfoFlags::SIZE) && (entry.flags & GameInfoFlags::SIZE)) {
+			std::lock_guard<std::mutex> lock(info_->lock);
+			info_->gameSizeOnDisk = entry.sizeOnDisk;
+			UpdateSaveDataSizes();
+			found |= GameInfoFlags::SIZE;
+		}
+		if ((flags_ & GameInfoFlags::UNCOMPRESSED_SIZE) && (entry.flags & GameInfoFlags::UNCOMPRESSED_SIZE)) {
+			info_->gameSizeUncompressed = entry.sizeUncompressed;
+			found |= GameInfoFlags::UNCOMPRESSED_SIZE;
+		}
+		return found;
+	}
+
+	// Remembers what was read from the image itself, for next time.
+	void UpdateIndex() {
+		if (!index_ || !GameInfoIndex::IsIndexable(info_->fileType)) {
+			return;
+		}
+
+		GameInfoIndexEntry entry;
+		entry.fileType = info_->fileType;
+		{
+			std::lock_guard<std::mutex> lock(info_->lock);
+			if ((flags_ & GameInfoFlags::PARAM_SFO) && info_->paramSFO.IsValid()) {
+				u8 *sfoData = nullptr;
+				size_t sfoSize = 0;
+				info_->paramSFO.WriteSFO(&sfoData, &sfoSize);
+				entry.paramSFO.assign((const char *)sfoData, sfoSize);
+				delete[] sfoData;
+				entry.flags |= GameInfoFlags::PARAM_SFO;
+			}
+			if ((flags_ & GameInfoFlags::ICON) && iconFromImage_) {
+				entry.icon = info_->icon.data;
+				entry.flags |= GameInfoFlags::ICON;
+			}
+			if (flags_ & GameInfoFlags::SIZE) {
+				entry.sizeOnDisk = info_->gameSizeOnDisk;
+				entry.flags |= GameInfoFlags::SIZE;
+			}
+			if (flags_ & GameInfoFlags::UNCOMPRESSED_SIZE) {
+				entry.sizeUncompressed = info_->gameSizeUncompressed;
+				entry.flags |= GameInfoFlags::UNCOMPRESSED_SIZE;
+			}
+		}
+		index_->Update(gamePath_, entry);
+	}
+
 	Path gamePath_;
 	std::shared_ptr<GameInfo> info_;
 	GameInfoFlags flags_{};
+	std::shared_ptr<GameInfoIndex> index_;
+	// Whether the icon came from the image itself, and not a replacement, screenshot or placeholder.
+	bool iconFromImage_ = false;
 
 	DISALLOW_COPY_AND_ASSIGN(GameInfoWorkItem);
 };
@@ -896,10 +1010,17 @@ GameInfoCache::~GameInfoCache() {
 	Shutdown();
 }
 
-void GameInfoCache::Init() {}
+void GameInfoCache::Init() {
+	index_ = std::make_shared<GameInfoIndex>();
+	index_->Init(GetSysDirectory(DIRECTORY_APP_CACHE) / "gameinfo.index");
+}
 
 void GameInfoCache::Shutdown() {
 	CancelAll();
+	// Normally saved in the background when a game starts. This has to be done right here though,
+	// the thread manager drops queued tasks when it shuts down. So only bother if anything changed.
+	if (index_->IsDirty())
+		index_->Save();
 }
 
 void GameInfoCache::Clear() {
@@ -924,6 +1045,12 @@ void GameInfoCache::CancelAll() {
 }
 
 void GameInfoCache::FlushBGs() {
+	// Called when a game starts, a good time to write down what the game browser found.
+	std::shared_ptr<GameInfoIndex> index = index_;
+	g_threadManager.EnqueueTask(new IndependentTask(TaskType::IO_BLOCKING, TaskPriority::LOW, [index]() {
+		index->Save();
+	}));
+
 	std::lock_guard<std::mutex> lock(mapLock_);
 	for (auto iter = info_.begin(); iter != info_.end(); iter++) {
 		std::lock_guard<std::mutex> lock(iter->second->lock);
@@ -1005,7 +1132,7 @@ std::shared_ptr<GameInfo> GameInfoCache::GetInfo(Draw::DrawContext *draw, const
 		}
 		if (wanted != (GameInfoFlags)0) {
 			// We're missing info that we want. Go get it!
-			GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wanted);
+			GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wanted, index_);
 			g_threadManager.EnqueueTask(item);
 		}
 		return info;
@@ -1018,7 +1145,7 @@ std::shared_ptr<GameInfo> GameInfoCache::GetInfo(Draw::DrawContext *draw, const
 	mapLock_.unlock();
 
 	// Just get all the stuff we wanted.
-	GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wantFlags);
+	GameInfoWorkItem *item = new GameInfoWorkItem(gamePath, info, wantFlags, index_);
 	g_threadManager.EnqueueTask(item);
 	return info;
 }
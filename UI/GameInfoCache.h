@@ -50,6 +50,7 @@ enum class GameInfoFlags {
 ENUM_CLASS_BITOPS(GameInfoFlags);
 
 class FileLoader;
+class GameInfoIndex;
 enum class IdentifiedFileType;
 
 struct GameInfoTex {
@@ -208,6 +209,9 @@ class GameInfoCache {
 	// and if they get destructed while being in use, that's bad.
 	std::map<std::string, std::shared_ptr<GameInfo> > info_;
 	std::mutex mapLock_;
+
+	// Metadata kept on disk between runs. Shared with the work items, which may outlive us.
+	std::shared_ptr<GameInfoIndex> index_;
 };
 
 // This one can be global, no good reason not to.
@@ -0,0 +1,332 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#include <vector>
+
+#include "Common/File/DirListing.h"
+#include "Common/File/FileUtil.h"
+#include "Common/Log.h"
+#include "Common/StringUtils.h"
+#include "Common/Thread/ThreadUtil.h"
+#include "Core/Loaders.h"
+#include "UI/GameInfoIndex.h"
+
+static const u32 INDEX_HEADER_MAGIC = 0x58444947;  // "GIDX"
+// Bump this when the file format changes.
+static const u32 INDEX_VERSION = 1;
+
+// Keep the file reasonably sized. Icons are normally a few KB.
+static const u32 MAX_INDEX_ENTRIES = 4096;
+static const u32 MAX_INDEX_STRING = 0x100000;
+static const size_t MAX_INDEX_ICON_SIZE = 0x40000;
+// Icons are most of the file, so cap their total too. Entries past this are kept without one.
+static const size_t MAX_INDEX_ICON_TOTAL = 16 * 1024 * 1024;
+
+static const GameInfoFlags INDEXED_FLAGS = GameInfoFlags::PARAM_SFO | GameInfoFlags::ICON | GameInfoFlags::SIZE | GameInfoFlags::UNCOMPRESSED_SIZE;
+
+struct GameInfoIndexHeader {
+	u32 magic;
+	u32 version;
+	u32 numEntries;
+	u32 reserved;
+};
+
+struct GameInfoIndexEntryHeader {
+	u64 size;
+	u64 mtime;
+	u64 contentSize;
+	u64 contentMtime;
+	u64 sizeOnDisk;
+	u64 sizeUncompressed;
+	u32 fileType;
+	u32 flags;
+};
+
+static bool WriteString(FILE *f, const std::string &str) {
+	u32 len = (u32)str.size();
+	if (fwrite(&len, sizeof(len), 1, f) != 1)
+		return false;
+	return len == 0 || fwrite(str.data(), 1, len, f) == len;
+}
+
+static bool ReadString(FILE *f, std::string *str) {
+	u32 len = 0;
+	if (fread(&len, sizeof(len), 1, f) != 1 || len > MAX_INDEX_STRING)
+		return false;
+	str->resize(len);
+	return len == 0 || fread(&(*str)[0], 1, len, f) == len;
+}
+
+void GameInfoIndex::Init(const Path &filename) {
+	std::lock_guard<std::mutex> guard(lock_);
+	filename_ = filename;
+	loaded_ = false;
+	dirty_ = false;
+	entries_.clear();
+}
+
+bool GameInfoIndex::IsIndexable(IdentifiedFileType fileType) {
+	switch (fileType) {
+	case IdentifiedFileType::PSP_ISO:
+	case IdentifiedFileType::PSP_ISO_NP:
+	case IdentifiedFileType::PSP_PBP:
+	case IdentifiedFileType::PSP_PBP_DIRECTORY:
+	case IdentifiedFileType::PSP_DISC_DIRECTORY:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool GameInfoIndex::GetStamp(const Path &gamePath, Stamp *stamp) {
+	File::FileInfo info;
+	if (!File::GetFileInfo(gamePath, &info) || !info.exists)
+		return false;
+	stamp->size = info.size;
+	stamp->mtime = info.mtime;
+
+	if (info.isDirectory) {
+		// Rewriting a file inside doesn't touch the directory, so check the file the metadata comes from too.
+		File::FileInfo content;
+		if (File::GetFileInfo(ResolvePBPFile(gamePath), &content) && content.exists) {
+			stamp->contentSize = content.size;
+			stamp->contentMtime = content.mtime;
+		} else if (File::GetFileInfo(gamePath / "PSP_GAME/PARAM.SFO", &content) && content.exists) {
+			stamp->contentSize = content.size;
+			stamp->contentMtime = content.mtime;
+		}
+	}
+	return true;
+}
+
+void GameInfoIndex::LoadIfNeeded() {
+	if (loaded_ || filename_.empty())
+		return;
+	loaded_ = true;
+
+	FILE *f = File::OpenCFile(filename_, "rb");
+	if (!f)
+		return;
+	bool success = LoadIndex(f);
+	fclose(f);
+
+	if (!success) {
+		WARN_LOG(Log::Loader, "Incompatible or corrupt game info index, rebuilding");
+		entries_.clear();
+		File::Delete(filename_);
+	} else {
+		INFO_LOG(Log::Loader, "Loaded game info index: %d entries", (int)entries_.size());
+	}
+}
+
+bool GameInfoIndex::LoadIndex(FILE *f) {
+	GameInfoIndexHeader header{};
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != INDEX_HEADER_MAGIC) {
+		WARN_LOG(Log::Loader, "Game info index magic mismatch");
+		return false;
+	}
+	if (header.version != INDEX_VERSION || header.numEntries > MAX_INDEX_ENTRIES) {
+		WARN_LOG(Log::Loader, "Game info index version mismatch, %d, expected %d", header.version, INDEX_VERSION);
+		return false;
+	}
+
+	for (u32 i = 0; i < header.numEntries; ++i) {
+		std::string path;
+		GameInfoIndexEntryHeader entryHeader{};
+		Entry entry;
+		if (!ReadString(f, &path) || fread(&entryHeader, sizeof(entryHeader), 1, f) != 1) {
+			ERROR_LOG(Log::Loader, "Game info index truncated");
+			return false;
+		}
+		if (!ReadString(f, &entry.data.paramSFO) || !ReadString(f, &entry.data.icon)) {
+			ERROR_LOG(Log::Loader, "Game info index truncated");
+			return false;
+		}
+
+		entry.stamp.size = entryHeader.size;
+		entry.stamp.mtime = entryHeader.mtime;
+		entry.stamp.contentSize = entryHeader.contentSize;
+		entry.stamp.contentMtime = entryHeader.contentMtime;
+		entry.data.fileType = (IdentifiedFileType)entryHeader.fileType;
+		entry.data.flags = (GameInfoFlags)(entryHeader.flags & (u32)INDEXED_FLAGS);
+		entry.data.sizeOnDisk = entryHeader.sizeOnDisk;
+		entry.data.sizeUncompressed = entryHeader.sizeUncompressed;
+		entries_[path] = std::move(entry);
+	}
+	return true;
+}
+
+void GameInfoIndex::Save() {
+	std::lock_guard<std::mutex> guard(lock_);
+	if (filename_.empty() || !dirty_)
+		return;
+
+	Trim();
+	File::CreateFullPath(filename_.NavigateUp());
+
+	// Other instances (like the background flush, or the ones on Android) may be saving or loading
+	// the same file. Write to a temporary of our own and rename it into place, so none of them can
+	// see a half written index.
+	Path tempFilename = filename_.WithExtraExtension(StringFromFormat(".%d.tmp", GetCurrentThreadIdForDebug()));
+	FILE *f = File::OpenCFile(tempFilename, "wb");
+	if (!f)
+		return;
+	bool writeFailed = !SaveIndex(f);
+	writeFailed = fclose(f) != 0 || writeFailed;
+	if (writeFailed) {
+		ERROR_LOG(Log::Loader, "Failed to write game info index, disk full?");
+		File::Delete(tempFilename);
+		return;
+	}
+
+	if (File::Exists(filename_))
+		File::Delete(filename_);
+	if (!File::Rename(tempFilename, filename_)) {
+		ERROR_LOG(Log::Loader, "Failed to rename %s", tempFilename.c_str());
+		File::Delete(tempFilename);
+		return;
+	}
+	INFO_LOG(Log::Loader, "Saved game info index: %d entries", (int)entries_.size());
+	dirty_ = false;
+}
+
+bool GameInfoIndex::SaveIndex(FILE *f) {
+	GameInfoIndexHeader header{};
+	header.magic = INDEX_HEADER_MAGIC;
+	header.version = INDEX_VERSION;
+	header.numEntries = (u32)entries_.size();
+
+	bool writeFailed = fwrite(&header, sizeof(header), 1, f) != 1;
+	for (const auto &iter : entries_) {
+		const Entry &entry = iter.second;
+		GameInfoIndexEntryHeader entryHeader{};
+		entryHeader.size = entry.stamp.size;
+		entryHeader.mtime = entry.stamp.mtime;
+		entryHeader.contentSize = entry.stamp.contentSize;
+		entryHeader.contentMtime = entry.stamp.contentMtime;
+		entryHeader.sizeOnDisk = entry.data.sizeOnDisk;
+		entryHeader.sizeUncompressed = entry.data.sizeUncompressed;
+		entryHeader.fileType = (u32)entry.data.fileType;
+		entryHeader.flags = (u32)entry.data.flags;
+
+		writeFailed = writeFailed || !WriteString(f, iter.first);
+		writeFailed = writeFailed || fwrite(&entryHeader, sizeof(entryHeader), 1, f) != 1;
+		writeFailed = writeFailed || !WriteString(f, entry.data.paramSFO);
+		writeFailed = writeFailed || !WriteString(f, entry.data.icon);
+		if (writeFailed)
+			break;
+	}
+	return !writeFailed;
+}
+
+void GameInfoIndex::Trim() {
+	// Drop what wasn't seen this session first, probably games that were since moved or deleted.
+	for (auto iter = entries_.begin(); iter != entries_.end() && entries_.size() > MAX_INDEX_ENTRIES; ) {
+		if (!iter->second.used)
+			iter = entries_.erase(iter);
+		else
+			++iter;
+	}
+	while (entries_.size() > MAX_INDEX_ENTRIES)
+		entries_.erase(entries_.begin());
+
+	size_t iconTotal = 0;
+	for (const auto &iter : entries_)
+		iconTotal += iter.second.data.icon.size();
+	// Same order here, but only the icon goes. The rest is small and still saves opening the file.
+	for (int pass = 0; pass < 2 && iconTotal > MAX_INDEX_ICON_TOTAL; ++pass) {
+		for (auto &iter : entries_) {
+			GameInfoIndexEntry &data = iter.second.data;
+			if (data.icon.empty() || (pass == 0 && iter.second.used))
+				continue;
+			iconTotal -= data.icon.size();
+			data.icon = std::string();
+			data.flags &= ~GameInfoFlags::ICON;
+			if (iconTotal <= MAX_INDEX_ICON_TOTAL)
+				break;
+		}
+	}
+}
+
+bool GameInfoIndex::IsDirty() {
+	std::lock_guard<std::mutex> guard(lock_);
+	return dirty_;
+}
+
+bool GameInfoIndex::Lookup(const Path &gamePath, GameInfoIndexEntry *entry) {
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		LoadIfNeeded();
+		if (entries_.find(gamePath.ToString()) == entries_.end())
+			return false;
+	}
+
+	// Don't hold the lock while touching the file system, it might be slow.
+	Stamp stamp;
+	bool exists = GetStamp(gamePath, &stamp);
+
+	std::lock_guard<std::mutex> guard(lock_);
+	auto iter = entries_.find(gamePath.ToString());
+	if (iter == entries_.end())
+		return false;
+	if (!exists || !(iter->second.stamp == stamp)) {
+		// Gone or changed, either way it's no use anymore.
+		entries_.erase(iter);
+		dirty_ = true;
+		return false;
+	}
+
+	iter->second.used = true;
+	*entry = iter->second.data;
+	return true;
+}
+
+void GameInfoIndex::Update(const Path &gamePath, const GameInfoIndexEntry &data) {
+	if (!IsIndexable(data.fileType))
+		return;
+	GameInfoFlags flags = data.flags;
+	flags &= INDEXED_FLAGS;
+	if (data.icon.size() > MAX_INDEX_ICON_SIZE)
+		flags &= ~GameInfoFlags::ICON;
+
+	Stamp stamp;
+	if (!GetStamp(gamePath, &stamp))
+		return;
+
+	std::lock_guard<std::mutex> guard(lock_);
+	LoadIfNeeded();
+
+	Entry &entry = entries_[gamePath.ToString()];
+	if (!(entry.stamp == stamp) || entry.data.fileType != data.fileType) {
+		// New, or the file changed since. Start over.
+		entry.stamp = stamp;
+		entry.data = GameInfoIndexEntry();
+		entry.data.fileType = data.fileType;
+	}
+	entry.used = true;
+
+	if (flags & GameInfoFlags::PARAM_SFO)
+		entry.data.paramSFO = data.paramSFO;
+	if (flags & GameInfoFlags::ICON)
+		entry.data.icon = data.icon;
+	if (flags & GameInfoFlags::SIZE)
+		entry.data.sizeOnDisk = data.sizeOnDisk;
+	if (flags & GameInfoFlags::UNCOMPRESSED_SIZE)
+		entry.data.sizeUncompressed = data.sizeUncompressed;
+	entry.data.flags |= flags;
+	dirty_ = true;
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2024- PPSSPP Project.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, version 2.0 or later versions.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License 2.0 for more details.
+
+// A copy of the GPL 2.0 should have been included with the program.
+// If not, see http://www.gnu.org/licenses/
+
+// Official git repository and contact information can be found at
+// https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
+
+#pragma once
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Common/Common.h"
+#include "Common/File/Path.h"
+#include "UI/GameInfoCache.h"
+
+// What we know about a game image without opening it again.
+struct GameInfoIndexEntry {
+	IdentifiedFileType fileType{};
+	// Which of the below are valid. Only PARAM_SFO, ICON, SIZE and UNCOMPRESSED_SIZE are stored.
+	GameInfoFlags flags{};
+	std::string paramSFO;
+	// ICON0 as read from the image, not a replacement or screenshot.
+	std::string icon;
+	u64 sizeOnDisk = 0;
+	u64 sizeUncompressed = 0;
+};
+
+// Persistent index of game metadata that's slow to get - opening ISOs over network storage,
+// or summing up the size of a directory tree. Entries are keyed by path, and are only used
+// while the size and modification time still match, so changed files are simply read again.
+// Safe to use from the game info worker threads.
+class GameInfoIndex {
+public:
+	// Doesn't load anything yet, that happens on first use (on a worker thread.)
+	void Init(const Path &filename);
+	// Does nothing unless something changed since the last save.
+	void Save();
+	bool IsDirty();
+
+	// Only types that are worth it are stored, see IsIndexable.
+	static bool IsIndexable(IdentifiedFileType fileType);
+
+	// Stats the file (and for directories, the file the metadata comes from.)
+	bool Lookup(const Path &gamePath, GameInfoIndexEntry *entry);
+	// Merges the flags in data into any existing entry.
+	void Update(const Path &gamePath, const GameInfoIndexEntry &data);
+
+private:
+	struct Stamp {
+		u64 size = 0;
+		u64 mtime = 0;
+		u64 contentSize = 0;
+		u64 contentMtime = 0;
+
+		bool operator ==(const Stamp &other) const {
+			return size == other.size && mtime == other.mtime && contentSize == other.contentSize && contentMtime == other.contentMtime;
+		}
+	};
+
+	struct Entry {
+		Stamp stamp;
+		GameInfoIndexEntry data;
+		// Looked up or updated this session, preferred when trimming.
+		bool used = false;
+	};
+
+	static bool GetStamp(const Path &gamePath, Stamp *stamp);
+	void LoadIfNeeded();
+	bool LoadIndex(FILE *f);
+	bool SaveIndex(FILE *f);
+	void Trim();
+
+	std::mutex lock_;
+	Path filename_;
+	bool loaded_ = false;
+	bool dirty_ = false;
+	std::map<std::string, Entry> entries_;
+};
@@ -27,6 +27,7 @@
 #include <csignal>
 #endif
 #include "Common/CPUDetect.h"
+#include "Common/Data/Format/JSONWriter.h"
 #include "Common/File/VFS/VFS.h"
 #include "Common/File/VFS/ZipFileReader.h"
 #include "Common/File/VFS/DirectoryReader.h"
@@ -41,9 +42,14 @@
 #include "Core/CoreTiming.h"
 #include "Core/System.h"
 #include "Core/WebServer.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HLE/sceUtility.h"
+#include "Core/MIPS/JitCommon/JitCommon.h"
+#include "Core/MIPS/JitCommon/JitBlockCache.h"
 #include "Core/SaveState.h"
 #include "GPU/Common/FramebufferManagerCommon.h"
+#include "GPU/Debugger/Playback.h"
+#include "GPU/GPUCommon.h"
 #include "Common/Log.h"
 #include "Common/Log/LogManager.h"
 
@@ -150,6 +156,10 @@ int printUsage(const char *progname, const char *reason)
 	fprintf(stderr, "  -j                    use jit (default)\n");
 	fprintf(stderr, "  -c, --compare         compare with output in file.expected\n");
 	fprintf(stderr, "  --bench               run multiple times and output speed\n");
+	fprintf(stderr, "  --block-profile=FILE  sample hot blocks (with --ir) and write JSON to FILE\n");
+	fprintf(stderr, "  --hle-stats=FILE      write syscall call counts and timing histograms as JSON to FILE\n");
+	fprintf(stderr, "  --replay-bench=N      replay a .ppdmp N times and output frame/draw timings as JSON\n");
+	fprintf(stderr, "  --bench-json=FILE     write --replay-bench results to FILE instead of stdout\n");
 	fprintf(stderr, "\nSee headless.txt for details.\n");
 
 	return 1;
@@ -172,11 +182,55 @@ static HeadlessHost *getHost(GPUCore gpuCore) {
 struct AutoTestOptions {
 	double timeout;
 	double maxScreenshotError;
+	const char *blockProfileFile;
+	const char *hleStatsFile;
+	const char *benchJsonFile;
+	int replayBenchPasses;
 	bool compare : 1;
 	bool verbose : 1;
 	bool bench : 1;
 };
 
+static const int BLOCK_PROFILE_INTERVAL = 64;
+
+static void WriteBlockProfile(const char *filename) {
+	JitBlockCacheDebugInterface *blockCache = MIPSComp::jit ? MIPSComp::jit->GetBlockCacheDebugInterface() : nullptr;
+	std::vector<JitBlockProfileReportEntry> report = GetJitBlockProfileReport(blockCache, 1000);
+
+	json::JsonWriter j;
+	j.begin();
+	j.writeString("test", currentTestName);
+	j.writeInt("interval", BLOCK_PROFILE_INTERVAL);
+	WriteJitBlockProfileReport(j, report);
+	j.end();
+
+	FILE *fp = File::OpenCFile(Path(filename), "wb");
+	if (!fp) {
+		fprintf(stderr, "Unable to write block profile to '%s'\n", filename);
+		return;
+	}
+	std::string str = j.str();
+	fwrite(str.data(), 1, str.size(), fp);
+	fclose(fp);
+}
+
+static void WriteHLEStats(const char *filename) {
+	json::JsonWriter j;
+	j.begin();
+	j.writeString("test", currentTestName);
+	WriteHLESyscallStatsReport(j, GetHLESyscallStatsReport(1000));
+	j.end();
+
+	FILE *fp = File::OpenCFile(Path(filename), "wb");
+	if (!fp) {
+		fprintf(stderr, "Unable to write HLE stats to '%s'\n", filename);
+		return;
+	}
+	std::string str = j.str();
+	fwrite(str.data(), 1, str.size(), fp);
+	fclose(fp);
+}
+
 bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, const AutoTestOptions &opt) {
 	// Kinda ugly, trying to guesstimate the test name from filename...
 	currentTestName = GetTestName(coreParameter.fileToStart);
@@ -215,6 +269,12 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, const
 
 	PSP_UpdateDebugStats((DebugOverlay)g_Config.iDebugOverlay == DebugOverlay::DEBUG_STATS || g_Config.bLogFrameDrops);
 
+	if (opt.blockProfileFile) {
+		JitBlockCacheDebugInterface *blockCache = MIPSComp::jit ? MIPSComp::jit->GetBlockCacheDebugInterface() : nullptr;
+		if (!blockCache || !blockCache->SetProfileSampleInterval(BLOCK_PROFILE_INTERVAL))
+			fprintf(stderr, "Block profiling is not supported by this CPU core, try --ir\n");
+	}
+
 	if (gpu) {
 		gpu->BeginHostFrame();
 	}
@@ -271,6 +331,11 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, const
 		draw->EndFrame();
 	}
 
+	if (opt.blockProfileFile)
+		WriteBlockProfile(opt.blockProfileFile);
+	if (opt.hleStatsFile)
+		WriteHLEStats(opt.hleStatsFile);
+
 	PSP_Shutdown(true);
 
 	if (!opt.bench)
@@ -284,6 +349,135 @@ bool RunAutoTest(HeadlessHost *headlessHost, CoreParameter &coreParameter, const
 	return passed;
 }
 
+static void WriteTimingStats(json::JsonWriter &j, const std::string &name, std::vector<double> &times) {
+	j.pushDict(name);
+	j.writeInt("count", (int)times.size());
+	if (!times.empty()) {
+		std::sort(times.begin(), times.end());
+		double total = 0.0;
+		for (double t : times)
+			total += t;
+		auto percentile = [&](double p) {
+			size_t index = std::min(times.size() - 1, (size_t)(p * (double)times.size()));
+			return times[index] * 1000.0;
+		};
+		j.writeFloat("totalMs", total * 1000.0);
+		j.writeFloat("meanMs", total * 1000.0 / (double)times.size());
+		j.writeFloat("minMs", times.front() * 1000.0);
+		j.writeFloat("p50Ms", percentile(0.50));
+		j.writeFloat("p90Ms", percentile(0.90));
+		j.writeFloat("p99Ms", percentile(0.99));
+		j.writeFloat("maxMs", times.back() * 1000.0);
+	}
+	j.pop();
+}
+
+// Replays a GE dump a number of times, timing each frame (from flip to flip) and each draw command.
+// The first pass is a warmup (shader and texture caches, etc.) and isn't counted.
+bool RunReplayBench(HeadlessHost *headlessHost, CoreParameter &coreParameter, const AutoTestOptions &opt) {
+	currentTestName = GetTestName(coreParameter.fileToStart);
+
+	if (!PSP_InitStart(coreParameter)) {
+		fprintf(stderr, "Failed to start '%s'.\n", coreParameter.fileToStart.c_str());
+		return false;
+	}
+
+	std::string error_string;
+	while (PSP_InitUpdate(&error_string) == BootState::Booting)
+		sleep_ms(1, "replay-bench");
+
+	if (!PSP_IsInited() || PSP_CoreParameter().fileType != IdentifiedFileType::PPSSPP_GE_DUMP) {
+		fprintf(stderr, "Unable to replay '%s' as a GE dump: %s\n", coreParameter.fileToStart.c_str(), error_string.c_str());
+		if (PSP_IsInited())
+			PSP_Shutdown(true);
+		return false;
+	}
+
+	System_Notify(SystemNotification::BOOT_DONE);
+
+	std::vector<double> frameTimes;
+	std::vector<double> drawTimes;
+	std::vector<double> warmupDrawTimes;
+	gpu->SetDrawTimeLog(&warmupDrawTimes);
+
+	gpu->BeginHostFrame();
+	Draw::DrawContext *draw = coreParameter.graphicsContext ? coreParameter.graphicsContext->GetDrawContext() : nullptr;
+	if (draw) {
+		draw->BeginFrame(Draw::DebugFlags::NONE);
+	}
+
+	bool passed = true;
+	int warmupFrames = 0;
+	int framePass = 0;
+	double deadline = time_now_d() + opt.timeout;
+	double frameStart = time_now_d();
+	coreState = CORE_RUNNING_CPU;
+	while (coreState == CORE_RUNNING_CPU) {
+		PSP_RunLoopFor((int)usToCycles(1000000 / 10));
+
+		if (coreState == CORE_NEXTFRAME) {
+			coreState = CORE_RUNNING_CPU;
+			double now = time_now_d();
+			// The pass counter is updated before the last frame of a pass flips, so this frame belongs to framePass.
+			if (framePass == 0) {
+				warmupFrames++;
+			} else {
+				frameTimes.push_back(now - frameStart);
+			}
+			framePass = GPURecord::Replay_PassesCompleted();
+			if (framePass > opt.replayBenchPasses) {
+				Core_Stop();
+				break;
+			}
+			gpu->SetDrawTimeLog(framePass == 0 ? &warmupDrawTimes : &drawTimes);
+			headlessHost->SwapBuffers();
+			frameStart = time_now_d();
+		}
+
+		if (time_now_d() > deadline) {
+			fprintf(stderr, "Timeout replaying '%s'\n", coreParameter.fileToStart.c_str());
+			passed = false;
+			Core_Stop();
+		}
+	}
+
+	gpu->SetDrawTimeLog(nullptr);
+	gpu->EndHostFrame();
+	if (draw) {
+		draw->BindFramebufferAsRenderTarget(nullptr, { Draw::RPAction::CLEAR, Draw::RPAction::DONT_CARE, Draw::RPAction::DONT_CARE }, "Headless");
+		gpu->CopyDisplayToOutput(true);
+		draw->EndFrame();
+	}
+
+	int measuredPasses = std::max(0, std::min(framePass, opt.replayBenchPasses + 1) - 1);
+	PSP_Shutdown(true);
+
+	json::JsonWriter j;
+	j.begin();
+	j.writeString("dump", currentTestName);
+	j.writeString("gpu", coreParameter.gpuCore == GPUCORE_SOFTWARE ? "software" : "hardware");
+	j.writeBool("completed", passed);
+	j.writeInt("passes", measuredPasses);
+	j.writeInt("warmupFrames", warmupFrames);
+	WriteTimingStats(j, "frames", frameTimes);
+	WriteTimingStats(j, "draws", drawTimes);
+	j.end();
+
+	std::string str = j.str();
+	if (opt.benchJsonFile) {
+		FILE *fp = File::OpenCFile(Path(opt.benchJsonFile), "ab");
+		if (!fp) {
+			fprintf(stderr, "Unable to write bench results to '%s'\n", opt.benchJsonFile);
+			return false;
+		}
+		fprintf(fp, "%s\n", str.c_str());
+		fclose(fp);
+	} else {
+		printf("%s\n", str.c_str());
+	}
+	return passed;
+}
+
 std::vector<std::string> ReadFromListFile(const std::string &listFilename) {
 	std::vector<std::string> testFilenames;
 	char temp[2048]{};
@@ -399,6 +593,14 @@ int main(int argc, const char* argv[])
 			testOptions.compare = true;
 		else if (!strcmp(argv[i], "--bench"))
 			testOptions.bench = true;
+		else if (!strncmp(argv[i], "--block-profile=", strlen("--block-profile=")) && strlen(argv[i]) > strlen("--block-profile="))
+			testOptions.blockProfileFile = argv[i] + strlen("--block-profile=");
+		else if (!strncmp(argv[i], "--hle-stats=", strlen("--hle-stats=")) && strlen(argv[i]) > strlen("--hle-stats="))
+			testOptions.hleStatsFile = argv[i] + strlen("--hle-stats=");
+		else if (!strncmp(argv[i], "--replay-bench=", strlen("--replay-bench=")) && strlen(argv[i]) > strlen("--replay-bench="))
+			testOptions.replayBenchPasses = std::max(1, atoi(argv[i] + strlen("--replay-bench=")));
+		else if (!strncmp(argv[i], "--bench-json=", strlen("--bench-json=")) && strlen(argv[i]) > strlen("--bench-json="))
+			testOptions.benchJsonFile = argv[i] + strlen("--bench-json=");
 		else if (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose"))
 			testOptions.verbose = true;
 		else if (!strcmp(argv[i], "--old-atrac"))
@@ -609,6 +811,11 @@ int main(int argc, const char* argv[])
 	for (size_t i = 0; i < testFilenames.size(); ++i)
 	{
 		coreParameter.fileToStart = Path(testFilenames[i]);
+		if (testOptions.replayBenchPasses > 0) {
+			if (!RunReplayBench(headlessHost, coreParameter, testOptions))
+				failedTests.push_back(GetTestName(coreParameter.fileToStart));
+			continue;
+		}
 		if (testOptions.compare)
 			printf("%s:\n", coreParameter.fileToStart.c_str());
 		bool passed = RunAutoTest(headlessHost, coreParameter, testOptions);
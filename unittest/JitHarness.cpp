@@ -16,6 +16,7 @@
 // https://github.com/hrydgard/ppsspp and http://www.ppsspp.org/.
 
 #include <algorithm>
+#include <cstring>
 
 #include "ppsspp_config.h"
 
@@ -37,6 +38,10 @@
 #include "Core/CoreTiming.h"
 #include "Core/Config.h"
 #include "Core/HLE/HLE.h"
+#include "Core/HLE/ReplaceTables.h"
+
+#include "unittest/JitHarness.h"
+#include "unittest/UnitTest.h"
 
 // Temporary hacks around annoying linking errors.  Copied from Headless.
 void NativeFrame(GraphicsContext *graphicsContext) { }
@@ -225,3 +230,114 @@ bool TestJit() {
 
 	return jit_speed >= interp_speed;
 }
+
+bool TestIRProfiler() {
+	SetupJitHarness();
+
+	// A small loop, so there are plenty of block dispatches per run.
+	u32 base = PSP_GetUserMemoryBase();
+	u32 *p = (u32 *)Memory::GetPointer(base);
+	p[0] = MIPS_MAKE_ADDIU(MIPS_REG_V0, MIPS_REG_ZERO, 100);
+	p[1] = MIPS_MAKE_ADDIU(MIPS_REG_V0, MIPS_REG_V0, 0xFFFF);
+	p[2] = MIPS_MAKE_BNEZ(base + 8, base + 4, MIPS_REG_V0);
+	p[3] = MIPS_MAKE_NOP();
+	p[4] = MIPS_MAKE_SYSCALL("UnitTestFakeSyscalls", "UnitTestTerminator");
+	p[5] = MIPS_MAKE_BREAK(1);
+	p[6] = MIPS_MAKE_JR_RA();
+
+	auto run = [&](int times) {
+		for (int i = 0; i < times; ++i) {
+			currentMIPS->pc = base;
+			coreState = CORE_RUNNING_CPU;
+			while (coreState == CORE_RUNNING_CPU) {
+				mipsr4k.RunLoopUntil(1000000);
+			}
+		}
+	};
+	auto sampledExecutions = [](JitBlockCacheDebugInterface *cache) {
+		u64 executions = 0;
+		for (int i = 0; i < cache->GetNumBlocks(); ++i) {
+			if (cache->IsValidBlock(i))
+				executions += cache->GetBlockProfileStats(i).executions;
+		}
+		return executions;
+	};
+
+	mipsr4k.UpdateCore(CPUCore::IR_INTERPRETER);
+	JitBlockCacheDebugInterface *cache = MIPSComp::jit->GetBlockCacheDebugInterface();
+	EXPECT_TRUE(cache != nullptr);
+
+	// Run without sampling first, so the countdown to the next sample has been pushed far out.
+	run(4);
+	EXPECT_EQ_INT((int)sampledExecutions(cache), 0);
+
+	// Starting to sample must take effect right away.
+	EXPECT_TRUE(cache->SetProfileSampleInterval(4));
+	cache->ResetProfileStats();
+	run(4);
+	EXPECT_TRUE(sampledExecutions(cache) > 0);
+
+	// And stop again.
+	cache->SetProfileSampleInterval(0);
+	cache->ResetProfileStats();
+	run(4);
+	EXPECT_EQ_INT((int)sampledExecutions(cache), 0);
+
+	MIPSComp::jit->ClearCache();
+	DestroyJitHarness();
+	return true;
+}
+
+bool TestIRAsyncReplacement() {
+	// Background compiles need worker threads.
+	bool initedThreads = SetupTestThreads(1);
+	SetupJitHarness();
+	const bool savedAsync = g_Config.bIRAsyncCompile;
+	g_Config.bIRAsyncCompile = true;
+
+	int memsetIndex = -1;
+	for (int i = 0; i < GetNumReplacementFuncs(); ++i) {
+		const ReplacementTableEntry *entry = GetReplacementFunc(i);
+		if (entry->name && !strcmp(entry->name, "memset"))
+			memsetIndex = i;
+	}
+	EXPECT_TRUE(memsetIndex >= 0);
+
+	// Call a replaced function, which starts with a replacement op rather than a block.
+	u32 base = PSP_GetUserMemoryBase();
+	u32 func = base + 0x100;
+	u32 dest = base + 0x400;
+	u32 *p = (u32 *)Memory::GetPointer(base);
+	p[0] = MIPS_MAKE_LUI(MIPS_REG_A0, dest >> 16);
+	p[1] = MIPS_MAKE_ORI(MIPS_REG_A0, MIPS_REG_A0, dest & 0xFFFF);
+	p[2] = MIPS_MAKE_ADDIU(MIPS_REG_A1, MIPS_REG_ZERO, 0x5A);
+	p[3] = MIPS_MAKE_ADDIU(MIPS_REG_A2, MIPS_REG_ZERO, 16);
+	p[4] = MIPS_MAKE_JAL(func);
+	p[5] = MIPS_MAKE_NOP();
+	p[6] = MIPS_MAKE_SYSCALL("UnitTestFakeSyscalls", "UnitTestTerminator");
+	p[7] = MIPS_MAKE_BREAK(1);
+	Memory::Write_U32(MIPS_EMUHACK_CALL_REPLACEMENT | memsetIndex, func);
+	Memory::Write_U32(MIPS_MAKE_JR_RA(), func + 4);
+	Memory::Write_U32(MIPS_MAKE_NOP(), func + 8);
+
+	mipsr4k.UpdateCore(CPUCore::JIT_IR);
+	// The first runs go through the interpreter while the blocks compile, later ones run them.
+	for (int i = 0; i < 8; ++i) {
+		memset(Memory::GetPointerWrite(dest), 0, 16);
+		currentMIPS->pc = base;
+		coreState = CORE_RUNNING_CPU;
+		while (coreState == CORE_RUNNING_CPU) {
+			mipsr4k.RunLoopUntil(1000000);
+		}
+		EXPECT_EQ_HEX(Memory::Read_U32(dest), 0x5A5A5A5AU);
+		EXPECT_EQ_HEX(Memory::Read_U32(dest + 12), 0x5A5A5A5AU);
+		EXPECT_EQ_HEX(Memory::Read_U32(dest + 16), 0U);
+	}
+
+	MIPSComp::jit->ClearCache();
+	mipsr4k.UpdateCore(CPUCore::INTERPRETER);
+	g_Config.bIRAsyncCompile = savedAsync;
+	DestroyJitHarness();
+	DestroyTestThreads(initedThreads);
+	return true;
+}
@@ -18,3 +18,5 @@
 #pragma once
 
 bool TestJit();
+bool TestIRProfiler();
+bool TestIRAsyncReplacement();
@@ -0,0 +1,290 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common/Serialize/Serializer.h"
+#include "Common/TimeUtil.h"
+#include "Core/Util/BlockAllocator.h"
+
+#include "UnitTest.h"
+
+// The list walking allocator BlockAllocator used to be, as a reference for placement and speed.
+class ListAllocator {
+public:
+	ListAllocator(u32 grain, u32 start, u32 size) : grain_(grain) {
+		blocks_.push_back(Block{ start, size, false });
+	}
+
+	u32 AllocAligned(u32 &size, u32 sizeGrain, u32 grain, bool fromTop) {
+		if (grain < grain_)
+			grain = grain_;
+		if (sizeGrain < grain_)
+			sizeGrain = grain_;
+		size = (size + sizeGrain - 1) & ~(sizeGrain - 1);
+
+		if (!fromTop) {
+			for (size_t i = 0; i < blocks_.size(); ++i) {
+				u32 offset = blocks_[i].start % grain;
+				if (offset != 0)
+					offset = grain - offset;
+				u32 needed = offset + size;
+				if (!blocks_[i].taken && blocks_[i].size >= needed) {
+					if (blocks_[i].size != needed)
+						InsertFreeAfter(i, blocks_[i].size - needed);
+					if (offset >= grain_)
+						i = InsertFreeBefore(i, offset);
+					blocks_[i].taken = true;
+					return blocks_[i].start;
+				}
+			}
+		} else {
+			for (size_t i = blocks_.size(); i-- > 0; ) {
+				u32 offset = (blocks_[i].start + blocks_[i].size - size) % grain;
+				u32 needed = offset + size;
+				if (!blocks_[i].taken && blocks_[i].size >= needed) {
+					if (blocks_[i].size != needed)
+						i = InsertFreeBefore(i, blocks_[i].size - needed);
+					if (offset >= grain_)
+						InsertFreeAfter(i, offset);
+					blocks_[i].taken = true;
+					return blocks_[i].start;
+				}
+			}
+		}
+		return -1;
+	}
+
+	u32 AllocAt(u32 position, u32 size) {
+		u32 alignedPosition = position & ~(grain_ - 1);
+		u32 alignedSize = (size + position - alignedPosition + grain_ - 1) & ~(grain_ - 1);
+		int i = Find(alignedPosition);
+		if (i < 0 || blocks_[i].taken || blocks_[i].start + blocks_[i].size < alignedPosition + alignedSize)
+			return -1;
+		if (blocks_[i].start != alignedPosition)
+			i = (int)InsertFreeBefore(i, alignedPosition - blocks_[i].start);
+		if (blocks_[i].size > alignedSize)
+			InsertFreeAfter(i, blocks_[i].size - alignedSize);
+		blocks_[i].taken = true;
+		return position;
+	}
+
+	bool Free(u32 position) {
+		int i = Find(position);
+		if (i < 0 || !blocks_[i].taken)
+			return false;
+		blocks_[i].taken = false;
+		while (i > 0 && !blocks_[i - 1].taken) {
+			blocks_[i - 1].size += blocks_[i].size;
+			blocks_.erase(blocks_.begin() + i);
+			--i;
+		}
+		while (i + 1 < (int)blocks_.size() && !blocks_[i + 1].taken) {
+			blocks_[i].size += blocks_[i + 1].size;
+			blocks_.erase(blocks_.begin() + i + 1);
+		}
+		return true;
+	}
+
+	u32 GetBlockStartFromAddress(u32 addr) const {
+		int i = Find(addr);
+		return i < 0 ? -1 : blocks_[i].start;
+	}
+
+	u32 GetBlockSizeFromAddress(u32 addr) const {
+		int i = Find(addr);
+		return i < 0 ? -1 : blocks_[i].size;
+	}
+
+	u32 GetLargestFreeBlockSize() const {
+		u32 largest = 0;
+		for (const Block &b : blocks_) {
+			if (!b.taken && b.size > largest)
+				largest = b.size;
+		}
+		return largest;
+	}
+
+	u32 GetTotalFreeBytes() const {
+		u32 sum = 0;
+		for (const Block &b : blocks_) {
+			if (!b.taken)
+				sum += b.size;
+		}
+		return sum;
+	}
+
+private:
+	struct Block {
+		u32 start;
+		u32 size;
+		bool taken;
+	};
+
+	int Find(u32 addr) const {
+		for (size_t i = 0; i < blocks_.size(); ++i) {
+			if (blocks_[i].start <= addr && blocks_[i].start + blocks_[i].size > addr)
+				return (int)i;
+		}
+		return -1;
+	}
+
+	// Returns the new index of block i.
+	size_t InsertFreeBefore(size_t i, u32 size) {
+		Block inserted{ blocks_[i].start, size, false };
+		blocks_[i].start += size;
+		blocks_[i].size -= size;
+		blocks_.insert(blocks_.begin() + i, inserted);
+		return i + 1;
+	}
+
+	void InsertFreeAfter(size_t i, u32 size) {
+		Block inserted{ blocks_[i].start + blocks_[i].size - size, size, false };
+		blocks_[i].size -= size;
+		blocks_.insert(blocks_.begin() + i + 1, inserted);
+	}
+
+	u32 grain_;
+	std::vector<Block> blocks_;
+};
+
+static const u32 RANGE_START = 0x08800000;
+static const u32 RANGE_SIZE = 0x01800000;
+
+enum class TraceOp {
+	ALLOC,
+	ALLOC_TOP,
+	ALLOC_ALIGNED,
+	ALLOC_AT,
+	FREE,
+};
+
+struct TraceEntry {
+	TraceOp op;
+	u32 size;
+	u32 arg;
+};
+
+// Lots of small, short lived allocations with some larger ones, like games churning
+// partition memory or FPL/VPL pools.
+static std::vector<TraceEntry> GenerateTrace(u32 seed, int count) {
+	std::mt19937 rng(seed);
+	std::vector<TraceEntry> trace;
+	int live = 0;
+	for (int i = 0; i < count; ++i) {
+		u32 r = rng() % 100;
+		if (live > 0 && (r < 45 || live > 3000)) {
+			// Which live allocation to free is picked at replay time.
+			trace.push_back(TraceEntry{ TraceOp::FREE, 0, (u32)rng() });
+			live--;
+			continue;
+		}
+		u32 size = (rng() % 16 == 0) ? 0x1000 + (rng() % 0x10000) : 0x10 + (rng() % 0x800);
+		if (r < 85) {
+			trace.push_back(TraceEntry{ TraceOp::ALLOC, size, 0 });
+		} else if (r < 93) {
+			trace.push_back(TraceEntry{ TraceOp::ALLOC_TOP, size, 0 });
+		} else if (r < 98) {
+			trace.push_back(TraceEntry{ TraceOp::ALLOC_ALIGNED, size, 0x100u << (rng() % 6) });
+		} else {
+			trace.push_back(TraceEntry{ TraceOp::ALLOC_AT, size, RANGE_START + (u32)(rng() % RANGE_SIZE) });
+		}
+		live++;
+	}
+	return trace;
+}
+
+template <typename T>
+static u32 ReplayOp(T &alloc, const TraceEntry &entry, std::vector<u32> &live) {
+	u32 size = entry.size;
+	u32 result = -1;
+	switch (entry.op) {
+	case TraceOp::ALLOC: result = alloc.AllocAligned(size, 0, 0, false); break;
+	case TraceOp::ALLOC_TOP: result = alloc.AllocAligned(size, 0, 0, true); break;
+	case TraceOp::ALLOC_ALIGNED: result = alloc.AllocAligned(size, 0, entry.arg, (entry.arg & 0x200) != 0); break;
+	case TraceOp::ALLOC_AT: result = alloc.AllocAt(entry.arg, size); break;
+	case TraceOp::FREE:
+		if (!live.empty()) {
+			size_t i = entry.arg % live.size();
+			result = alloc.Free(live[i]) ? live[i] : -2;
+			live[i] = live.back();
+			live.pop_back();
+		}
+		return result;
+	}
+	if (result != (u32)-1)
+		live.push_back(result);
+	return result;
+}
+
+static bool TestAllocatorPlacement() {
+	std::vector<TraceEntry> trace = GenerateTrace(1234, 20000);
+	std::mt19937 rng(5678);
+
+	BlockAllocator alloc(256);
+	alloc.Init(RANGE_START, RANGE_SIZE, false);
+	ListAllocator reference(256, RANGE_START, RANGE_SIZE);
+	std::vector<u32> live, referenceLive;
+
+	for (size_t i = 0; i < trace.size(); ++i) {
+		u32 actual = ReplayOp(alloc, trace[i], live);
+		u32 expected = ReplayOp(reference, trace[i], referenceLive);
+		EXPECT_EQ_HEX(actual, expected);
+
+		if (i == trace.size() / 2) {
+			// The index isn't saved, so make sure it's rebuilt properly after loading.
+			std::vector<u8> state;
+			EXPECT_TRUE(CChunkFileReader::MeasureAndSavePtr(alloc, &state) == CChunkFileReader::ERROR_NONE);
+			std::string errorString;
+			EXPECT_TRUE(CChunkFileReader::LoadPtr(state.data(), alloc, &errorString) == CChunkFileReader::ERROR_NONE);
+		}
+
+		if ((i % 97) == 0) {
+			EXPECT_EQ_HEX(alloc.GetLargestFreeBlockSize(), reference.GetLargestFreeBlockSize());
+			EXPECT_EQ_HEX(alloc.GetTotalFreeBytes(), reference.GetTotalFreeBytes());
+			for (int j = 0; j < 8; ++j) {
+				u32 addr = RANGE_START - 0x100 + (rng() % (RANGE_SIZE + 0x200));
+				EXPECT_EQ_HEX(alloc.GetBlockStartFromAddress(addr), reference.GetBlockStartFromAddress(addr));
+				EXPECT_EQ_HEX(alloc.GetBlockSizeFromAddress(addr), reference.GetBlockSizeFromAddress(addr));
+			}
+		}
+	}
+
+	// Free everything, should be back to one block.
+	for (u32 addr : live)
+		EXPECT_TRUE(alloc.Free(addr));
+	EXPECT_EQ_HEX(alloc.GetLargestFreeBlockSize(), RANGE_SIZE);
+	EXPECT_EQ_HEX(alloc.GetBlockStartFromAddress(RANGE_START + 0x1234), RANGE_START);
+	EXPECT_FALSE(alloc.Free(RANGE_START));
+	return true;
+}
+
+bool BenchBlockAllocator() {
+	std::vector<TraceEntry> trace = GenerateTrace(9012, 100000);
+
+	double start = time_now_d();
+	{
+		ListAllocator reference(256, RANGE_START, RANGE_SIZE);
+		std::vector<u32> live;
+		for (const TraceEntry &entry : trace)
+			ReplayOp(reference, entry, live);
+	}
+	double listTime = time_now_d() - start;
+
+	start = time_now_d();
+	{
+		BlockAllocator alloc(256);
+		alloc.Init(RANGE_START, RANGE_SIZE, false);
+		std::vector<u32> live;
+		for (const TraceEntry &entry : trace)
+			ReplayOp(alloc, entry, live);
+	}
+	double treeTime = time_now_d() - start;
+
+	printf("BlockAllocator: %d trace operations: list %0.2f ms, tree %0.2f ms\n", (int)trace.size(), listTime * 1000.0, treeTime * 1000.0);
+	return true;
+}
+
+bool TestBlockAllocator() {
+	return TestAllocatorPlacement();
+}
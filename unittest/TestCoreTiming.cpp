@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "Core/CoreTiming.h"
+#include "Core/MIPS/MIPS.h"
+
+#include "UnitTest.h"
+
+// The sorted linked list CoreTiming used to use, as a reference for ordering and speed.
+class ListEventQueue {
+public:
+	~ListEventQueue() {
+		while (first_) {
+			Node *next = first_->next;
+			delete first_;
+			first_ = next;
+		}
+	}
+
+	void Schedule(s64 time, int type, u64 userdata) {
+		Node *ne = new Node{ time, userdata, type, nullptr };
+		Node **pNext = &first_;
+		while (*pNext && (*pNext)->time <= time)
+			pNext = &(*pNext)->next;
+		ne->next = *pNext;
+		*pNext = ne;
+	}
+
+	bool Unschedule(int type, u64 userdata) {
+		bool found = false;
+		Node **pNext = &first_;
+		while (*pNext) {
+			Node *cur = *pNext;
+			if (cur->type == type && cur->userdata == userdata) {
+				*pNext = cur->next;
+				delete cur;
+				found = true;
+			} else {
+				pNext = &cur->next;
+			}
+		}
+		return found;
+	}
+
+	bool Pop(int &type, u64 &userdata) {
+		if (!first_)
+			return false;
+		Node *cur = first_;
+		type = cur->type;
+		userdata = cur->userdata;
+		first_ = cur->next;
+		delete cur;
+		return true;
+	}
+
+private:
+	struct Node {
+		s64 time;
+		u64 userdata;
+		int type;
+		Node *next;
+	};
+	Node *first_ = nullptr;
+};
+
+struct FiredEvent {
+	int type;
+	u64 userdata;
+};
+
+static std::vector<FiredEvent> firedEvents;
+static int eventTypeA = -1;
+static int eventTypeB = -1;
+
+static void EventCallbackA(u64 userdata, int cyclesLate) {
+	firedEvents.push_back(FiredEvent{ eventTypeA, userdata });
+}
+
+static void EventCallbackB(u64 userdata, int cyclesLate) {
+	firedEvents.push_back(FiredEvent{ eventTypeB, userdata });
+}
+
+static bool TestEventOrder() {
+	std::mt19937 rng(1234);
+	ListEventQueue reference;
+
+	// Lots of identical times, to check that those fire in the order they were scheduled.
+	const int count = 2000;
+	for (int i = 0; i < count; ++i) {
+		s64 time = (rng() % 500) * 100;
+		int type = (rng() & 1) ? eventTypeA : eventTypeB;
+		CoreTiming::ScheduleEvent(time, type, i);
+		reference.Schedule(time, type, i);
+	}
+	for (int i = 0; i < count; i += 3) {
+		int type = (rng() & 1) ? eventTypeA : eventTypeB;
+		bool found = reference.Unschedule(type, i);
+		s64 left = CoreTiming::UnscheduleEvent(type, i);
+		EXPECT_TRUE(found || left == 0);
+	}
+
+	// Run until everything has fired.
+	firedEvents.clear();
+	for (int i = 0; i < 10000 && (CoreTiming::IsScheduled(eventTypeA) || CoreTiming::IsScheduled(eventTypeB)); ++i) {
+		currentMIPS->downcount = 0;
+		CoreTiming::Advance();
+	}
+
+	for (const FiredEvent &fired : firedEvents) {
+		int type;
+		u64 userdata;
+		EXPECT_TRUE(reference.Pop(type, userdata));
+		EXPECT_EQ_INT(fired.type, type);
+		EXPECT_EQ_INT((int)fired.userdata, (int)userdata);
+	}
+	int type;
+	u64 userdata;
+	EXPECT_FALSE(reference.Pop(type, userdata));
+	return true;
+}
+
+static void SetupCoreTiming() {
+	currentMIPS = &mipsr4k;
+	CoreTiming::Init();
+	eventTypeA = CoreTiming::RegisterEvent("TestEventA", &EventCallbackA);
+	eventTypeB = CoreTiming::RegisterEvent("TestEventB", &EventCallbackB);
+}
+
+static void DestroyCoreTiming() {
+	CoreTiming::Shutdown();
+	currentMIPS = nullptr;
+}
+
+bool BenchCoreTiming() {
+	SetupCoreTiming();
+
+	const int pending = 2000;
+	const int iterations = 50000;
+
+	std::mt19937 rng(5678);
+	std::vector<s64> times(pending + iterations);
+	for (s64 &t : times)
+		t = rng() % 10000000;
+
+	double start = time_now_d();
+	{
+		ListEventQueue list;
+		for (int i = 0; i < pending; ++i)
+			list.Schedule(times[i], eventTypeA, i);
+		for (int i = 0; i < iterations; ++i) {
+			list.Unschedule(eventTypeA, i);
+			list.Schedule(times[pending + i], eventTypeA, pending + i);
+		}
+	}
+	double listTime = time_now_d() - start;
+
+	start = time_now_d();
+	for (int i = 0; i < pending; ++i)
+		CoreTiming::ScheduleEvent(times[i], eventTypeA, i);
+	for (int i = 0; i < iterations; ++i) {
+		CoreTiming::UnscheduleEvent(eventTypeA, i);
+		CoreTiming::ScheduleEvent(times[pending + i], eventTypeA, pending + i);
+	}
+	CoreTiming::ClearPendingEvents();
+	double heapTime = time_now_d() - start;
+
+	printf("CoreTiming: %d schedule/unschedule pairs with %d pending: list %0.2f ms, heap %0.2f ms\n", iterations, pending, listTime * 1000.0, heapTime * 1000.0);
+
+	DestroyCoreTiming();
+	return true;
+}
+
+bool TestCoreTiming() {
+	SetupCoreTiming();
+	bool success = TestEventOrder();
+	DestroyCoreTiming();
+	return success;
+}
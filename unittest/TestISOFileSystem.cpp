@@ -0,0 +1,196 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "Core/FileSystems/BlockDevices.h"
+#include "Core/FileSystems/ISOFileSystem.h"
+
+#include "UnitTest.h"
+
+// A disc image in memory, counting the reads.
+class MemoryBlockDevice : public BlockDevice {
+public:
+	MemoryBlockDevice(u32 numBlocks, int *readCount) : BlockDevice(nullptr), data_(numBlocks * 2048), readCount_(readCount) {}
+
+	bool ReadBlock(int blockNumber, u8 *outPtr, bool uncached = false) override {
+		if (blockNumber < 0 || (u32)blockNumber >= GetNumBlocks())
+			return false;
+		memcpy(outPtr, &data_[blockNumber * 2048], 2048);
+		(*readCount_)++;
+		return true;
+	}
+	u32 GetNumBlocks() const override { return (u32)(data_.size() / 2048); }
+	bool IsDisc() const override { return true; }
+
+	u8 *Block(u32 n) { return &data_[n * 2048]; }
+
+private:
+	std::vector<u8> data_;
+	int *readCount_;
+};
+
+static void PutBothEndian32(u8 *p, u32 v) {
+	for (int i = 0; i < 4; i++) {
+		p[i] = (u8)(v >> (i * 8));
+		p[7 - i] = (u8)(v >> (i * 8));
+	}
+}
+
+// Writes an ISO9660 directory record, returns its size.
+static int PutDirRecord(u8 *p, const std::string &name, u32 sector, u32 size, bool dir) {
+	int len = 33 + (int)name.size();
+	len += len & 1;
+	memset(p, 0, len);
+	p[0] = (u8)len;
+	PutBothEndian32(p + 2, sector);
+	PutBothEndian32(p + 10, size);
+	p[25] = dir ? 2 : 0;
+	p[32] = (u8)name.size();
+	memcpy(p + 33, name.data(), name.size());
+	return len;
+}
+
+struct TestDirEntry {
+	std::string name;
+	u32 sector;
+	u32 size;
+	bool dir;
+};
+
+// Directories can span several sectors, but records don't cross sectors.
+static void PutDirectory(MemoryBlockDevice *dev, u32 sector, u32 parent, const std::vector<TestDirEntry> &children) {
+	u8 *p = dev->Block(sector);
+	int offset = PutDirRecord(p, std::string(1, '\0'), sector, 2048, true);
+	offset += PutDirRecord(p + offset, std::string(1, '\1'), parent, 2048, true);
+	for (const TestDirEntry &child : children) {
+		if (offset + 33 + (int)child.name.size() + 1 > 2048) {
+			p = dev->Block(++sector);
+			offset = 0;
+		}
+		offset += PutDirRecord(p + offset, child.name, child.sector, child.size, child.dir);
+	}
+}
+
+static u32 DirSize(const std::vector<TestDirEntry> &children) {
+	// Rough, but enough to cover the sectors used by PutDirectory.
+	u32 bytes = 2 * 34;
+	for (const TestDirEntry &child : children)
+		bytes += 34 + (u32)child.name.size();
+	return (bytes / 1900 + 1) * 2048;
+}
+
+// Layout:
+// /FILE.BIN
+// /PSP_GAME/SUB/X.TXT
+// /PSP_GAME/DATA;1
+// /MANY/F0000 ... F1999
+static MemoryBlockDevice *CreateTestImage(int *readCount) {
+	const int manyFiles = 2000;
+	std::vector<TestDirEntry> many;
+	for (int i = 0; i < manyFiles; i++) {
+		char name[16];
+		snprintf(name, sizeof(name), "F%04d", i);
+		many.push_back(TestDirEntry{ name, 200, (u32)i, false });
+	}
+
+	std::vector<TestDirEntry> root = {
+		{ "FILE.BIN", 100, 5000, false },
+		{ "PSP_GAME", 21, 2048, true },
+		{ "MANY", 30, DirSize(many), true },
+	};
+	std::vector<TestDirEntry> game = {
+		{ "SUB", 22, 2048, true },
+		{ "DATA;1", 110, 1234, false },
+	};
+	std::vector<TestDirEntry> sub = {
+		{ "X.TXT", 120, 77, false },
+	};
+
+	MemoryBlockDevice *dev = new MemoryBlockDevice(256, readCount);
+	u8 *desc = dev->Block(16);
+	desc[0] = 1;
+	memcpy(desc + 1, "CD001", 5);
+	PutDirRecord(desc + 156, std::string(1, '\0'), 20, 2048, true);
+
+	PutDirectory(dev, 20, 20, root);
+	PutDirectory(dev, 21, 20, game);
+	PutDirectory(dev, 22, 21, sub);
+	PutDirectory(dev, 30, 20, many);
+	return dev;
+}
+
+static bool TestISOLookups() {
+	int reads = 0;
+	SequentialHandleAllocator handles;
+	ISOFileSystem iso(&handles, CreateTestImage(&reads));
+
+	// Nothing but the volume descriptor is read up front.
+	EXPECT_EQ_INT(reads, 1);
+
+	PSPFileInfo info = iso.GetFileInfo("/PSP_GAME/SUB/X.TXT");
+	EXPECT_TRUE(info.exists);
+	EXPECT_EQ_INT((int)info.size, 77);
+	EXPECT_EQ_INT(info.startSector, 120);
+	// Root, PSP_GAME, and SUB.
+	EXPECT_EQ_INT(reads, 4);
+
+	// All these are already known, so no more reads.
+	EXPECT_TRUE(iso.GetFileInfo("PSP_GAME/SUB/X.TXT").exists);
+	EXPECT_TRUE(iso.GetFileInfo("./PSP_GAME/SUB/X.TXT").exists);
+	EXPECT_TRUE(iso.GetFileInfo("/PSP_GAME/DATA;1").exists);
+	EXPECT_TRUE(iso.GetFileInfo("/PSP_GAME/SUB/").type == FILETYPE_DIRECTORY);
+	EXPECT_TRUE(iso.GetFileInfo("/FILE.BIN").exists);
+	EXPECT_FALSE(iso.GetFileInfo("/PSP_GAME/NOPE").exists);
+	EXPECT_FALSE(iso.GetFileInfo("/FILE.BIN/X.TXT").exists);
+	EXPECT_EQ_INT(reads, 4);
+
+	// Same rules as the old component by component walk.
+	EXPECT_FALSE(iso.GetFileInfo("/PSP_GAME//SUB").exists);
+	EXPECT_FALSE(iso.GetFileInfo("/PSP_GAME/SUB//").exists);
+	EXPECT_FALSE(iso.GetFileInfo("/psp_game/SUB/X.TXT").exists);
+	EXPECT_TRUE(iso.GetFileInfo("/PSP_GAME/../FILE.BIN").exists);
+	EXPECT_TRUE(iso.GetFileInfo("/").type == FILETYPE_DIRECTORY);
+
+	bool exists = false;
+	std::vector<PSPFileInfo> listing = iso.GetDirListing("/PSP_GAME", &exists);
+	EXPECT_TRUE(exists);
+	EXPECT_EQ_INT((int)listing.size(), 2);
+
+	// A big directory spanning several sectors.
+	PSPFileInfo last = iso.GetFileInfo("/MANY/F1999");
+	EXPECT_TRUE(last.exists);
+	EXPECT_EQ_INT((int)last.size, 1999);
+	listing = iso.GetDirListing("/MANY", &exists);
+	EXPECT_EQ_INT((int)listing.size(), 2000);
+
+	u32 handle = iso.OpenFile("/PSP_GAME/SUB/X.TXT", FILEACCESS_READ);
+	EXPECT_TRUE((s32)handle > 0);
+	EXPECT_EQ_INT((int)iso.GetFileInfoByHandle(handle).size, 77);
+	iso.CloseFile(handle);
+	return true;
+}
+
+bool BenchISOFileSystem() {
+	int reads = 0;
+	SequentialHandleAllocator handles;
+	ISOFileSystem iso(&handles, CreateTestImage(&reads));
+
+	const int lookups = 200000;
+	char path[32];
+	int found = 0;
+	double start = time_now_d();
+	for (int i = 0; i < lookups; i++) {
+		snprintf(path, sizeof(path), "/MANY/F%04d", (i * 7919) % 2000);
+		if (iso.GetFileInfo(path).exists)
+			found++;
+	}
+	double elapsed = time_now_d() - start;
+	printf("ISO lookups in a 2000 file directory: %0.3f us per lookup\n", elapsed * 1000000.0 / lookups);
+	return found == lookups;
+}
+
+bool TestISOFileSystem() {
+	return TestISOLookups();
+}
@@ -0,0 +1,163 @@
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <png.h>
+
+#include "Common/File/FileUtil.h"
+#include "Common/File/VFS/DirectoryReader.h"
+#include "GPU/Common/ReplacementArchive.h"
+#include "GPU/Common/TextureDecoder.h"
+
+#include "UnitTest.h"
+
+static bool WriteTestPNG(const Path &filename, int w, int h, bool alpha, const std::vector<u32> &pixels) {
+	png_image png{};
+	png.version = PNG_IMAGE_VERSION;
+	png.format = alpha ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB;
+	png.width = w;
+	png.height = h;
+
+	std::vector<u8> rgb;
+	const void *buffer = pixels.data();
+	if (!alpha) {
+		for (u32 pixel : pixels) {
+			rgb.push_back(pixel & 0xFF);
+			rgb.push_back((pixel >> 8) & 0xFF);
+			rgb.push_back((pixel >> 16) & 0xFF);
+		}
+		buffer = rgb.data();
+	}
+
+	FILE *fp = File::OpenCFile(filename, "wb");
+	if (!fp)
+		return false;
+	bool success = png_image_write_to_stdio(&png, fp, 0, buffer, 0, nullptr) != 0;
+	fclose(fp);
+	return success;
+}
+
+static bool WriteTestFile(const Path &filename, const std::string &contents) {
+	FILE *fp = File::OpenCFile(filename, "wb");
+	if (!fp)
+		return false;
+	bool success = fwrite(contents.data(), 1, contents.size(), fp) == contents.size();
+	fclose(fp);
+	return success;
+}
+
+static bool HasListing(const std::vector<File::FileInfo> &listing, const char *name, bool isDirectory) {
+	for (const auto &file : listing) {
+		if (file.name == name && file.isDirectory == isDirectory)
+			return true;
+	}
+	return false;
+}
+
+bool TestReplacementArchive() {
+	const Path dir("replacement_archive_test");
+	const Path archiveFilename = dir / "textures.pack";
+	File::DeleteDirRecursively(dir);
+	EXPECT_TRUE(File::CreateDir(dir));
+	EXPECT_TRUE(File::CreateDir(dir / "sub"));
+	EXPECT_TRUE(File::CreateDir(dir / "new"));
+
+	const std::vector<u32> translucent = { 0xFF0000FF, 0x8000FF00, 0xFFFF0000, 0xFFFFFFFF, 0x00000000, 0xFF123456, 0xFF654321, 0x7F7F7F7F };
+	const std::vector<u32> opaque = { 0xFF102030, 0xFF405060 };
+	const std::string ini = "[options]\nversion = 1\n\n[hashes]\n0000000012345678 = Foo.png\n";
+	const std::string raw = "DDS not really, stored as-is";
+
+	EXPECT_TRUE(WriteTestPNG(dir / "Foo.png", 4, 2, true, translucent));
+	EXPECT_TRUE(WriteTestPNG(dir / "opaque.png", 2, 1, false, opaque));
+	EXPECT_TRUE(WriteTestFile(dir / "textures.ini", ini));
+	EXPECT_TRUE(WriteTestFile(dir / "sub" / "raw.dds", raw));
+	EXPECT_TRUE(WriteTestFile(dir / "new" / "dumped.png", "skipped"));
+
+	const std::vector<std::string> skip = { "textures.pack", "new" };
+	const u64 stamp = ReplacementArchive::ComputeSourceStamp(dir, skip);
+	EXPECT_TRUE(stamp != 0);
+	{
+		DirectoryReader source(dir);
+		std::string error;
+		EXPECT_TRUE(ReplacementArchive::Build(&source, archiveFilename, skip, stamp, &error));
+	}
+
+	std::unique_ptr<ReplacementArchive> archive(ReplacementArchive::Create(archiveFilename));
+	EXPECT_TRUE(archive != nullptr);
+	EXPECT_TRUE(archive->SourceStamp() == stamp);
+
+	// The archive itself and skipped directories don't count, but changes to the pack do.
+	EXPECT_TRUE(WriteTestFile(dir / "new" / "dumped2.png", "skipped"));
+	EXPECT_TRUE(ReplacementArchive::ComputeSourceStamp(dir, skip) == stamp);
+	EXPECT_TRUE(WriteTestFile(dir / "sub" / "extra.dds", raw));
+	EXPECT_TRUE(ReplacementArchive::ComputeSourceStamp(dir, skip) != stamp);
+	EXPECT_TRUE(File::Delete(dir / "sub" / "extra.dds"));
+	EXPECT_TRUE(WriteTestFile(dir / "sub" / "raw.dds", raw + "!"));
+	EXPECT_TRUE(ReplacementArchive::ComputeSourceStamp(dir, skip) != stamp);
+	EXPECT_TRUE(ReplacementArchive::ComputeSourceStamp(dir / "missing", skip) == 0);
+
+	// Images are decoded, lookups ignore case and slash direction like zips.
+	ReplacementArchiveLevel level;
+	EXPECT_TRUE(archive->FindLevel("foo.PNG", &level));
+	EXPECT_EQ_INT(level.w, 4);
+	EXPECT_EQ_INT(level.h, 2);
+	EXPECT_EQ_INT((int)level.size, 4 * 2 * 4);
+	EXPECT_TRUE(memcmp(level.data, translucent.data(), level.size) == 0);
+	EXPECT_EQ_INT(level.alphaStatus, CHECKALPHA_ANY);
+
+	EXPECT_TRUE(archive->FindLevel("opaque.png", &level));
+	EXPECT_EQ_INT(level.alphaStatus, CHECKALPHA_FULL);
+	EXPECT_EQ_HEX(((const u32 *)level.data)[1], opaque[1]);
+
+	// Everything else is stored as-is.
+	EXPECT_FALSE(archive->FindLevel("sub/raw.dds", &level));
+	size_t size = 0;
+	uint8_t *data = archive->ReadFile("SUB\\raw.dds", &size);
+	EXPECT_TRUE(data != nullptr);
+	EXPECT_TRUE(size == raw.size() && memcmp(data, raw.data(), size) == 0);
+	delete[] data;
+
+	VFSFileReference *ref = archive->GetFile("textures.ini");
+	EXPECT_TRUE(ref != nullptr);
+	VFSOpenFile *openFile = archive->OpenFileForRead(ref, &size);
+	EXPECT_EQ_INT((int)size, (int)ini.size());
+	char buffer[9]{};
+	EXPECT_EQ_INT((int)archive->Read(openFile, buffer, 8), 8);
+	EXPECT_TRUE(memcmp(buffer, "[options", 8) == 0);
+	archive->Rewind(openFile);
+	std::string contents(ini.size() + 16, '\0');
+	contents.resize(archive->Read(openFile, &contents[0], contents.size()));
+	EXPECT_TRUE(contents == ini);
+	archive->CloseFile(openFile);
+	archive->ReleaseFile(ref);
+
+	EXPECT_TRUE(archive->GetFile("new/dumped.png") == nullptr);
+	EXPECT_TRUE(archive->GetFile("textures.pack") == nullptr);
+	EXPECT_TRUE(archive->GetFile("missing.png") == nullptr);
+
+	std::vector<File::FileInfo> listing;
+	EXPECT_TRUE(archive->GetFileListing("", &listing, nullptr));
+	EXPECT_EQ_INT((int)listing.size(), 4);
+	EXPECT_TRUE(HasListing(listing, "Foo.png", false));
+	EXPECT_TRUE(HasListing(listing, "textures.ini", false));
+	EXPECT_TRUE(HasListing(listing, "sub", true));
+	// Like in zips, the filter doesn't apply to directories.
+	EXPECT_TRUE(archive->GetFileListing("", &listing, "png"));
+	EXPECT_TRUE(HasListing(listing, "opaque.png", false));
+	EXPECT_FALSE(HasListing(listing, "textures.ini", false));
+	EXPECT_TRUE(archive->GetFileListing("sub", &listing, nullptr));
+	EXPECT_TRUE(HasListing(listing, "raw.dds", false));
+	EXPECT_FALSE(archive->GetFileListing("new", &listing, nullptr));
+
+	File::FileInfo info;
+	EXPECT_TRUE(archive->GetFileInfo("sub", &info));
+	EXPECT_TRUE(info.isDirectory);
+	archive.reset();
+
+	// Damaged archives are ignored, so the directory or zip gets used instead.
+	EXPECT_TRUE(WriteTestFile(archiveFilename, "PPPA but not much else"));
+	EXPECT_TRUE(ReplacementArchive::Create(archiveFilename) == nullptr);
+
+	File::DeleteDirRecursively(dir);
+	return true;
+}
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "Core/Config.h"
+#include "Core/MemMap.h"
+#include "Core/HW/SasAudio.h"
+
+#include "UnitTest.h"
+
+static std::mt19937 rng(4321);
+
+static int RandomRange(int low, int high) {
+	return low + (int)(rng() % (u32)(high - low + 1));
+}
+
+static void FillRandomS16(std::vector<s16> &data) {
+	for (s16 &v : data)
+		v = (s16)rng();
+}
+
+static bool TestVagNibbles() {
+	u8 block[14];
+	s16 expected[28];
+	s16 actual[28];
+	for (int i = 0; i < 200; ++i) {
+		for (u8 &b : block)
+			b = (u8)rng();
+		for (int shift = 0; shift < 16; ++shift) {
+			SasDecodeVagNibblesGeneric(expected, block, shift);
+			SasDecodeVagNibbles(actual, block, shift);
+			EXPECT_EQ_INT(memcmp(expected, actual, sizeof(expected)), 0);
+		}
+	}
+	return true;
+}
+
+static bool TestResample() {
+	std::vector<s16> in(PSP_SAS_MAX_GRAIN * 4 + 2);
+	std::vector<s16> expected(PSP_SAS_MAX_GRAIN);
+	std::vector<s16> actual(PSP_SAS_MAX_GRAIN);
+	FillRandomS16(in);
+	// Make sure the extremes are in there.
+	in[10] = -32768;
+	in[11] = -32768;
+	in[12] = 32767;
+	in[13] = 32767;
+
+	for (int i = 0; i < 500; ++i) {
+		int pitch = RandomRange(1, PSP_SAS_PITCH_MAX);
+		u32 frac = rng() & PSP_SAS_PITCH_MASK;
+		int count = RandomRange(0, PSP_SAS_MAX_GRAIN);
+		// Stay within the input, as the mixer does.
+		while (count > 0 && ((frac + (u32)pitch * count) >> PSP_SAS_PITCH_BASE_SHIFT) + 1 >= in.size())
+			count /= 2;
+		SasResampleGeneric(expected.data(), in.data(), frac, pitch, count);
+		SasResample(actual.data(), in.data(), frac, pitch, count);
+		EXPECT_EQ_INT(memcmp(expected.data(), actual.data(), count * sizeof(s16)), 0);
+	}
+	return true;
+}
+
+static bool TestMixSamples() {
+	const int maxCount = 1029;
+	std::vector<s16> samples(maxCount);
+	std::vector<int> envelope(maxCount);
+	std::vector<int> mixExpected(maxCount * 2), sendExpected(maxCount * 2);
+	std::vector<int> mixActual(maxCount * 2), sendActual(maxCount * 2);
+
+	for (int i = 0; i < 300; ++i) {
+		FillRandomS16(samples);
+		// Mostly valid envelopes, sometimes something odd to check the fallback.
+		const bool oddEnvelope = (i % 10) == 9;
+		for (int &e : envelope)
+			e = oddEnvelope ? RandomRange(-0x10000, 0x10000) : RandomRange(0, 0x8000);
+		envelope[0] = oddEnvelope ? envelope[0] : 0x8000;
+		for (size_t j = 0; j < mixExpected.size(); ++j) {
+			mixExpected[j] = mixActual[j] = RandomRange(-0x100000, 0x100000);
+			sendExpected[j] = sendActual[j] = RandomRange(-0x100000, 0x100000);
+		}
+
+		int count = RandomRange(0, maxCount);
+		int volumeLeft = RandomRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		int volumeRight = RandomRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		int effectLeft = RandomRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		int effectRight = (i & 1) ? PSP_SAS_VOL_MAX : -PSP_SAS_VOL_MAX;
+		SasMixSamplesGeneric(mixExpected.data(), sendExpected.data(), samples.data(), envelope.data(), count, volumeLeft, volumeRight, effectLeft, effectRight);
+		SasMixSamples(mixActual.data(), sendActual.data(), samples.data(), envelope.data(), count, volumeLeft, volumeRight, effectLeft, effectRight);
+		EXPECT_TRUE(mixExpected == mixActual);
+		EXPECT_TRUE(sendExpected == sendActual);
+	}
+
+	// Right around the edge of what the SIMD path accepts, with extreme samples.
+	static const int boundaryEnvelopes[] = { 0x8000, 0x8001, 0xBFFF };
+	for (int env : boundaryEnvelopes) {
+		for (int j = 0; j < maxCount; ++j)
+			samples[j] = (j & 1) ? -32768 : 32767;
+		std::fill(envelope.begin(), envelope.end(), env);
+		std::fill(mixExpected.begin(), mixExpected.end(), 0);
+		std::fill(sendExpected.begin(), sendExpected.end(), 0);
+		mixActual = mixExpected;
+		sendActual = sendExpected;
+		SasMixSamplesGeneric(mixExpected.data(), sendExpected.data(), samples.data(), envelope.data(), maxCount, PSP_SAS_VOL_MAX, -PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		SasMixSamples(mixActual.data(), sendActual.data(), samples.data(), envelope.data(), maxCount, PSP_SAS_VOL_MAX, -PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		EXPECT_TRUE(mixExpected == mixActual);
+		EXPECT_TRUE(sendExpected == sendActual);
+	}
+	return true;
+}
+
+static bool TestWriteMixedOutput() {
+	const int maxCount = 517;
+	std::vector<s16> inp(maxCount * 2), wet(maxCount * 2);
+	std::vector<int> dry(maxCount * 2);
+	std::vector<s16> expected(maxCount * 2), actual(maxCount * 2);
+
+	for (int i = 0; i < 160; ++i) {
+		FillRandomS16(inp);
+		FillRandomS16(wet);
+		// Large enough to clamp now and then.
+		for (int &v : dry)
+			v = RandomRange(-0x10000, 0x10000);
+
+		int count = RandomRange(0, maxCount);
+		int leftVol = RandomRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		int rightVol = RandomRange(-PSP_SAS_VOL_MAX, PSP_SAS_VOL_MAX);
+		const s16 *inPtr = (i & 1) ? inp.data() : nullptr;
+		const int *dryPtr = (i & 2) ? dry.data() : nullptr;
+		const s16 *wetPtr = (i & 4) ? wet.data() : nullptr;
+		SasWriteMixedOutputGeneric(expected.data(), inPtr, dryPtr, wetPtr, count, leftVol, rightVol);
+		SasWriteMixedOutput(actual.data(), inPtr, dryPtr, wetPtr, count, leftVol, rightVol);
+		EXPECT_EQ_INT(memcmp(expected.data(), actual.data(), count * 2 * sizeof(s16)), 0);
+	}
+	return true;
+}
+
+bool BenchSasAudio() {
+	// A full mix of 32 voices at a common grain size, in pieces.
+	const int grain = 256;
+	const int voices = PSP_SAS_VOICES_MAX;
+	const int iterations = 400;
+
+	std::vector<u8> vag(grain / 28 * 14 + 14);
+	for (u8 &b : vag)
+		b = (u8)rng();
+	std::vector<s16> in(grain * 2 + 2), resampled(grain), out(grain * 2);
+	std::vector<int> envelope(grain), mix(grain * 2), send(grain * 2);
+	FillRandomS16(in);
+	for (int &e : envelope)
+		e = RandomRange(0, 0x8000);
+
+	auto run = [&](bool generic) {
+		double start = time_now_d();
+		for (int n = 0; n < iterations; ++n) {
+			for (int v = 0; v < voices; ++v) {
+				for (int b = 0; b + 28 <= grain; b += 28) {
+					if (generic)
+						SasDecodeVagNibblesGeneric(&in[b], &vag[b / 2], v & 0xF);
+					else
+						SasDecodeVagNibbles(&in[b], &vag[b / 2], v & 0xF);
+				}
+				if (generic) {
+					SasResampleGeneric(resampled.data(), in.data(), v * 100, 0x0C00 + v * 16, grain);
+					SasMixSamplesGeneric(mix.data(), send.data(), resampled.data(), envelope.data(), grain, 0x1000, 0x800, 0x400, 0x200);
+				} else {
+					SasResample(resampled.data(), in.data(), v * 100, 0x0C00 + v * 16, grain);
+					SasMixSamples(mix.data(), send.data(), resampled.data(), envelope.data(), grain, 0x1000, 0x800, 0x400, 0x200);
+				}
+			}
+			if (generic)
+				SasWriteMixedOutputGeneric(out.data(), nullptr, mix.data(), in.data(), grain, 0x1000, 0x1000);
+			else
+				SasWriteMixedOutput(out.data(), nullptr, mix.data(), in.data(), grain, 0x1000, 0x1000);
+			memset(mix.data(), 0, mix.size() * sizeof(int));
+			memset(send.data(), 0, send.size() * sizeof(int));
+		}
+		return (time_now_d() - start) * 1000000.0 / iterations;
+	};
+
+	double genericTime = run(true);
+	double simdTime = run(false);
+	printf("SAS mixing, %d voices, grain %d: %0.2f us generic, %0.2f us SIMD\n", voices, grain, genericTime, simdTime);
+	return true;
+}
+
+static void SetupVoices(SasInstance &sas, u32 dataAddr, u32 dataSize) {
+	// Both passes need the exact same setup.
+	std::mt19937 voiceRng(8765);
+	sas.SetGrainSize(256);
+	for (int v = 0; v < PSP_SAS_VOICES_MAX; v++) {
+		SasVoice &voice = sas.voices[v];
+		u32 offset = (voiceRng() % (dataSize / 2)) & ~15;
+		if (v % 3 == 2) {
+			voice.type = VOICETYPE_PCM;
+			voice.pcmAddr = dataAddr + offset;
+			voice.pcmSize = 4000;
+			voice.pcmLoopPos = 100;
+			voice.loop = true;
+		} else {
+			voice.type = VOICETYPE_VAG;
+			voice.vagAddr = dataAddr + offset;
+			voice.vagSize = 0x8000;
+			voice.loop = (v & 1) != 0;
+		}
+		voice.pitch = PSP_SAS_PITCH_BASE / 2 + (int)(voiceRng() % PSP_SAS_PITCH_BASE);
+		voice.volumeLeft = (int)(voiceRng() % (PSP_SAS_VOL_MAX * 2 + 1)) - PSP_SAS_VOL_MAX;
+		voice.volumeRight = (int)(voiceRng() % (PSP_SAS_VOL_MAX * 2 + 1)) - PSP_SAS_VOL_MAX;
+		voice.effectLeft = (int)(voiceRng() % (PSP_SAS_VOL_MAX * 2 + 1)) - PSP_SAS_VOL_MAX;
+		voice.effectRight = (int)(voiceRng() % (PSP_SAS_VOL_MAX * 2 + 1)) - PSP_SAS_VOL_MAX;
+		voice.envelope.SetSimpleEnvelope(0x000F, 0x1FC6);
+		voice.KeyOn();
+	}
+	sas.waveformEffect.isWetOn = 1;
+	sas.SetWaveformEffectType(PSP_SAS_EFFECT_TYPE_HALL);
+}
+
+static bool TestParallelMix() {
+	const u32 dataAddr = 0x08800000;
+	const u32 dataSize = 0x100000;
+	const u32 outAddr = dataAddr + dataSize;
+	const int grains = 40;
+
+	u8 *data = Memory::GetPointerWriteRange(dataAddr, dataSize);
+	for (u32 i = 0; i < dataSize; i++)
+		data[i] = (u8)rng();
+
+	const bool savedParallel = g_Config.bParallelSasMix;
+	std::vector<s16> serialOut, parallelOut;
+	for (int pass = 0; pass < 2; pass++) {
+		g_Config.bParallelSasMix = pass == 1;
+		SasInstance sas;
+		SetupVoices(sas, dataAddr, dataSize);
+		std::vector<s16> &out = pass == 1 ? parallelOut : serialOut;
+		for (int i = 0; i < grains; i++) {
+			if (i == grains / 2)
+				sas.voices[3].KeyOff();
+			sas.Mix(outAddr, 0, 0, 0, false);
+			const s16 *mixed = (const s16 *)Memory::GetPointerRange(outAddr, sas.GetGrainSize() * 4);
+			out.insert(out.end(), mixed, mixed + sas.GetGrainSize() * 2);
+		}
+	}
+	g_Config.bParallelSasMix = savedParallel;
+
+	EXPECT_EQ_INT((int)serialOut.size(), (int)parallelOut.size());
+	EXPECT_TRUE(serialOut == parallelOut);
+	// Make sure something was actually mixed.
+	EXPECT_TRUE(std::any_of(serialOut.begin(), serialOut.end(), [](s16 v) { return v != 0; }));
+	return true;
+}
+
+bool TestSasAudio() {
+	if (!TestVagNibbles() || !TestResample() || !TestMixSamples() || !TestWriteMixedOutput())
+		return false;
+
+	// The parallel mix needs worker threads and PSP memory, the unit test runner doesn't set those up.
+	bool initedThreads = SetupTestThreads(2);
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+
+	bool success = TestParallelMix();
+
+	Memory::Shutdown();
+	DestroyTestThreads(initedThreads);
+	return success;
+}
@@ -171,6 +171,69 @@ static bool TestPixelJit() {
 #endif
 }
 
+static bool TestQuadPixels() {
+	using namespace Rasterizer;
+	PixelJitCache *cache = new PixelJitCache();
+	BinManager binner;
+
+	GMRng rng;
+	int matches = 0;
+	int count = 3000;
+
+	u32 *fb_data = new u32[512 * 2];
+	u16 *zb_data = new u16[512 * 2];
+	fb.as32 = fb_data;
+	depthbuf.as16 = zb_data;
+
+	for (int i = 0; i < count; ) {
+		PixelFuncID id;
+		memset(&id, 0, sizeof(id));
+		id.fullKey = (uint64_t)rng.R32() | ((uint64_t)rng.R32() << 32);
+		id.cached.framebufStride = 512;
+		id.cached.depthbufStride = 512;
+		id.cached.minz = rng.R32() & 0x7FFF;
+		id.cached.maxz = id.cached.minz + (rng.R32() & 0x7FFF);
+
+		QuadFunc quadFunc = GetQuadFunc(id);
+		if (!quadFunc || startsWith(DescribePixelFuncID(id), "INVALID"))
+			continue;
+		i++;
+
+		for (int j = 0; j < 512 * 2; ++j) {
+			fb_data[j] = rng.R32();
+			zb_data[j] = (u16)rng.R32();
+		}
+
+		// Include out of range colors, the quad func must clamp the same way.
+		Math3D::Vec4<int> colors[4];
+		Math3D::Vec4<int> mask;
+		Math3D::Vec4<int> z;
+		for (int j = 0; j < 4; ++j) {
+			colors[j] = Math3D::Vec4<int>((int)(rng.R32() % 400) - 70, (int)(rng.R32() % 400) - 70, (int)(rng.R32() % 400) - 70, (int)(rng.R32() % 400) - 70);
+			mask[j] = (rng.R32() & 3) == 0 ? -1 : 0;
+			z[j] = rng.R32() & 0xFFFF;
+		}
+
+		int x = (rng.R32() % 255) * 2;
+		bool match = VerifyQuadPixels(quadFunc, cache->GenericSingle(id), x, 0, mask, z, colors, id);
+#if PPSSPP_ARCH(AMD64)
+		SingleFunc jitted = cache->GetSingle(id, &binner);
+		if (jitted)
+			match = VerifyQuadPixels(quadFunc, jitted, x, 0, mask, z, colors, id) && match;
+#endif
+		if (match)
+			matches++;
+	}
+
+	if (matches < count)
+		printf("QuadFunc matches: %d / %d\n", matches, count);
+
+	delete [] fb_data;
+	delete [] zb_data;
+	delete cache;
+	return matches == count && !HitAnyAsserts();
+}
+
 bool TestSoftwareGPUJit() {
 	g_Config.bSoftwareRenderingJit = true;
 	ResetHitAnyAsserts();
@@ -183,5 +246,9 @@ bool TestSoftwareGPUJit() {
 		return false;
 	}
 
+	if (!TestQuadPixels()) {
+		return false;
+	}
+
 	return true;
 }
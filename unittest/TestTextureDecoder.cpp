@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "Common/TimeUtil.h"
+#include "GPU/GPUState.h"
+#include "GPU/Common/TextureDecoder.h"
+
+#include "UnitTest.h"
+
+static const int TEX_SIZE = 512;
+
+static void FillRandom(std::vector<u8> &data, u32 seed) {
+	std::mt19937 rng(seed);
+	for (u8 &b : data)
+		b = (u8)rng();
+}
+
+template <typename ClutT>
+static bool CompareCLUT4(const ClutT *clut, const std::vector<u8> &indexed) {
+	std::vector<ClutT> expected(TEX_SIZE + 1);
+	std::vector<ClutT> actual(TEX_SIZE + 1);
+	// Try all the odd lengths, so every tail case is covered.
+	for (int length = 1; length <= 67; ++length) {
+		u32 expectedAlpha = 0xFFFFFFFF;
+		u32 actualAlpha = 0xFFFFFFFF;
+		DeIndexTexture4<ClutT>(expected.data(), indexed.data(), length, clut, &expectedAlpha);
+		DeIndexTexture4Simple(actual.data(), indexed.data(), length, clut, &actualAlpha);
+		EXPECT_EQ_INT(memcmp(expected.data(), actual.data(), length * sizeof(ClutT)), 0);
+		EXPECT_EQ_HEX(actualAlpha, expectedAlpha);
+	}
+	return true;
+}
+
+template <typename ClutT>
+static bool CompareSwizzledCLUT8(const ClutT *clut, const std::vector<u8> &swizzled, int bufw, int w, int h) {
+	std::vector<u32> unswizzled(bufw * ((h + 7) & ~7) / 4);
+	DoUnswizzleTex16(swizzled.data(), unswizzled.data(), bufw / 16, (h + 7) / 8, bufw);
+
+	const int pitch = w * sizeof(ClutT);
+	std::vector<ClutT> expected(w * h);
+	std::vector<ClutT> actual(w * h);
+	u32 expectedAlpha = 0xFFFFFFFF;
+	for (int y = 0; y < h; ++y)
+		DeIndexTexture(expected.data() + w * y, (const u8 *)unswizzled.data() + bufw * y, w, clut, &expectedAlpha);
+
+	u32 actualAlpha = 0xFFFFFFFF;
+	ParallelDecode((h + 7) / 8, w * 8, &actualAlpha, [&](int byStart, int byEnd, u32 *alphaSum) {
+		DeIndexSwizzledTexture8(actual.data(), pitch, swizzled.data(), bufw, w, h, byStart, byEnd, clut, alphaSum);
+	});
+	EXPECT_EQ_INT(memcmp(expected.data(), actual.data(), w * h * sizeof(ClutT)), 0);
+	EXPECT_EQ_HEX(actualAlpha, expectedAlpha);
+	return true;
+}
+
+static bool TestDeIndexCorrectness() {
+	std::vector<u8> indexed(TEX_SIZE * TEX_SIZE);
+	FillRandom(indexed, 1234);
+
+	u32 clut32[256];
+	u16 clut16[256];
+	for (int i = 0; i < 256; ++i) {
+		clut32[i] = 0xFF000000 | (i * 0x010203);
+		clut16[i] = 0xF000 | (u16)(i * 0x0123);
+	}
+
+	// The CLUT4 paths are only used for plain indexing.
+	gstate.clutformat = 0xC500FF00 | GE_CMODE_32BIT_ABGR8888;
+	if (!CompareCLUT4(clut32, indexed) || !CompareCLUT4(clut16, indexed))
+		return false;
+	// And with some pixels not fully opaque, to check the alpha sums.
+	clut32[7] = 0x7F000000;
+	clut16[7] = 0x7000;
+	if (!CompareCLUT4(clut32, indexed) || !CompareCLUT4(clut16, indexed))
+		return false;
+
+	if (!CompareSwizzledCLUT8(clut32, indexed, TEX_SIZE, TEX_SIZE, TEX_SIZE))
+		return false;
+	if (!CompareSwizzledCLUT8(clut16, indexed, TEX_SIZE, TEX_SIZE, TEX_SIZE))
+		return false;
+	// Narrower than the buffer, and heights that aren't a multiple of 8.
+	if (!CompareSwizzledCLUT8(clut32, indexed, 64, 40, 4))
+		return false;
+	if (!CompareSwizzledCLUT8(clut16, indexed, 128, 128, 100))
+		return false;
+	return true;
+}
+
+static bool TestParallelHash() {
+	std::vector<u8> data(TEX_SIZE * TEX_SIZE * 4);
+	FillRandom(data, 5678);
+
+	// Small sizes must match the plain hash, big ones must at least be stable and notice changes.
+	EXPECT_EQ_HEX(ParallelQuickTexHash(data.data(), 4096), StableQuickTexHash(data.data(), 4096));
+	u32 hash = ParallelQuickTexHash(data.data(), (u32)data.size());
+	EXPECT_EQ_HEX(ParallelQuickTexHash(data.data(), (u32)data.size()), hash);
+	data[data.size() / 2 + 3] ^= 1;
+	EXPECT_TRUE(ParallelQuickTexHash(data.data(), (u32)data.size()) != hash);
+	return true;
+}
+
+template <typename F>
+static double BenchMBPerSec(size_t bytes, F func) {
+	const int iterations = 20;
+	double start = time_now_d();
+	for (int i = 0; i < iterations; ++i)
+		func();
+	double elapsed = time_now_d() - start;
+	return elapsed > 0.0 ? (double)bytes * iterations / (elapsed * 1024.0 * 1024.0) : 0.0;
+}
+
+template <typename Block>
+static void DecodeDXTRows(u32 *out, const Block *blocks, int byStart, int byEnd, u32 *alphaSum) {
+	for (int by = byStart; by < byEnd; ++by) {
+		for (int bx = 0; bx < TEX_SIZE / 4; ++bx) {
+			u32 *dst = out + by * 4 * TEX_SIZE + bx * 4;
+			const Block *src = blocks + by * (TEX_SIZE / 4) + bx;
+			if constexpr (std::is_same<Block, DXT1Block>::value)
+				DecodeDXT1Block(dst, src, TEX_SIZE, 4, 4, alphaSum);
+			else if constexpr (std::is_same<Block, DXT3Block>::value)
+				DecodeDXT3Block(dst, src, TEX_SIZE, 4, 4);
+			else
+				DecodeDXT5Block(dst, src, TEX_SIZE, 4, 4);
+		}
+	}
+}
+
+template <typename Block>
+static void BenchDXT(const char *name, const std::vector<u8> &data, std::vector<u32> &out) {
+	const Block *blocks = (const Block *)data.data();
+	const size_t bytes = (TEX_SIZE / 4) * (TEX_SIZE / 4) * sizeof(Block);
+	double single = BenchMBPerSec(bytes, [&] {
+		u32 alphaSum = 1;
+		DecodeDXTRows(out.data(), blocks, 0, TEX_SIZE / 4, &alphaSum);
+	});
+	double parallel = BenchMBPerSec(bytes, [&] {
+		u32 alphaSum = 1;
+		ParallelDecode(TEX_SIZE / 4, TEX_SIZE * 4, &alphaSum, [&](int l, int h, u32 *rangeAlphaSum) {
+			DecodeDXTRows(out.data(), blocks, l, h, rangeAlphaSum);
+		});
+	});
+	printf("  %s: %0.1f MB/s single, %0.1f MB/s parallel\n", name, single, parallel);
+}
+
+static void BenchDecode() {
+	std::vector<u8> data(TEX_SIZE * TEX_SIZE * 4);
+	FillRandom(data, 9012);
+	std::vector<u32> out(TEX_SIZE * TEX_SIZE);
+	std::vector<u32> tmp(TEX_SIZE * TEX_SIZE);
+
+	u32 clut32[256];
+	for (int i = 0; i < 256; ++i)
+		clut32[i] = 0xFF000000 | (i * 0x010203);
+	gstate.clutformat = 0xC500FF00 | GE_CMODE_32BIT_ABGR8888;
+
+	printf("Texture decoding, %dx%d:\n", TEX_SIZE, TEX_SIZE);
+
+	const size_t clut4Bytes = TEX_SIZE * TEX_SIZE / 2;
+	double clut4Scalar = BenchMBPerSec(clut4Bytes, [&] {
+		u32 alphaSum = 0xFFFFFFFF;
+		for (int y = 0; y < TEX_SIZE; ++y)
+			DeIndexTexture4<u32>(out.data() + TEX_SIZE * y, data.data() + TEX_SIZE * y / 2, TEX_SIZE, clut32, &alphaSum);
+	});
+	double clut4Simple = BenchMBPerSec(clut4Bytes, [&] {
+		u32 alphaSum = 0xFFFFFFFF;
+		ParallelDecode(TEX_SIZE, TEX_SIZE, &alphaSum, [&](int l, int h, u32 *rangeAlphaSum) {
+			for (int y = l; y < h; ++y)
+				DeIndexTexture4Simple(out.data() + TEX_SIZE * y, data.data() + TEX_SIZE * y / 2, TEX_SIZE, clut32, rangeAlphaSum);
+		});
+	});
+	printf("  CLUT4: %0.1f MB/s before, %0.1f MB/s after\n", clut4Scalar, clut4Simple);
+
+	const size_t clut8Bytes = TEX_SIZE * TEX_SIZE;
+	double clut8TwoPass = BenchMBPerSec(clut8Bytes, [&] {
+		u32 alphaSum = 0xFFFFFFFF;
+		DoUnswizzleTex16(data.data(), tmp.data(), TEX_SIZE / 16, TEX_SIZE / 8, TEX_SIZE);
+		for (int y = 0; y < TEX_SIZE; ++y)
+			DeIndexTexture(out.data() + TEX_SIZE * y, (const u8 *)tmp.data() + TEX_SIZE * y, TEX_SIZE, clut32, &alphaSum);
+	});
+	double clut8Fused = BenchMBPerSec(clut8Bytes, [&] {
+		u32 alphaSum = 0xFFFFFFFF;
+		ParallelDecode(TEX_SIZE / 8, TEX_SIZE * 8, &alphaSum, [&](int l, int h, u32 *rangeAlphaSum) {
+			DeIndexSwizzledTexture8(out.data(), TEX_SIZE * 4, data.data(), TEX_SIZE, TEX_SIZE, TEX_SIZE, l, h, clut32, rangeAlphaSum);
+		});
+	});
+	printf("  CLUT8 swizzled: %0.1f MB/s before, %0.1f MB/s after\n", clut8TwoPass, clut8Fused);
+
+	BenchDXT<DXT1Block>("DXT1", data, out);
+	BenchDXT<DXT3Block>("DXT3", data, out);
+	BenchDXT<DXT5Block>("DXT5", data, out);
+
+	const u32 hashBytes = (u32)data.size();
+	double hashStable = BenchMBPerSec(hashBytes, [&] { StableQuickTexHash(data.data(), hashBytes); });
+	double hashParallel = BenchMBPerSec(hashBytes, [&] { ParallelQuickTexHash(data.data(), hashBytes); });
+	printf("  Hash: %0.1f MB/s before, %0.1f MB/s after\n", hashStable, hashParallel);
+}
+
+bool TestTextureDecoder() {
+	// The parallel paths need worker threads.
+	bool initedThreads = SetupTestThreads(1);
+
+	u32 savedClutFormat = gstate.clutformat;
+	bool success = TestDeIndexCorrectness() && TestParallelHash();
+	gstate.clutformat = savedClutFormat;
+
+	DestroyTestThreads(initedThreads);
+	return success;
+}
+
+bool BenchTextureDecoder() {
+	bool initedThreads = SetupTestThreads(1);
+
+	u32 savedClutFormat = gstate.clutformat;
+	BenchDecode();
+	gstate.clutformat = savedClutFormat;
+
+	DestroyTestThreads(initedThreads);
+	return true;
+}
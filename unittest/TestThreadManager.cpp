@@ -1,6 +1,9 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <thread>
 #include <vector>
-#include <cstdio>
 
 #include "Common/Log.h"
 #include "Common/TimeUtil.h"
@@ -124,6 +127,38 @@ bool TestMultithreadedScheduling() {
 	return true;
 }
 
+// Checks that every item is covered exactly once, whatever the thread count.
+static bool TestParallelLoopCoverage() {
+	const size_t copyBytes = 1024 * 1024 + 77;
+	std::vector<uint8_t> src(copyBytes);
+	for (size_t i = 0; i < copyBytes; ++i)
+		src[i] = (uint8_t)(i * 7);
+	std::vector<uint8_t> dst(copyBytes);
+
+	for (int threads : { 1, 2, 4, 8 }) {
+		ThreadManager manager;
+		manager.Init(threads, 1);
+
+		const int size = 1000;
+		std::vector<std::atomic<int>> hits(size);
+		for (int i = 0; i < 10; ++i) {
+			ParallelRangeLoop(&manager, [&](int l, int h) {
+				for (int j = l; j < h; ++j)
+					hits[j]++;
+			}, 0, size, 1 + i * 7);
+		}
+		for (int j = 0; j < size; ++j)
+			EXPECT_EQ_INT(hits[j].load(), 10);
+
+		memset(dst.data(), 0, copyBytes);
+		ParallelMemcpy(&manager, dst.data(), src.data(), copyBytes);
+		EXPECT_TRUE(memcmp(src.data(), dst.data(), copyBytes) == 0);
+
+		manager.Teardown();
+	}
+	return true;
+}
+
 bool TestThreadManager() {
 	ThreadManager manager;
 	manager.Init(8, 1);
@@ -152,5 +187,56 @@ bool TestThreadManager() {
 		return false;
 	}
 
+	if (!TestParallelLoopCoverage()) {
+		return false;
+	}
+
+	manager.Teardown();
+	return true;
+}
+
+// Logs how the timings scale with threads.
+bool BenchThreadManager() {
+	const int computeSize = 1024 * 1024;
+	const size_t copyBytes = 16 * 1024 * 1024;
+	std::vector<float> data(computeSize, 1.0f);
+	std::vector<uint8_t> src(copyBytes, 0x55);
+	std::vector<uint8_t> dst(copyBytes);
+
+	printf("Parallel loop scaling:\n");
+	for (int threads : { 1, 2, 4, 8, 16 }) {
+		ThreadManager manager;
+		manager.Init(threads, 1);
+
+		// Almost no work per task, so this is mostly scheduling overhead.
+		const int tinyLoops = 20000;
+		std::atomic<int> covered{};
+		auto start = Instant::Now();
+		for (int i = 0; i < tinyLoops; ++i) {
+			ParallelRangeLoop(&manager, [&](int l, int h) {
+				covered += h - l;
+			}, 0, threads * 4, 1);
+		}
+		double tinyUs = start.ElapsedSeconds() * 1000000.0 / tinyLoops;
+
+		const int computeLoops = 20;
+		start = Instant::Now();
+		for (int i = 0; i < computeLoops; ++i) {
+			ParallelRangeLoop(&manager, [&](int l, int h) {
+				for (int j = l; j < h; ++j)
+					data[j] = sqrtf(data[j] * 1.0001f + 1.0f);
+			}, 0, computeSize, 1024);
+		}
+		double computeMs = start.ElapsedSeconds() * 1000.0 / computeLoops;
+
+		const int copyLoops = 10;
+		start = Instant::Now();
+		for (int i = 0; i < copyLoops; ++i)
+			ParallelMemcpy(&manager, dst.data(), src.data(), copyBytes);
+		double copyMBs = (double)copyBytes * copyLoops / (start.ElapsedSeconds() * 1024.0 * 1024.0);
+
+		printf(" - %2d threads: %0.2f us per tiny loop, %0.3f ms per compute loop, %0.1f MB/s memcpy\n", threads, tinyUs, computeMs, copyMBs);
+		manager.Teardown();
+	}
 	return true;
 }
@@ -21,6 +21,8 @@
 #include "Common/TimeUtil.h"
 #include "Core/Config.h"
 #include "Core/ConfigValues.h"
+#include "Core/MemMap.h"
+#include "GPU/Common/DrawEngineCommon.h"
 #include "GPU/Common/VertexDecoderCommon.h"
 #include "GPU/ge_constants.h"
 #include "GPU/GPUState.h"
@@ -691,3 +693,67 @@ bool TestVertexJit() {
 
 	return pass;
 }
+
+// Just enough of a draw engine to get at the decoded vertex cache.
+class VertexCacheTestEngine : public DrawEngineCommon {
+public:
+	void DeviceLost() override {}
+	void DeviceRestore(Draw::DrawContext *draw) override {}
+	void Flush() override {}
+
+	bool Decode(const VertexDecoder *dec, const void *verts, int count, u8 *dest) {
+		DeferredVerts dv{};
+		dv.verts = verts;
+		dv.uvScale = UVScale{ 1.0f, 1.0f, 0.0f, 0.0f };
+		dv.vertexCount = count;
+		dv.indexLowerBound = 0;
+		dv.indexUpperBound = count - 1;
+		return DecodeVertsCached(dec, dv, dest);
+	}
+};
+
+static bool TestVertexCacheAfterInvalidate(VertexCacheTestEngine &engine) {
+	const u32 vtype = GE_VTYPE_POS_FLOAT;
+	const int count = 64;
+	VertexDecoder dec;
+	dec.SetVertexType(vtype, VertexDecoderOptions{});
+	const u32 srcSize = count * dec.VertexSize();
+	const u32 addr = 0x08800000;
+	float *verts = (float *)Memory::GetPointerWrite(addr);
+	for (int i = 0; i < count * 3; ++i)
+		verts[i] = (float)i;
+
+	std::vector<u8> decoded(count * dec.GetDecVtxFmt().stride);
+	// Remembered the first time, decoded into the cache the second.
+	EXPECT_FALSE(engine.Decode(&dec, verts, count, decoded.data()));
+	EXPECT_TRUE(engine.Decode(&dec, verts, count, decoded.data()));
+
+	// Forces a full hash, which still matches.
+	engine.InvalidateDecodedVerts(addr, srcSize, GPU_INVALIDATE_HINT);
+	EXPECT_TRUE(engine.Decode(&dec, verts, count, decoded.data()));
+
+	// Now a change in the middle (outside the minihash) shouldn't be noticed until the next full hash.
+	// If it is noticed right away, the entry got stuck doing a full hash on every use.
+	verts[count * 3 / 2] = -1.0f;
+	EXPECT_TRUE(engine.Decode(&dec, verts, count, decoded.data()));
+
+	// But invalidating again catches it.
+	engine.InvalidateDecodedVerts(addr, srcSize, GPU_INVALIDATE_HINT);
+	EXPECT_FALSE(engine.Decode(&dec, verts, count, decoded.data()));
+	return true;
+}
+
+bool TestVertexCache() {
+	// The cache only tracks vertices in PSP memory.
+	Memory::g_MemorySize = Memory::RAM_NORMAL_SIZE;
+	Memory::Init();
+
+	bool success;
+	{
+		VertexCacheTestEngine engine;
+		success = TestVertexCacheAfterInvalidate(engine);
+	}
+
+	Memory::Shutdown();
+	return success;
+}
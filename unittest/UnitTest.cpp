@@ -25,7 +25,7 @@
 // Or just integrate with an existing testing framework.
 //
 // To use, set command line parameter to one or more of the tests below, or "all".
-// Search for "availableTests".
+// Search for "availableTests". Timing-only benchmarks are in "availableBenchmarks", run them by name.
 //
 // Example of how to run with CMake:
 //
@@ -41,6 +41,7 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <thread>
 
 #if PPSSPP_PLATFORM(ANDROID)
 #include <jni.h>
@@ -68,6 +69,7 @@
 #include "Common/Render/DrawBuffer.h"
 #include "Common/System/NativeApp.h"
 #include "Common/System/System.h"
+#include "Common/Thread/ThreadManager.h"
 #include "Common/Thread/ThreadUtil.h"
 #include "Common/Data/Format/IniFile.h"
 #include "Common/TimeUtil.h"
@@ -83,6 +85,7 @@
 #include "Common/File/VFS/DirectoryReader.h"
 #include "Core/FileSystems/ISOFileSystem.h"
 #include "Core/MemMap.h"
+#include "Core/Debugger/Breakpoints.h"
 #include "Core/KeyMap.h"
 #include "Core/MIPS/MIPSVFPUUtils.h"
 #include "GPU/Common/TextureDecoder.h"
@@ -704,6 +707,56 @@ static bool TestMemMap() {
 	return true;
 }
 
+static bool TestMemChecks() {
+	g_breakpoints.ClearAllMemChecks();
+	g_breakpoints.AddMemCheck(0x08800000, 0x08800010, MEMCHECK_WRITE, BREAK_ACTION_LOG);
+	g_breakpoints.AddMemCheck(0x08800008, 0x08800100, MEMCHECK_READWRITE, BREAK_ACTION_LOG);
+	g_breakpoints.AddMemCheck(0x09000000, 0, MEMCHECK_READ, BREAK_ACTION_LOG);
+	g_breakpoints.AddMemCheck(0x04000100, 0x04000200, MEMCHECK_READ, BREAK_ACTION_LOG);
+
+	auto lookup = [](u32 address, int size) -> u32 {
+		MemCheck check;
+		if (!g_breakpoints.GetMemCheckInRange(address, size, &check))
+			return 0;
+		return check.start;
+	};
+
+	// Overlapping memchecks go to the first added.
+	EXPECT_EQ_HEX(lookup(0x08800004, 4), 0x08800000);
+	EXPECT_EQ_HEX(lookup(0x0880000C, 4), 0x08800000);
+	EXPECT_EQ_HEX(lookup(0x087FFFFE, 4), 0x08800000);
+	EXPECT_EQ_HEX(lookup(0x087FFFFC, 4), 0);
+	EXPECT_EQ_HEX(lookup(0x08800020, 4), 0x08800008);
+	EXPECT_EQ_HEX(lookup(0x48800020, 4), 0x08800008);
+	EXPECT_EQ_HEX(lookup(0x08800100, 4), 0);
+	EXPECT_EQ_HEX(lookup(0x09000000, 1), 0x09000000);
+	EXPECT_EQ_HEX(lookup(0x08FFFFFC, 4), 0);
+	EXPECT_EQ_HEX(lookup(0x44200180, 4), 0x04000100);
+
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x08800000, true));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x48800000, true));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x087FFFF8, true));
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x08900000, true));
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x09000000, true));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x09000000, false));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x04600100, false));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x44200100, false));
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x04600100, true));
+
+	g_breakpoints.RemoveMemCheck(0x08800000, 0x08800010);
+	EXPECT_EQ_HEX(lookup(0x0880000C, 4), 0x08800008);
+	EXPECT_EQ_HEX(lookup(0x08800004, 4), 0);
+	g_breakpoints.ChangeMemCheck(0x08800008, 0x08800100, MEMCHECK_READ, BREAK_ACTION_LOG);
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x08800000, true));
+	EXPECT_TRUE(g_breakpoints.IsMemCheckPage(0x08800000, false));
+
+	g_breakpoints.ClearAllMemChecks();
+	EXPECT_EQ_HEX(lookup(0x08800020, 4), 0);
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x08800000, false));
+	EXPECT_FALSE(g_breakpoints.IsMemCheckPage(0x04000100, false));
+	return true;
+}
+
 static bool TestPath() {
 	// Also test the Path class while we're at it.
 	Path path("/asdf/jkl/");
@@ -1232,6 +1285,18 @@ bool TestVolumeFunc() {
 	return true;
 }
 
+bool SetupTestThreads(int minThreads) {
+	if (g_threadManager.IsInitialized())
+		return false;
+	g_threadManager.Init(std::max((unsigned)minThreads, std::thread::hardware_concurrency()), 1);
+	return true;
+}
+
+void DestroyTestThreads(bool initedThreads) {
+	if (initedThreads)
+		g_threadManager.Teardown();
+}
+
 typedef bool (*TestFunc)();
 struct TestItem {
 	const char *name;
@@ -1239,6 +1304,8 @@ struct TestItem {
 };
 
 #define TEST_ITEM(name) { #name, &Test ##name, }
+// Benchmarks only log timings, so they're not part of "all".
+#define BENCH_ITEM(name) { "Bench" #name, &Bench ##name, }
 
 bool TestArmEmitter();
 bool TestArm64Emitter();
@@ -1249,8 +1316,21 @@ bool TestShaderGenerators();
 bool TestSoftwareGPUJit();
 bool TestIRPassSimplify();
 bool TestThreadManager();
+bool TestCoreTiming();
+bool TestBlockAllocator();
+bool TestISOFileSystem();
+bool TestSasAudio();
+bool TestTextureDecoder();
+bool TestReplacementArchive();
 bool TestVFS();
 
+bool BenchCoreTiming();
+bool BenchTextureDecoder();
+bool BenchSasAudio();
+bool BenchISOFileSystem();
+bool BenchBlockAllocator();
+bool BenchThreadManager();
+
 TestItem availableTests[] = {
 #if PPSSPP_ARCH(ARM64) || PPSSPP_ARCH(AMD64) || PPSSPP_ARCH(X86)
 	TEST_ITEM(Arm64Emitter),
@@ -1268,6 +1348,7 @@ TestItem availableTests[] = {
 	TEST_ITEM(LoongArch64Emitter),
 #endif
 	TEST_ITEM(VertexJit),
+	TEST_ITEM(VertexCache),
 	TEST_ITEM(Asin),
 	TEST_ITEM(SinCos),
 	TEST_ITEM(VFPUSinCos),
@@ -1275,16 +1356,25 @@ TestItem availableTests[] = {
 	TEST_ITEM(Parsers),
 	TEST_ITEM(IRPassSimplify),
 	TEST_ITEM(Jit),
+	TEST_ITEM(IRProfiler),
+	TEST_ITEM(IRAsyncReplacement),
 	TEST_ITEM(VFPUMatrixTranspose),
 	TEST_ITEM(ParseLBN),
 	TEST_ITEM(QuickTexHash),
 	TEST_ITEM(CLZ),
 	TEST_ITEM(MemMap),
+	TEST_ITEM(MemChecks),
 	TEST_ITEM(ShaderGenerators),
 	TEST_ITEM(SoftwareGPUJit),
 	TEST_ITEM(Path),
 	TEST_ITEM(AndroidContentURI),
 	TEST_ITEM(ThreadManager),
+	TEST_ITEM(CoreTiming),
+	TEST_ITEM(BlockAllocator),
+	TEST_ITEM(ISOFileSystem),
+	TEST_ITEM(SasAudio),
+	TEST_ITEM(TextureDecoder),
+	TEST_ITEM(ReplacementArchive),
 	TEST_ITEM(WrapText),
 	TEST_ITEM(TinySet),
 	TEST_ITEM(FastVec),
@@ -1303,6 +1393,15 @@ TestItem availableTests[] = {
 	TEST_ITEM(VolumeFunc),
 };
 
+TestItem availableBenchmarks[] = {
+	BENCH_ITEM(CoreTiming),
+	BENCH_ITEM(TextureDecoder),
+	BENCH_ITEM(SasAudio),
+	BENCH_ITEM(ISOFileSystem),
+	BENCH_ITEM(BlockAllocator),
+	BENCH_ITEM(ThreadManager),
+};
+
 int main(int argc, const char *argv[]) {
 	SetCurrentThreadName("UnitTest");
 	TimeInit();
@@ -1330,6 +1429,12 @@ int main(int argc, const char *argv[]) {
 				break;
 			}
 		}
+		for (auto f : availableBenchmarks) {
+			if (!strcasecmp(argv[1], f.name)) {
+				testFunc = f.func;
+				break;
+			}
+		}
 	}
 
 	if (allTests) {
@@ -1358,6 +1463,11 @@ int main(int argc, const char *argv[]) {
 		for (auto f : availableTests) {
 			fprintf(stderr, "  * %s\n", f.name);
 		}
+		fprintf(stderr, "\n");
+		fprintf(stderr, "Available benchmarks (not included in \"all\"):\n");
+		for (auto f : availableBenchmarks) {
+			fprintf(stderr, "  * %s\n", f.name);
+		}
 		return 1;
 	} else {
 		if (!testFunc()) {
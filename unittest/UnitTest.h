@@ -26,3 +26,8 @@ inline bool rel_equal(float a, float b, float precision) {
 #define EXPECT_EQ_MEM(a, b, sz) if (memcmp(a, b, sz) != 0) { printf("%s: Test Fail\n%.*s\nvs\n%.*s\n", __FUNCTION__, (int)sz, a, (int)sz, b); return false; }
 
 #define RET(a) if (!(a)) { return false; }
+
+// The unit test runner doesn't start any worker threads by default, this does if needed.
+// Returns whether it did, pass that on to DestroyTestThreads when done.
+bool SetupTestThreads(int minThreads);
+void DestroyTestThreads(bool initedThreads);